@@ -0,0 +1,47 @@
+/**
+ * @file atlas.c
+ * @brief Host loader for patterns.bmp
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "atlas.h"
+
+static uint32_t read_le(const uint8_t *p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+uint16_t *load_atlas(const char *path, int *w, int *h) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *bmp = malloc(size);
+    if (!bmp || fread(bmp, 1, size, f) != (size_t) size || bmp[0] != 'B' || read_le(bmp + 28, 2) != 8) {
+        free(bmp);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+
+    const uint8_t *palette = bmp + 14 + read_le(bmp + 14, 4);
+    const uint8_t *data = bmp + read_le(bmp + 10, 4);
+    int bmp_h = (int32_t) read_le(bmp + 22, 4);
+    *w = (int32_t) read_le(bmp + 18, 4);
+    *h = bmp_h < 0 ? -bmp_h : bmp_h;
+    int stride = (*w + 3) & ~3;
+    uint16_t *atlas = malloc(*w * *h * sizeof(uint16_t));
+    for (int y = 0; atlas && y < *h; y++) {
+        const uint8_t *row = data + (bmp_h > 0 ? *h - 1 - y : y) * stride;
+        for (int x = 0; x < *w; x++) {
+            const uint8_t *bgra = palette + row[x] * 4;
+            atlas[y * *w + x] = ((bgra[2] & 0xF8) << 8) | ((bgra[1] & 0xFC) << 3) | (bgra[0] >> 3);
+        }
+    }
+    free(bmp);
+    return atlas;
+}
@@ -0,0 +1,14 @@
+/**
+ * @file atlas.h
+ * @brief Host loader for patterns.bmp, decoded independently of the tile cache's file reader
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief The atlas as the device holds it after SDL_LoadBMP and the RGB565 conversion
+ * @return malloc()ed pixels with a pitch of *w, or NULL if the file is not an 8-bit BMP
+ */
+uint16_t *load_atlas(const char *path, int *w, int *h);
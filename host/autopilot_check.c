@@ -0,0 +1,175 @@
+/**
+ * @file autopilot_check.c
+ * @brief Autopilot moves: legal steps only, enemies avoided, push rules kept, levels cleared
+ */
+
+#include <string.h>
+
+#include "autopilot.h"
+#include "check.h"
+#include "esp_log.h"
+#include "levelgen.h"
+
+#define W LEVELGEN_WIDTH
+#define H LEVELGEN_HEIGHT
+#define LEVELS 200
+#define MAX_STEPS 2000
+
+static const char *TAG = "autopilot_check";
+
+static const int dx[5] = {0, 0, 0, -1, 1};
+static const int dy[5] = {0, -1, 1, 0, 0};
+
+static char map[W * H];
+
+static autopilot_view_t view_of(int px, int py) {
+    return (autopilot_view_t){.map = map, .width = W, .height = H, .player_x = px, .player_y = py};
+}
+
+static int count_fruit(void) {
+    int n = 0;
+    for (int c = 0; c < W * H; c++) n += map[c] == 4;
+    return n;
+}
+
+static bool is_enemy_at(const autopilot_view_t *v, int x, int y) {
+    for (int e = 0; e < v->enemies; e++) {
+        if (v->enemy_x[e] == x && v->enemy_y[e] == y) return true;
+    }
+    return false;
+}
+
+// Follow the autopilot on a generated level: 1 when cleared, 0 when it stopped, -1 on an illegal move
+static int walk(const levelgen_level_t *lvl, bool with_enemies, int *steps_out) {
+    memcpy(map, lvl->tiles, sizeof(map));
+    autopilot_view_t v = view_of(lvl->player_x, lvl->player_y);
+    for (int c = 0; c < W * H; c++) {
+        if (map[c] < 13 || map[c] > 15) continue;
+        map[c] = 1;
+        if (with_enemies && v.enemies < AUTOPILOT_MAX_ENEMIES) {
+            v.enemy_x[v.enemies] = c % W;
+            v.enemy_y[v.enemies++] = c / W;
+        }
+    }
+
+    int steps = 0;
+    while (count_fruit() > 0 && steps < MAX_STEPS) {
+        int dir = autopilot_plan(&v);
+        if (dir < AUTOPILOT_STAY || dir > AUTOPILOT_RIGHT) return -1;
+        if (dir == AUTOPILOT_STAY) break;
+        int nx = v.player_x + dx[dir], ny = v.player_y + dy[dir];
+        if (nx < 0 || ny < 0 || nx >= W || ny >= H || is_enemy_at(&v, nx, ny)) return -1;
+        char *tile = &map[ny * W + nx];
+        if (*tile == 2 || *tile == 12) return -1;
+        if (*tile == 3 || *tile == 11) {
+            // The push must be one the game allows: into an empty cell, never a rock downwards
+            int bx = nx + dx[dir], by = ny + dy[dir];
+            if (bx < 0 || by < 0 || bx >= W || by >= H || map[by * W + bx] != 0) return -1;
+            if (*tile == 3 && dir == AUTOPILOT_DOWN) return -1;
+            map[by * W + bx] = *tile;
+        }
+        bool teleporter = *tile == 6;
+        *tile = 0;
+        v.player_x = nx;
+        v.player_y = ny;
+        for (int c = 0; teleporter && c < W * H; c++) {
+            // Like the game: both teleporters are used up and the player lands on the other one
+            if (map[c] != 6) continue;
+            map[c] = 0;
+            v.player_x = c % W;
+            v.player_y = c / W;
+            break;
+        }
+        steps++;
+    }
+    *steps_out = steps;
+    return count_fruit() == 0 ? 1 : 0;
+}
+
+int main(void) {
+    autopilot_view_t v;
+
+    // Straight to the fruit, around a wall
+    memset(map, 0, sizeof(map));
+    map[5 * W + 9] = 4;
+    v = view_of(5, 5);
+    CHECK(autopilot_plan(&v) == AUTOPILOT_RIGHT);
+    v = view_of(9, 8);
+    CHECK(autopilot_plan(&v) == AUTOPILOT_UP);
+    for (int y = 0; y < H - 1; y++) map[y * W + 7] = 2;
+    v = view_of(6, 5);
+    CHECK(autopilot_plan(&v) == AUTOPILOT_DOWN);
+
+    // Never onto an enemy, and away from one when there is nothing to eat
+    memset(map, 0, sizeof(map));
+    map[5 * W + 7] = 4;
+    v = view_of(5, 5);
+    v.enemy_x[0] = 6;
+    v.enemy_y[0] = 5;
+    v.enemies = 1;
+    int dir = autopilot_plan(&v);
+    CHECK(dir == AUTOPILOT_UP || dir == AUTOPILOT_DOWN);
+    map[5 * W + 7] = 0;
+    dir = autopilot_plan(&v);
+    CHECK(dir != AUTOPILOT_RIGHT && dir != AUTOPILOT_STAY);
+    v.enemy_x[0] = 12;
+    CHECK(autopilot_plan(&v) == AUTOPILOT_STAY);
+
+    // Push rules: a rock is never pushed down, nor sideways to where it would fall
+    memset(map, 2, sizeof(map));
+    map[2 * W + 5] = 0;
+    map[3 * W + 5] = 3;
+    map[4 * W + 5] = 0;
+    map[5 * W + 5] = 4;
+    v = view_of(5, 2);
+    CHECK(autopilot_plan(&v) == AUTOPILOT_STAY);
+    map[3 * W + 5] = 11;
+    CHECK(autopilot_plan(&v) == AUTOPILOT_DOWN);
+    memset(map, 2, sizeof(map));
+    map[5 * W + 3] = 0;
+    map[5 * W + 4] = 3;
+    map[5 * W + 5] = 0;
+    map[5 * W + 6] = 4;
+    map[6 * W + 5] = 0;
+    v = view_of(3, 5);
+    CHECK(autopilot_plan(&v) == AUTOPILOT_STAY);
+    map[6 * W + 5] = 2;
+    CHECK(autopilot_plan(&v) == AUTOPILOT_RIGHT);
+
+    // Fruit only reachable through the teleporter pair, behind the player; fruit on foot goes first
+    memset(map, 2, sizeof(map));
+    map[2 * W + 2] = 6;
+    map[2 * W + 3] = 0;
+    map[5 * W + 10] = 6;
+    map[5 * W + 11] = 4;
+    v = view_of(3, 2);
+    CHECK(autopilot_plan(&v) == AUTOPILOT_LEFT);
+    map[2 * W + 4] = 4;
+    CHECK(autopilot_plan(&v) == AUTOPILOT_RIGHT);
+
+    // Generated levels: every move legal; without enemies every level is cleared
+    int illegal = 0, cleared = 0, cleared_alone = 0, steps_total = 0;
+    for (int i = 0; i < LEVELS; i++) {
+        levelgen_level_t lvl;
+        levelgen_generate(0x5eed + i * 7919u, i % 16, &lvl);
+        int steps = 0, chased_steps = 0;
+        int alone = walk(&lvl, false, &steps);
+        int chased = walk(&lvl, true, &chased_steps);
+        illegal += (alone < 0) + (chased < 0);
+        cleared_alone += alone > 0;
+        cleared += chased > 0;
+        if (alone > 0) steps_total += steps;
+    }
+    CHECK(illegal == 0);
+    CHECK(cleared_alone == LEVELS);
+
+    autopilot_stats_t stats;
+    autopilot_get_stats(&stats);
+    CHECK(stats.plans > 0);
+    CHECK(stats.max_us >= stats.total_us / stats.plans);
+    ESP_LOGI(TAG, "📊 BENCH autopilot %lu plans: avg %llu us, max %lu us, %lu over budget, %d/%d levels cleared "
+             "alone (%d steps), %d/%d with enemies", (unsigned long) stats.plans,
+             (unsigned long long) (stats.total_us / stats.plans), (unsigned long) stats.max_us,
+             (unsigned long) stats.budget_hits, cleared_alone, LEVELS, steps_total, cleared, LEVELS);
+    return check_result("autopilot_check");
+}
@@ -0,0 +1,24 @@
+/**
+ * @file check.h
+ * @brief Host checks: count failed conditions and report them with their location
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+static int check_failures;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);           \
+            check_failures++;                                                \
+        }                                                                    \
+    } while (0)
+
+// Exit status for main(): 0 when every check held
+static inline int check_result(const char *name) {
+    printf("%s: %s\n", name, check_failures ? "FAILED" : "ok");
+    return check_failures ? 1 : 0;
+}
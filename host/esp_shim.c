@@ -0,0 +1,101 @@
+/**
+ * @file esp_shim.c
+ * @brief Host build: the ESP-IDF, FreeRTOS and SDL calls the engine modules make
+ */
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "SDL3/SDL.h"
+
+const char *esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        default: return "ESP_ERR";
+    }
+}
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    (void) caps;
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    (void) caps;
+    return calloc(n, size);
+}
+
+void heap_caps_free(void *ptr) {
+    free(ptr);
+}
+
+// No scheduler: nothing runs in the background on the host
+BaseType_t xPortGetCoreID(void) {
+    return 0;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+    (void) fn, (void) name, (void) stack, (void) arg, (void) priority, (void) handle, (void) core;
+    return pdFALSE;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    (void) task;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    (void) ticks;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    (void) length, (void) item_size;
+    return NULL;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+    (void) queue, (void) item, (void) wait;
+    return pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) {
+    (void) queue, (void) item, (void) wait;
+    return pdFALSE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    (void) queue;
+    return pdTRUE;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    (void) queue;
+}
+
+// Particles are drawn through SDL on the device; the harness only draws into RGB565 buffers
+bool SDL_SetRenderDrawColor(SDL_Renderer *renderer, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    (void) renderer, (void) r, (void) g, (void) b, (void) a;
+    return true;
+}
+
+bool SDL_RenderFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, int count) {
+    (void) renderer, (void) rects, (void) count;
+    return true;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file fov_check.c
+ * @brief Fog-of-war visibility: sight radius, walls, two viewers and the flips reported for redraw
+ */
+
+#include <string.h>
+
+#include "check.h"
+#include "fov.h"
+
+#define W 24
+#define H 16
+
+static char map[W * H];
+static uint8_t before[W * H];
+static int flipped[W * H];
+static int flip_calls, flip_wrong;
+
+static void snapshot(uint8_t *out) {
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) out[y * W + x] = fov_is_visible(x, y);
+    }
+}
+
+static void on_flip(int x, int y, bool visible) {
+    flip_calls++;
+    flipped[y * W + x]++;
+    if (visible != fov_is_visible(x, y) || visible == before[y * W + x]) flip_wrong++;
+}
+
+// Move the viewers and check that exactly the cells that changed were reported, once each
+static void check_flips(const int *vx, const int *vy, int viewers) {
+    snapshot(before);
+    memset(flipped, 0, sizeof(flipped));
+    flip_calls = flip_wrong = 0;
+    int flips = fov_update(vx, vy, viewers, on_flip);
+    CHECK(flips == flip_calls);
+    CHECK(flip_wrong == 0);
+    int missed = 0, changed = 0;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            bool differs = fov_is_visible(x, y) != before[y * W + x];
+            changed += differs;
+            missed += flipped[y * W + x] != (differs ? 1 : 0);
+        }
+    }
+    CHECK(missed == 0);
+    CHECK(flips == changed);
+}
+
+int main(void) {
+    // Open field: exactly the cells within the sight radius are visible
+    memset(map, 0, sizeof(map));
+    CHECK(fov_set_map(map, W, H) == ESP_OK);
+    CHECK(fov_is_enabled());
+    CHECK(!fov_is_visible(10, 8));
+    int vx[2] = {10, 18}, vy[2] = {8, 4};
+    check_flips(vx, vy, 1);
+    int wrong = 0;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int dx = x - vx[0], dy = y - vy[0];
+            wrong += fov_is_visible(x, y) != (dx * dx + dy * dy <= FOV_RADIUS * FOV_RADIUS);
+        }
+    }
+    CHECK(wrong == 0);
+    CHECK(fov_is_visible(10, 8));
+    CHECK(!fov_is_visible(10 + FOV_RADIUS + 1, 8));
+
+    // A second viewer adds its own circle
+    check_flips(vx, vy, 2);
+    CHECK(fov_is_visible(18, 4) && fov_is_visible(10, 8));
+    CHECK(fov_is_visible(18 + FOV_RADIUS - 1, 4));
+    CHECK(!fov_is_visible(10 - FOV_RADIUS, 8 + FOV_RADIUS));
+
+    // Walls and rocks are seen but hide what is behind them
+    map[8 * W + 12] = 2;
+    map[5 * W + 10] = 3;
+    check_flips(vx, vy, 1);
+    CHECK(fov_is_visible(12, 8));
+    CHECK(!fov_is_visible(13, 8) && !fov_is_visible(15, 8));
+    CHECK(fov_is_visible(10, 5));
+    CHECK(!fov_is_visible(10, 4) && !fov_is_visible(10, 3));
+    CHECK(fov_is_visible(11, 8) && fov_is_visible(10, 6));
+
+    // Moving around, into a corner and back, reports only what flipped
+    int path[][2] = {{11, 8}, {13, 9}, {0, 0}, {23, 15}, {5, 12}, {10, 8}};
+    for (size_t i = 0; i < sizeof(path) / sizeof(path[0]); i++) {
+        vx[0] = path[i][0];
+        vy[0] = path[i][1];
+        check_flips(vx, vy, 1);
+        CHECK(fov_is_visible(vx[0], vy[0]));
+    }
+    flip_calls = 0;
+    CHECK(fov_update(vx, vy, 1, on_flip) == 0);
+    CHECK(flip_calls == 0);
+
+    // A new map starts in the dark
+    CHECK(fov_set_map(map, W, H) == ESP_OK);
+    CHECK(!fov_is_visible(10, 8));
+
+    fov_benchmark();
+    return check_result("fov_check");
+}
@@ -0,0 +1,89 @@
+/**
+ * @file ghost_check.c
+ * @brief Record a run through the ghost API, replay the stored file and check every tick
+ *
+ * Runs are stored in the working directory (GHOST_DIR "." for this target). The host has no
+ * scheduler, so runs are saved inline instead of by the background writer.
+ */
+
+#include <stdio.h>
+
+#include "check.h"
+#include "ghost.h"
+
+#define TICKS 3000
+#define LEVEL 1
+
+static int expect_x[TICKS], expect_y[TICKS];
+
+// Walking, sliding, pauses and the odd teleport that needs the escape encoding
+static void make_run(void) {
+    unsigned seed = 4242;
+    int x = 8, y = 8;
+    for (int t = 0; t < TICKS; t++) {
+        seed = seed * 1103515245 + 12345;
+        int r = (seed >> 16) & 0xff;
+        if (r < 3) {
+            x = 8 + (r * 397 + t) % 224;
+            y = 8 + (r * 211 + t) % 176;
+        } else if (r < 200) {
+            int step = 1 + (r & 3);
+            switch ((r >> 2) & 3) {
+                case 0: x += step; break;
+                case 1: x -= step; break;
+                case 2: y += step; break;
+                default: y -= step; break;
+            }
+        }
+        expect_x[t] = x;
+        expect_y[t] = y;
+    }
+}
+
+int main(void) {
+    make_run();
+    remove("./ghost_01.bin");
+    CHECK(ghost_best_ticks(LEVEL) == 0);
+
+    // An abandoned run is not stored
+    ghost_begin_level(LEVEL, 8, 8);
+    for (int t = 0; t < 100; t++) ghost_record_tick(expect_x[t], expect_y[t]);
+    ghost_end_level(false);
+    CHECK(ghost_best_ticks(LEVEL) == 0);
+
+    // First completed run becomes the best
+    ghost_begin_level(LEVEL, 8, 8);
+    for (int t = 0; t < TICKS; t++) ghost_record_tick(expect_x[t], expect_y[t]);
+    ghost_end_level(true);
+    CHECK(ghost_best_ticks(LEVEL) == TICKS);
+
+    // Replay it while a slower run is recorded, as during play
+    ghost_begin_level(LEVEL, 8, 8);
+    int out_of_step = 0;
+    for (int t = 0; t < TICKS; t++) {
+        int x, y;
+        if (!ghost_playback_tick(&x, &y) || x != expect_x[t] || y != expect_y[t]) out_of_step++;
+        ghost_record_tick(expect_x[t], expect_y[t]);
+    }
+    CHECK(out_of_step == 0);
+    int x, y;
+    CHECK(!ghost_playback_tick(&x, &y));
+    ghost_record_tick(expect_x[TICKS - 1], expect_y[TICKS - 1]);
+    ghost_end_level(true);
+    CHECK(ghost_best_ticks(LEVEL) == TICKS);
+
+    // A faster run replaces it and is the one replayed next
+    ghost_begin_level(LEVEL, 8, 8);
+    for (int t = 0; t < TICKS / 2; t++) ghost_record_tick(expect_x[t], expect_y[t]);
+    ghost_end_level(true);
+    CHECK(ghost_best_ticks(LEVEL) == TICKS / 2);
+    ghost_begin_level(LEVEL, 8, 8);
+    int replayed = 0;
+    while (ghost_playback_tick(&x, &y)) replayed++;
+    ghost_end_level(false);
+    CHECK(replayed == TICKS / 2);
+
+    CHECK(ghost_self_test() == ESP_OK);
+    remove("./ghost_01.bin");
+    return check_result("ghost_check");
+}
@@ -0,0 +1,82 @@
+/**
+ * @file host_bench.c
+ * @brief Host runs of the engine benchmarks, on the same code the device runs them on
+ *
+ * The particle, screen effect, fog-of-war, level generator, tile cache and
+ * sprite run benchmarks are the modules' own *_benchmark() functions, also
+ * run on the device with CONFIG_FRUITLAND_STARTUP_BENCHMARKS. Autopilot
+ * planning is timed here over generated levels.
+ *
+ * Usage: host_bench <patterns.bmp>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atlas.h"
+#include "esp_log.h"
+#include "particles.h"
+#include "screen_fx.h"
+#include "fov.h"
+#include "levelgen.h"
+#include "autopilot.h"
+#include "tile_cache.h"
+#include "sprite_rle.h"
+
+static const char *TAG = "host";
+
+// One plan from the start of each of a few hundred generated levels
+static void autopilot_benchmark(void) {
+    const int count = 300;
+    int moves = 0;
+    for (int i = 0; i < count; i++) {
+        levelgen_level_t lvl;
+        levelgen_generate(0x5eed + i * 7919u, i % 16, &lvl);
+        autopilot_view_t view = {
+            .map = (const char *) lvl.tiles,
+            .width = LEVELGEN_WIDTH,
+            .height = LEVELGEN_HEIGHT,
+            .player_x = lvl.player_x,
+            .player_y = lvl.player_y,
+        };
+        for (int c = 0; c < LEVELGEN_WIDTH * LEVELGEN_HEIGHT && view.enemies < AUTOPILOT_MAX_ENEMIES; c++) {
+            if (lvl.tiles[c] >= 13 && lvl.tiles[c] <= 15) {
+                view.enemy_x[view.enemies] = c % LEVELGEN_WIDTH;
+                view.enemy_y[view.enemies++] = c / LEVELGEN_WIDTH;
+            }
+        }
+        if (autopilot_plan(&view) != AUTOPILOT_STAY) moves++;
+    }
+    autopilot_stats_t stats;
+    autopilot_get_stats(&stats);
+    ESP_LOGI(TAG, "📊 BENCH autopilot %lu plans: avg %llu us, max %lu us, %lu over budget, %d/%d moved",
+             (unsigned long) stats.plans, (unsigned long long) (stats.total_us / (stats.plans ? stats.plans : 1)),
+             (unsigned long) stats.max_us, (unsigned long) stats.budget_hits, moves, count);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <patterns.bmp>\n", argv[0]);
+        return 2;
+    }
+    int w, h;
+    uint16_t *atlas = load_atlas(argv[1], &w, &h);
+    if (!atlas) {
+        fprintf(stderr, "failed to load %s\n", argv[1]);
+        return 1;
+    }
+    if (tile_cache_init(atlas, w, h, w) != ESP_OK || sprite_rle_init(atlas, w, w, 1, 5) != ESP_OK) {
+        return 1;
+    }
+    free(atlas);
+
+    particles_benchmark();
+    screen_fx_benchmark();
+    fov_benchmark();
+    levelgen_benchmark();
+    autopilot_benchmark();
+    tile_cache_benchmark();
+    sprite_rle_benchmark();
+    return 0;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file SDL.h
+ * @brief Host build: the SDL types particles.h names, with a renderer that draws nothing
+ *
+ * The harness measures the particle system through its RGB565 path;
+ * particles_draw() links against no-op renderer calls.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    int x, y, w, h;
+} SDL_Rect;
+
+typedef struct {
+    float x, y, w, h;
+} SDL_FRect;
+
+typedef struct SDL_Renderer SDL_Renderer;
+
+bool SDL_SetRenderDrawColor(SDL_Renderer *renderer, uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+bool SDL_RenderFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, int count);
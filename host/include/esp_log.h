@@ -0,0 +1,15 @@
+/**
+ * @file esp_log.h
+ * @brief Host build: log macros print one line to stdout with level and tag
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#define ESP_LOG_LINE(level, tag, format, ...) printf(level " (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGE(tag, format, ...) ESP_LOG_LINE("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_LINE("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_LINE("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) do { } while (0)
+#define ESP_LOGV(tag, format, ...) do { } while (0)
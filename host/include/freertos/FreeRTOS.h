@@ -0,0 +1,26 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host build: just enough FreeRTOS for levelgen.c and ghost.c to compile
+ *
+ * The host has no scheduler: task creation fails, so the background level
+ * generator reports itself unavailable and ghost runs are saved inline.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define portMAX_DELAY 0xffffffffu
+#define portNUM_PROCESSORS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
+
+#define tskNO_AFFINITY 0x7fffffff
+
+BaseType_t xPortGetCoreID(void);
@@ -0,0 +1,14 @@
+/**
+ * @file sdkconfig.h
+ * @brief Host build: the configuration the host harness exercises
+ *
+ * Byte order (CONFIG_FRUITLAND_PANEL_BIG_ENDIAN) is set per target by
+ * host/CMakeLists.txt.
+ */
+
+#pragma once
+
+#define CONFIG_FRUITLAND_GHOST_RUN 1
+#define CONFIG_FRUITLAND_FOG_OF_WAR 1
+#define CONFIG_FRUITLAND_TILE_CACHE_SLOTS 64
+#define CONFIG_FRUITLAND_BAND_LINES 16
@@ -0,0 +1,79 @@
+/**
+ * @file levelgen_check.c
+ * @brief Endless-mode levels: repeatable from their seed, solvable and well formed past level 25
+ */
+
+#include <string.h>
+
+#include "check.h"
+#include "levelgen.h"
+
+#define CELLS (LEVELGEN_WIDTH * LEVELGEN_HEIGHT)
+#define SEEDS 200
+#define LEVELS 300  // Difficulty keeps rising past the 25 stored levels
+#define SESSION_SEED 1234
+
+static int count_tiles(const levelgen_level_t *lvl, uint8_t tile) {
+    int n = 0;
+    for (int c = 0; c < CELLS; c++) n += lvl->tiles[c] == tile;
+    return n;
+}
+
+int main(void) {
+    levelgen_level_t a, b;
+
+    // Same seed and difficulty, same level
+    for (int seed = 1; seed <= 20; seed++) {
+        levelgen_generate((uint32_t) seed, seed % 10, &a);
+        levelgen_generate((uint32_t) seed, seed % 10, &b);
+        CHECK(memcmp(a.tiles, b.tiles, CELLS) == 0);
+        CHECK(a.player_x == b.player_x && a.player_y == b.player_y && a.time == b.time);
+    }
+    levelgen_generate(1, 3, &a);
+    levelgen_generate(2, 3, &b);
+    CHECK(memcmp(a.tiles, b.tiles, CELLS) != 0);
+
+    // Every level is solvable, starts the player on an empty tile and has fruit and time to eat it
+    int bad = 0, attempts = 0;
+    for (int seed = 0; seed < SEEDS; seed++) {
+        for (int difficulty = 0; difficulty < LEVELS; difficulty += 23) {
+            levelgen_generate((uint32_t) seed * 7919, difficulty, &a);
+            bool ok = levelgen_is_solvable(&a) && a.player_x < LEVELGEN_WIDTH && a.player_y < LEVELGEN_HEIGHT &&
+                      a.tiles[a.player_y * LEVELGEN_WIDTH + a.player_x] == 0 && count_tiles(&a, 4) > 0 &&
+                      a.time >= 60 && a.seed == (uint32_t) seed * 7919;
+            bad += !ok;
+            attempts += a.attempts;
+        }
+    }
+    CHECK(bad == 0);
+    CHECK(attempts > 0);
+
+    // The solvability check rejects a fruit walled in
+    levelgen_generate(99, 0, &a);
+    memset(a.tiles, 1, CELLS);
+    a.player_x = 0;
+    a.player_y = 0;
+    a.tiles[0] = 0;
+    a.tiles[7 * LEVELGEN_WIDTH + 7] = 4;
+    CHECK(levelgen_is_solvable(&a));
+    a.tiles[6 * LEVELGEN_WIDTH + 7] = 2;
+    a.tiles[8 * LEVELGEN_WIDTH + 7] = 2;
+    a.tiles[7 * LEVELGEN_WIDTH + 6] = 2;
+    a.tiles[7 * LEVELGEN_WIDTH + 8] = 3;
+    CHECK(!levelgen_is_solvable(&a));
+
+    // No worker on the host: levels are generated inline in the same sequence, however far the run goes
+    CHECK(levelgen_start(SESSION_SEED) != ESP_OK);
+    int out_of_sequence = 0;
+    for (int index = 0; index < LEVELS; index++) {
+        levelgen_next(&a);
+        levelgen_generate(SESSION_SEED ^ ((uint32_t) index * 0x9e3779b9), index, &b);
+        out_of_sequence += memcmp(a.tiles, b.tiles, CELLS) != 0 || a.seed != b.seed ||
+                           a.player_x != b.player_x || a.player_y != b.player_y || !levelgen_is_solvable(&a);
+    }
+    CHECK(out_of_sequence == 0);
+    levelgen_stop();
+
+    levelgen_benchmark();
+    return check_result("levelgen_check");
+}
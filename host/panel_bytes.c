@@ -0,0 +1,99 @@
+/**
+ * @file panel_bytes.c
+ * @brief Compose a reference frame with the band compositor and write the bytes a panel would receive
+ *
+ * Built twice by host/CMakeLists.txt. The panel-order build keeps every
+ * pixel in big-endian RGB565 from load on and writes bands as they are.
+ * The host-order build composes little-endian pixels and swaps each one at
+ * scan-out, as SDL's display path does. The two outputs must be identical.
+ *
+ * Usage: panel_bytes <patterns.bmp> <output file>
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "band_render.h"
+#include "tile_cache.h"
+#include "sprite_rle.h"
+#include "particles.h"
+#include "screen_fx.h"
+
+#define WIDTH 256
+#define HEIGHT 224
+
+static uint8_t panel[WIDTH * HEIGHT * 2];
+
+// A different atlas cell in every cell of the frame; band_blit() clips to the band being composed
+static void compose(int y0, int lines) {
+    (void) y0;
+    (void) lines;
+    for (int y = 0; y < HEIGHT; y += 16) {
+        for (int x = 0; x < WIDTH; x += 16) {
+            band_blit(x, y, (x / 16) * 16 * 7 % 256, (y / 16) * 16 * 5 % 256, 16, 16);
+        }
+    }
+}
+
+static void present(uint16_t *band, int y0, int lines) {
+    uint8_t *out = panel + y0 * WIDTH * 2;
+#ifdef CONFIG_FRUITLAND_PANEL_BIG_ENDIAN
+    // Already in panel order: effects applied to swapped pixels, bytes go out as they are
+    screen_fx_apply_rgb565(band, WIDTH * lines, true);
+    memcpy(out, band, WIDTH * lines * 2);
+#else
+    // Host order: effects applied, then every pixel swapped on the way out
+    screen_fx_apply_rgb565(band, WIDTH * lines, false);
+    for (int i = 0; i < WIDTH * lines; i++) {
+        out[i * 2] = band[i] >> 8;
+        out[i * 2 + 1] = band[i] & 0xff;
+    }
+#endif
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <patterns.bmp> <output>\n", argv[0]);
+        return 2;
+    }
+    if (tile_cache_init_file(argv[1]) != ESP_OK || sprite_rle_init(NULL, 256, 0, 1, 5) != ESP_OK) {
+        return 1;
+    }
+    band_render_config_t config = {
+        .width = WIDTH,
+        .height = HEIGHT,
+        .cell_y0 = 8,
+        .hud_y = 192,
+        .hud_h = 16,
+        .compose = compose,
+        .present = present,
+    };
+    if (band_render_init(&config) != ESP_OK) {
+        return 1;
+    }
+
+    // Atlas cells, two sprites, particles of every colour and a tint over all of it
+    particles_set_clip(0, 0, WIDTH, HEIGHT);
+    particles_spawn_burst(100, 100, PARTICLE_BURST_PICKUP);
+    particles_spawn_burst(50, 150, PARTICLE_BURST_DEATH);
+    particles_spawn_burst(200, 60, PARTICLE_BURST_TELEPORT);
+    for (int i = 0; i < 5; i++) particles_update();
+    screen_fx_set_tint(160, 200, 255);
+    screen_fx_update(1);
+
+    rcmd_t cmds[4] = {
+        {.type = RCMD_LEVEL},
+        {.type = RCMD_SPRITE, .x = 40, .y = 37, .sprite = {.sx = 0, .sy = 16, .alpha = 255}},
+        {.type = RCMD_SPRITE, .x = 90, .y = 120, .sprite = {.sx = 32, .sy = 16, .alpha = 255}},
+        {.type = RCMD_PARTICLES, .x = 0, .y = 0, .rect = {WIDTH, HEIGHT}},
+    };
+    band_render_backend.execute(cmds, 4);
+
+    FILE *f = fopen(argv[2], "wb");
+    if (!f || fwrite(panel, 1, sizeof(panel), f) != sizeof(panel)) {
+        fprintf(stderr, "failed to write %s\n", argv[2]);
+        return 1;
+    }
+    fclose(f);
+    return 0;
+}
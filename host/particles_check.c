@@ -0,0 +1,104 @@
+/**
+ * @file particles_check.c
+ * @brief Particle pool limits, lifetimes, clipping and the software draw paths
+ */
+
+#include <string.h>
+
+#include "check.h"
+#include "particles.h"
+
+#define W 256
+#define H 224
+#define BAND 16
+
+static uint16_t frame[W * H];
+static uint16_t band[(BAND + 1) * W];  // One guard row
+static uint16_t banded[W * H];
+static uint16_t scaled[W * 2 * H * 2];
+static uint16_t turned[H * 2 * W * 2];
+
+int main(void) {
+    particles_set_clip(0, 0, W, H);
+    particles_set_origin(0, 0);
+
+    // Pool: bursts add up and stop at the pool size
+    particles_clear();
+    particles_spawn_burst(128, 112, PARTICLE_BURST_PICKUP);
+    int one = particles_active();
+    CHECK(one > 0);
+    particles_spawn_burst(128, 112, PARTICLE_BURST_PICKUP);
+    CHECK(particles_active() == 2 * one);
+    while (particles_active() < PARTICLES_MAX) {
+        int before = particles_active();
+        particles_spawn_burst(128, 112, PARTICLE_BURST_DEATH);
+        if (particles_active() == before) break;
+    }
+    CHECK(particles_active() == PARTICLES_MAX);
+    particles_spawn_burst(128, 112, PARTICLE_BURST_DEATH);
+    CHECK(particles_active() == PARTICLES_MAX);
+
+    // Lifetimes are under 64 frames for every preset
+    for (int f = 0; f < 64; f++) particles_update();
+    CHECK(particles_active() == 0);
+    SDL_Rect bounds;
+    CHECK(!particles_get_bounds(&bounds));
+
+    // Particles stay inside the clip rectangle and its reported bounds
+    particles_clear();
+    particles_set_clip(8, 8, 240, 176);
+    particles_spawn_burst(20, 20, PARTICLE_BURST_DEATH);
+    particles_spawn_burst(230, 170, PARTICLE_BURST_DEATH);
+    particles_spawn_burst(128, 100, PARTICLE_BURST_TELEPORT);
+    for (int f = 0; f < 6; f++) particles_update();
+    CHECK(particles_get_bounds(&bounds));
+    CHECK(bounds.x >= 8 && bounds.y >= 8 && bounds.x + bounds.w <= 248 && bounds.y + bounds.h <= 184);
+
+    memset(frame, 0, sizeof(frame));
+    particles_draw_rgb565(frame, W, W, H);
+    int drawn = 0, outside = 0;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (!frame[y * W + x]) continue;
+            drawn++;
+            if (x < bounds.x || x >= bounds.x + bounds.w || y < bounds.y || y >= bounds.y + bounds.h) outside++;
+        }
+    }
+    CHECK(drawn > 0);
+    CHECK(outside == 0);
+
+    // Band by band into one reused buffer, as the band compositor draws: the same frame
+    // across the seams, and nothing written past the band
+    int overrun = 0;
+    for (int y0 = 0; y0 < H; y0 += BAND) {
+        memset(band, 0, sizeof(band));
+        particles_set_origin(0, y0);
+        particles_draw_rgb565(band, W, W, BAND);
+        for (int i = BAND * W; i < (BAND + 1) * W; i++) overrun += band[i] != 0;
+        memcpy(banded + y0 * W, band, BAND * W * sizeof(uint16_t));
+    }
+    particles_set_origin(0, 0);
+    CHECK(overrun == 0);
+    CHECK(memcmp(frame, banded, sizeof(frame)) == 0);
+
+    // 2x is the 1x frame with every pixel doubled; turned is the 2x frame rotated clockwise
+    memset(scaled, 0, sizeof(scaled));
+    memset(turned, 0, sizeof(turned));
+    particles_draw_rgb565_scaled(scaled, W * 2, W * 2, H * 2, 2, false);
+    particles_draw_rgb565_scaled(turned, H * 2, W * 2, H * 2, 2, true);
+    int scale_mismatch = 0, turn_mismatch = 0;
+    for (int y = 0; y < H * 2; y++) {
+        for (int x = 0; x < W * 2; x++) {
+            uint16_t p = scaled[y * W * 2 + x];
+            if (p != frame[(y / 2) * W + x / 2]) scale_mismatch++;
+            if (p != turned[x * H * 2 + (H * 2 - 1 - y)]) turn_mismatch++;
+        }
+    }
+    CHECK(scale_mismatch == 0);
+    CHECK(turn_mismatch == 0);
+
+    particles_set_clip(0, 0, W, H);
+    particles_clear();
+    particles_benchmark();
+    return check_result("particles");
+}
@@ -0,0 +1,132 @@
+/**
+ * @file screen_fx_check.c
+ * @brief Screen effect transforms, the colour LUT against the per-channel path, and the scaler
+ */
+
+#include <string.h>
+
+#include "check.h"
+#include "esp_timer.h"
+#include "screen_fx.h"
+
+#define SRC_W 32
+#define SRC_H 24
+
+static uint16_t pixels[65536];
+static uint16_t swapped[65536];
+static uint16_t src[SRC_W * SRC_H];
+static uint16_t dst[SRC_W * 3 * SRC_H * 3];
+
+static uint16_t swap16(uint16_t c) {
+    return (uint16_t) (c << 8 | c >> 8);
+}
+
+int main(void) {
+    screen_fx_transform_t t;
+
+    // No effects: identity transform, no LUT, pixels untouched
+    screen_fx_reset();
+    screen_fx_update(esp_timer_get_time());
+    CHECK(!screen_fx_get_transform(&t));
+    CHECK(screen_fx_lut() == NULL);
+    for (int i = 0; i < 65536; i++) pixels[i] = (uint16_t) i;
+    screen_fx_apply_rgb565(pixels, 65536, false);
+    int changed = 0;
+    for (int i = 0; i < 65536; i++) changed += pixels[i] != i;
+    CHECK(changed == 0);
+
+    // Tint with a flash: the LUT, the per-channel path and its byte-swapped form agree on every colour
+    screen_fx_set_tint(200, 128, 255);
+    screen_fx_flash(64, 0, 32, 1000);
+    int64_t now = esp_timer_get_time();  // Effects time from their start, so read the clock after it
+    CHECK(screen_fx_update(now));
+    CHECK(screen_fx_get_transform(&t));
+    CHECK(t.mul[0] == 200 && t.mul[1] == 128 && t.mul[2] == 255);
+    CHECK(t.add[0] > 0 && t.add[1] == 0 && t.add[2] > 0);
+    const uint16_t *lut = screen_fx_lut();
+    CHECK(lut != NULL);
+    for (int i = 0; i < 65536; i++) {
+        pixels[i] = (uint16_t) i;
+        swapped[i] = swap16((uint16_t) i);
+    }
+    screen_fx_apply_rgb565(pixels, 65536, false);
+    screen_fx_apply_rgb565(swapped, 65536, true);
+    int lut_mismatch = 0, swap_mismatch = 0;
+    for (int i = 0; i < 65536 && lut; i++) {
+        lut_mismatch += pixels[i] != lut[i];
+        swap_mismatch += swap16(swapped[i]) != pixels[i];
+    }
+    CHECK(lut_mismatch == 0);
+    CHECK(swap_mismatch == 0);
+    CHECK(lut && lut[0xFFFF] != 0xFFFF);
+
+    // The flash decays away and leaves only the tint
+    CHECK(screen_fx_update(now + 2000000));
+    CHECK(screen_fx_get_transform(&t));
+    CHECK(t.add[0] == 0 && t.add[1] == 0 && t.add[2] == 0);
+    CHECK(!screen_fx_update(now + 2100000));
+
+    // A finished fade-out holds black until a fade-in or reset
+    screen_fx_reset();
+    screen_fx_fade(true, 100);
+    now = esp_timer_get_time();
+    screen_fx_update(now + 50000);
+    CHECK(screen_fx_get_transform(&t));
+    CHECK(t.mul[0] > 0 && t.mul[0] < 255);
+    screen_fx_update(now + 200000);
+    screen_fx_update(now + 300000);
+    CHECK(screen_fx_get_transform(&t));
+    CHECK(t.mul[0] == 0 && t.mul[1] == 0 && t.mul[2] == 0);
+    lut = screen_fx_lut();
+    CHECK(lut && lut[0xFFFF] == 0);
+
+    screen_fx_reset();
+    screen_fx_update(now + 400000);
+    CHECK(!screen_fx_get_transform(&t));
+    CHECK(screen_fx_lut() == NULL);
+
+    // Shake and offset move the frame without changing its colours
+    screen_fx_set_offset(3, -2);
+    screen_fx_shake(4, 100);
+    now = esp_timer_get_time();
+    screen_fx_update(now);
+    CHECK(!screen_fx_get_transform(&t));
+    CHECK(t.offset[0] != 3 || t.offset[1] != -2);
+    CHECK(t.offset[0] >= -1 && t.offset[0] <= 7 && t.offset[1] >= -6 && t.offset[1] <= 2);
+    screen_fx_update(now + 200000);
+    screen_fx_get_transform(&t);
+    CHECK(t.offset[0] == 3 && t.offset[1] == -2);
+    screen_fx_reset();
+    screen_fx_update(now + 300000);
+
+    // Scaler: every output pixel is its nearest source pixel, through the table when given
+    for (int y = 0; y < SRC_H; y++) {
+        for (int x = 0; x < SRC_W; x++) src[y * SRC_W + x] = (uint16_t) (y << 8 | x);
+    }
+    int scale_mismatch = 0;
+    for (int s = 1; s <= 3; s++) {
+        memset(dst, 0, sizeof(dst));
+        screen_fx_scale_rgb565(src, SRC_W, SRC_H, SRC_W, dst, SRC_W * s, SRC_H * s, SRC_W * s, NULL);
+        for (int y = 0; y < SRC_H * s; y++) {
+            for (int x = 0; x < SRC_W * s; x++) {
+                scale_mismatch += dst[y * SRC_W * s + x] != src[(y / s) * SRC_W + x / s];
+            }
+        }
+    }
+    CHECK(scale_mismatch == 0);
+
+    screen_fx_fade(true, 0);
+    screen_fx_update(esp_timer_get_time());
+    lut = screen_fx_lut();
+    CHECK(lut != NULL);
+    memset(dst, 0xFF, sizeof(dst));
+    screen_fx_scale_rgb565(src, SRC_W, SRC_H, SRC_W, dst, SRC_W * 2, SRC_H * 2, SRC_W * 2, lut);
+    int lit = 0;
+    for (int i = 0; i < SRC_W * 2 * SRC_H * 2; i++) lit += dst[i] != 0;
+    CHECK(lit == 0);
+    screen_fx_reset();
+    screen_fx_update(esp_timer_get_time());
+
+    screen_fx_benchmark();
+    return check_result("screen_fx_check");
+}
@@ -0,0 +1,89 @@
+/**
+ * @file sprite_rle_check.c
+ * @brief RLE sprites drawn anywhere, edges included, match a per-pixel keyed draw of the same cell
+ *
+ * Usage: sprite_rle_check <patterns.bmp>
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "check.h"
+#include "sprite_rle.h"
+#include "tile_cache.h"
+
+#define ATLAS_W 256
+#define CELL_ROW0 1
+#define CELL_ROWS 5
+#define W 100
+#define H 60
+#define STRIDE (W + 4)  // Columns past the clip width must stay untouched
+#define ROWS (H + 2)    // As must the rows below it
+#define FILL 0x5a5a
+
+static uint16_t rle[STRIDE * ROWS];
+static uint16_t keyed[STRIDE * ROWS];
+
+// What the RLE draw replaces: bounds and key test on every pixel
+static void draw_keyed(int x, int y, const uint16_t *cell, int *opaque) {
+    for (int r = 0; r < SPRITE_RLE_SIZE; r++) {
+        for (int c = 0; c < SPRITE_RLE_SIZE; c++) {
+            uint16_t v = cell[r * SPRITE_RLE_SIZE + c];
+            if (v == SPRITE_RLE_KEY) continue;
+            (*opaque)++;
+            int px = x + c, py = y + r;
+            if (px >= 0 && px < W && py >= 0 && py < H) keyed[py * STRIDE + px] = v;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <patterns.bmp>\n", argv[0]);
+        return 2;
+    }
+    CHECK(tile_cache_init_file(argv[1]) == ESP_OK);
+    CHECK(sprite_rle_init(NULL, ATLAS_W, 0, CELL_ROW0, CELL_ROWS) == ESP_OK);
+
+    // Only cell-aligned positions inside the encoded band have a sprite
+    CHECK(sprite_rle_get(0, CELL_ROW0 * 16) != NULL);
+    CHECK(sprite_rle_get(ATLAS_W - 16, (CELL_ROW0 + CELL_ROWS - 1) * 16) != NULL);
+    CHECK(sprite_rle_get(0, (CELL_ROW0 - 1) * 16) == NULL);
+    CHECK(sprite_rle_get(0, (CELL_ROW0 + CELL_ROWS) * 16) == NULL);
+    CHECK(sprite_rle_get(ATLAS_W, CELL_ROW0 * 16) == NULL);
+    CHECK(sprite_rle_get(8, CELL_ROW0 * 16) == NULL);
+
+    // Inside, across each edge and corner, and entirely outside
+    static const int pos[][2] = {
+        {10, 10}, {W - 16, H - 16}, {-5, 20}, {W - 7, 20}, {30, -9}, {30, H - 3}, {-15, -15},
+        {W - 1, H - 1}, {-1, 30}, {50, -1}, {W - 15, 30}, {50, H - 15}, {-16, 10}, {W, 10}, {40, -16},
+        {40, H}, {-60, 200},
+    };
+    int mismatched = 0, opaque = 0, cells = 0;
+    for (int cy = CELL_ROW0; cy < CELL_ROW0 + CELL_ROWS; cy++) {
+        for (int cx = 0; cx < ATLAS_W / 16; cx++) {
+            const sprite_rle_t *sprite = sprite_rle_get(cx * 16, cy * 16);
+            const uint16_t *cell = tile_cache_get(cx * 16, cy * 16);
+            if (!sprite || !cell) {
+                mismatched++;
+                continue;
+            }
+            cells++;
+            for (size_t p = 0; p < sizeof(pos) / sizeof(pos[0]); p++) {
+                for (int i = 0; i < STRIDE * ROWS; i++) rle[i] = keyed[i] = FILL;
+                sprite_rle_draw(rle, W, H, STRIDE, pos[p][0], pos[p][1], sprite, cell);
+                draw_keyed(pos[p][0], pos[p][1], cell, &opaque);
+                mismatched += memcmp(rle, keyed, sizeof(rle)) != 0;
+            }
+        }
+    }
+    CHECK(cells == CELL_ROWS * ATLAS_W / 16);
+    CHECK(mismatched == 0);
+    // The band holds both opaque and keyed pixels, so both paths were exercised
+    CHECK(opaque > 0 && opaque < cells * (int) (sizeof(pos) / sizeof(pos[0])) * 256);
+
+    sprite_rle_benchmark();
+    sprite_rle_free();
+    CHECK(sprite_rle_get(0, CELL_ROW0 * 16) == NULL);
+    return check_result("sprite_rle_check");
+}
@@ -0,0 +1,124 @@
+/**
+ * @file tile_cache_check.c
+ * @brief Tile cache cells against the atlas, LRU eviction and hit counts, and the file-backed reader
+ *
+ * Usage: tile_cache_check <patterns.bmp>
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atlas.h"
+#include "check.h"
+#include "tile_cache.h"
+
+#define CELL TILE_CACHE_CELL
+#define PAD 16  // Extra pixels per row of the padded copy, for the pitch
+
+static int atlas_w, atlas_h;
+static uint16_t *atlas;
+
+static const uint16_t *get_cell(int i) {
+    return tile_cache_get((i % (atlas_w / CELL)) * CELL, (i / (atlas_w / CELL)) * CELL);
+}
+
+// Every cell through the cache equals the atlas; far more cells than slots, so most are evictions
+static int count_wrong_cells(void) {
+    int wrong = 0;
+    for (int i = 0; i < (atlas_w / CELL) * (atlas_h / CELL); i++) {
+        const uint16_t *cell = get_cell(i);
+        const uint16_t *src = atlas + (i / (atlas_w / CELL)) * CELL * atlas_w + (i % (atlas_w / CELL)) * CELL;
+        bool same = cell != NULL;
+        for (int y = 0; same && y < CELL; y++) same = memcmp(cell + y * CELL, src + y * atlas_w, CELL * 2) == 0;
+        wrong += !same;
+    }
+    return wrong;
+}
+
+static tile_cache_stats_t since(const tile_cache_stats_t *before) {
+    tile_cache_stats_t now;
+    tile_cache_get_stats(&now);
+    now.hits -= before->hits;
+    now.misses -= before->misses;
+    now.evictions -= before->evictions;
+    return now;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <patterns.bmp>\n", argv[0]);
+        return 2;
+    }
+    atlas = load_atlas(argv[1], &atlas_w, &atlas_h);
+    CHECK(atlas != NULL);
+    if (!atlas) return check_result("tile_cache_check");
+    int cells = (atlas_w / CELL) * (atlas_h / CELL);
+    CHECK(cells > TILE_CACHE_SLOTS + 1);
+
+    // The atlas handed over with a wider pitch is copied row by row
+    uint16_t *padded = malloc((atlas_w + PAD) * atlas_h * sizeof(uint16_t));
+    CHECK(padded != NULL);
+    for (int y = 0; padded && y < atlas_h; y++) {
+        memcpy(padded + y * (atlas_w + PAD), atlas + y * atlas_w, atlas_w * 2);
+        memset(padded + y * (atlas_w + PAD) + atlas_w, 0xff, PAD * 2);
+    }
+    CHECK(tile_cache_init(padded, atlas_w, atlas_h, atlas_w + PAD) == ESP_OK);
+    free(padded);
+    CHECK(count_wrong_cells() == 0);
+    CHECK(tile_cache_get(-CELL, 0) == NULL && tile_cache_get(atlas_w, 0) == NULL && tile_cache_get(0, atlas_h) == NULL);
+
+    // Hits, misses and residency from a flush on
+    tile_cache_stats_t before, d;
+    tile_cache_flush();
+    tile_cache_get_stats(&before);
+    CHECK(before.resident == 0);
+    const uint16_t *first = get_cell(0);
+    CHECK(get_cell(0) == first);
+    d = since(&before);
+    CHECK(d.misses == 1 && d.hits == 1 && d.evictions == 0 && d.resident == 1);
+
+    // Least recently used goes first: with every slot full and cell 0 touched again, cell 1 is evicted
+    for (int i = 1; i < TILE_CACHE_SLOTS; i++) get_cell(i);
+    get_cell(0);
+    d = since(&before);
+    CHECK(d.misses == TILE_CACHE_SLOTS && d.evictions == 0 && d.resident == TILE_CACHE_SLOTS);
+    get_cell(TILE_CACHE_SLOTS);
+    d = since(&before);
+    CHECK(d.evictions == 1 && d.resident == TILE_CACHE_SLOTS);
+    get_cell(0);
+    CHECK(since(&before).misses == d.misses);
+    get_cell(1);
+    CHECK(since(&before).misses == d.misses + 1);
+
+    // The flush empties the slots but keeps the running totals
+    tile_cache_get_stats(&before);
+    tile_cache_flush();
+    tile_cache_get_stats(&d);
+    CHECK(d.resident == 0 && d.misses == before.misses && d.hits == before.hits);
+    get_cell(0);
+    CHECK(since(&before).misses == 1);
+
+    // Read in place from the BMP: the same pixels
+    CHECK(tile_cache_init_file("./missing.bmp") == ESP_ERR_NOT_FOUND);
+    FILE *f = fopen("./not_a_bmp.bmp", "wb");
+    if (f) {
+        fputs("this is not a bitmap, only some text long enough for a header............", f);
+        fclose(f);
+    }
+    CHECK(tile_cache_init_file("./not_a_bmp.bmp") == ESP_ERR_NOT_SUPPORTED);
+    remove("./not_a_bmp.bmp");
+    CHECK(tile_cache_get(0, 0) == NULL);
+    CHECK(tile_cache_init_file(argv[1]) == ESP_OK);
+    CHECK(count_wrong_cells() == 0);
+
+    tile_cache_free();
+    CHECK(tile_cache_get(0, 0) == NULL);
+
+    CHECK(tile_cache_init(atlas, atlas_w, atlas_h, atlas_w) == ESP_OK);
+    tile_cache_benchmark();
+    tile_cache_free();
+    free(atlas);
+    return check_result("tile_cache_check");
+}
@@ -16,6 +16,7 @@
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "binlog.h"
 
 static const char *TAG = "accelerometer";
 
@@ -111,7 +112,7 @@ static void handle_single_move(int dir_index, uint64_t current_time) {
         last_move_time[dir_index] = current_time;
 
         const char *dir_names[] = {"LEFT", "RIGHT", "UP", "DOWN"};
-        ESP_LOGI(TAG, "🎮 %s single move queued - precise one tile", dir_names[dir_index]);
+        BINLOG_I("accelerometer", "🎮 %s single move queued - precise one tile", BINLOG_STR(dir_names[dir_index]));
     }
 }
 
@@ -128,7 +129,7 @@ int accelerometer_get_pending_move(void) {
  */
 void accelerometer_consume_pending_move(void) {
     if (pending_single_move != 0) {
-        ESP_LOGI(TAG, "✅ Single move consumed");
+        BINLOG_I("accelerometer", "✅ Single move consumed");
         pending_single_move = 0;
     }
 }
@@ -0,0 +1,558 @@
+/**
+ * @file audio.c
+ * @brief Fixed-point sound effect mixer for ESP32-Fruitland
+ *
+ * The game thread pushes trigger commands into a single-producer/single-consumer
+ * ring using only atomic loads and stores. The mixer task drains the ring at the
+ * start of every block, mixes up to AUDIO_MAX_VOICES voices into a 32-bit
+ * accumulator, applies the master volume and saturates into a DMA-capable
+ * buffer that is handed to the backend. The game loop never waits on audio.
+ */
+
+#include "audio.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "audio";
+
+#ifdef CONFIG_FRUITLAND_AUDIO
+
+#ifdef CONFIG_FRUITLAND_AUDIO_BACKEND_CODEC
+#include "bsp/esp-box-3.h"
+#include "esp_codec_dev.h"
+#endif
+
+#define AUDIO_SAMPLE_RATE 16000
+#define AUDIO_CHANNELS 2                                           // Mono mix duplicated to both channels
+#define AUDIO_BLOCK_FRAMES 256                                     // 16 ms per block at 16 kHz
+#define AUDIO_BLOCK_US (AUDIO_BLOCK_FRAMES * 1000000 / AUDIO_SAMPLE_RATE)
+#define AUDIO_MAX_VOICES 4
+#define AUDIO_CMD_RING_SIZE 16                                     // Must be a power of two
+#define AUDIO_VOICE_GAIN_Q15 0x5000                                // ~0.63 per voice, leaves mixing headroom
+#define AUDIO_TASK_STACK 4096
+#define AUDIO_TASK_PRIORITY 6                                      // Above the game thread; runs briefly per block
+#define AUDIO_STATS_INTERVAL_BLOCKS (10 * AUDIO_SAMPLE_RATE / AUDIO_BLOCK_FRAMES)  // ~10 seconds
+
+// Synthesis description: up to three tone segments per effect
+typedef enum { WAVE_SQUARE = 0, WAVE_TRIANGLE, WAVE_NOISE } wave_t;
+
+typedef struct {
+    uint16_t start_hz;
+    uint16_t end_hz;
+    uint16_t duration_ms;
+    uint8_t wave;
+} tone_segment_t;
+
+typedef struct {
+    tone_segment_t segments[3];
+    uint8_t count;
+} sfx_desc_t;
+
+static const sfx_desc_t sfx_descs[AUDIO_SFX_COUNT] = {
+    [AUDIO_SFX_FRUIT] = {{{660, 990, 40, WAVE_SQUARE}, {990, 1320, 60, WAVE_SQUARE}}, 2},
+    [AUDIO_SFX_BONUS] = {{{880, 1760, 80, WAVE_TRIANGLE}}, 1},
+    [AUDIO_SFX_DEATH] = {{{440, 110, 400, WAVE_SQUARE}, {0, 0, 150, WAVE_NOISE}}, 2},
+    [AUDIO_SFX_TELEPORT] = {{{200, 2000, 250, WAVE_TRIANGLE}}, 1},
+    [AUDIO_SFX_FLIP] = {{{1200, 300, 150, WAVE_SQUARE}, {300, 1200, 150, WAVE_SQUARE}}, 2},
+};
+
+// Pre-decoded PCM for each effect (mono, signed 16-bit)
+typedef struct {
+    int16_t *data;
+    uint32_t frames;
+} sfx_pcm_t;
+
+typedef struct {
+    const int16_t *data;
+    uint32_t pos;
+    uint32_t frames;
+} voice_t;
+
+typedef struct {
+    uint8_t sfx;
+    uint32_t trigger_us;
+} audio_cmd_t;
+
+static sfx_pcm_t sfx_pcm[AUDIO_SFX_COUNT];
+static voice_t voices[AUDIO_MAX_VOICES];
+static int32_t mix_acc[AUDIO_BLOCK_FRAMES];
+static int16_t *out_buffer = NULL;  // DMA-capable, AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS samples
+
+// SPSC command ring: game thread owns cmd_head, mixer task owns cmd_tail
+static audio_cmd_t cmd_ring[AUDIO_CMD_RING_SIZE];
+static atomic_uint cmd_head = 0;
+static atomic_uint cmd_tail = 0;
+static atomic_uint cmd_dropped = 0;
+
+static atomic_int master_volume = 192;
+static volatile bool audio_running = false;
+static bool audio_initialized = false;
+static TaskHandle_t audio_task_handle = NULL;
+static SemaphoreHandle_t audio_stopped = NULL;
+
+static audio_stats_t stats;
+static uint64_t total_mix_us = 0;
+static uint64_t total_latency_us = 0;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Render one effect description to PCM using integer phase accumulators
+static esp_err_t synthesize_sfx(audio_sfx_t sfx) {
+    const sfx_desc_t *desc = &sfx_descs[sfx];
+    uint32_t frames = 0;
+    for (int s = 0; s < desc->count; s++) {
+        frames += desc->segments[s].duration_ms * AUDIO_SAMPLE_RATE / 1000;
+    }
+
+    int16_t *pcm = heap_caps_malloc(frames * sizeof(int16_t), MALLOC_CAP_8BIT);
+    if (!pcm) return ESP_ERR_NO_MEM;
+
+    uint32_t out = 0;
+    uint32_t phase = 0;
+    uint16_t lfsr = 0xACE1;
+    for (int s = 0; s < desc->count; s++) {
+        const tone_segment_t *seg = &desc->segments[s];
+        uint32_t n = seg->duration_ms * AUDIO_SAMPLE_RATE / 1000;
+        for (uint32_t i = 0; i < n; i++) {
+            // Linear frequency sweep and linear decay envelope
+            int32_t hz = seg->start_hz + ((int32_t) seg->end_hz - seg->start_hz) * (int32_t) i / (int32_t) n;
+            phase += (uint32_t) (((uint64_t) hz << 32) / AUDIO_SAMPLE_RATE);
+            int32_t envelope = 32767 - (int32_t) ((int64_t) 32767 * i / n);
+
+            int32_t sample;
+            switch (seg->wave) {
+                case WAVE_TRIANGLE: {
+                    int32_t ramp = (int32_t) (phase >> 16);  // 0..65535
+                    sample = (ramp < 32768 ? ramp * 2 : (65535 - ramp) * 2) - 32768;
+                    break;
+                }
+                case WAVE_NOISE:
+                    lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+                    sample = (int16_t) lfsr;
+                    break;
+                default:
+                    sample = (phase & 0x80000000u) ? 32767 : -32768;
+                    break;
+            }
+            pcm[out++] = (int16_t) ((sample * envelope) >> 15);
+        }
+    }
+
+    sfx_pcm[sfx].data = pcm;
+    sfx_pcm[sfx].frames = frames;
+    return ESP_OK;
+}
+
+// Output backends
+
+#ifdef CONFIG_FRUITLAND_AUDIO_BACKEND_CODEC
+
+static esp_codec_dev_handle_t speaker = NULL;
+
+static esp_err_t backend_open(void) {
+    speaker = bsp_audio_codec_speaker_init();
+    if (!speaker) {
+        ESP_LOGE(TAG, "Failed to initialize speaker codec");
+        return ESP_FAIL;
+    }
+    esp_codec_dev_sample_info_t fs = {
+        .sample_rate = AUDIO_SAMPLE_RATE,
+        .channel = AUDIO_CHANNELS,
+        .bits_per_sample = 16,
+    };
+    if (esp_codec_dev_open(speaker, &fs) != ESP_CODEC_DEV_OK) {
+        ESP_LOGE(TAG, "Failed to open speaker codec");
+        return ESP_FAIL;
+    }
+    esp_codec_dev_set_out_vol(speaker, 70);
+    ESP_LOGI(TAG, "Codec backend: %d Hz, %d ch, %d frames per block", AUDIO_SAMPLE_RATE, AUDIO_CHANNELS,
+             AUDIO_BLOCK_FRAMES);
+    return ESP_OK;
+}
+
+// Blocks until the I2S DMA queue accepts the block, which paces the mixer
+static void backend_write(const int16_t *samples, size_t frames) {
+    esp_codec_dev_write(speaker, (void *) samples, frames * AUDIO_CHANNELS * sizeof(int16_t));
+}
+
+static void backend_close(void) {
+    if (speaker) {
+        esp_codec_dev_close(speaker);
+        speaker = NULL;
+    }
+}
+
+#else  // CONFIG_FRUITLAND_AUDIO_BACKEND_CAPTURE
+
+#include "freertos/queue.h"
+
+#define CAPTURE_PATH "/assets/sfx_capture.wav"
+#define CAPTURE_MAX_FRAMES ((uint32_t) CONFIG_FRUITLAND_AUDIO_CAPTURE_SECONDS * AUDIO_SAMPLE_RATE)
+#define CAPTURE_QUEUE_BLOCKS 16      // ~256 ms of audio buffered while a flash erase stalls the writer
+#define CAPTURE_TASK_STACK 3072
+#define CAPTURE_TASK_PRIORITY 2      // Below the game thread: flash writes never hold up a frame
+
+typedef struct {
+    uint16_t frames;  // 0 asks the writer to finish the file and exit
+    int16_t samples[AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS];
+} capture_block_t;
+
+static FILE *capture_file = NULL;
+static QueueHandle_t capture_queue = NULL;
+static SemaphoreHandle_t capture_stopped = NULL;
+static uint32_t capture_queued = 0;   // Frames handed to the writer (mixer task only)
+static uint32_t capture_dropped = 0;  // Blocks lost to a full queue (mixer task until the stop)
+static bool capture_done = false;     // Stop sent to the writer
+static int64_t next_block_us = 0;
+
+static void write_wav_header(FILE *f, uint32_t frames) {
+    uint32_t data_bytes = frames * AUDIO_CHANNELS * sizeof(int16_t);
+    uint32_t riff_size = 36 + data_bytes;
+    uint32_t fmt_size = 16, rate = AUDIO_SAMPLE_RATE;
+    uint32_t byte_rate = AUDIO_SAMPLE_RATE * AUDIO_CHANNELS * sizeof(int16_t);
+    uint16_t format = 1, channels = AUDIO_CHANNELS, align = AUDIO_CHANNELS * sizeof(int16_t), bits = 16;
+
+    fseek(f, 0, SEEK_SET);
+    fwrite("RIFF", 1, 4, f);
+    fwrite(&riff_size, 4, 1, f);
+    fwrite("WAVEfmt ", 1, 8, f);
+    fwrite(&fmt_size, 4, 1, f);
+    fwrite(&format, 2, 1, f);
+    fwrite(&channels, 2, 1, f);
+    fwrite(&rate, 4, 1, f);
+    fwrite(&byte_rate, 4, 1, f);
+    fwrite(&align, 2, 1, f);
+    fwrite(&bits, 2, 1, f);
+    fwrite("data", 1, 4, f);
+    fwrite(&data_bytes, 4, 1, f);
+}
+
+// Low-priority writer: owns the file, so littlefs erases only ever stall this task
+static void capture_task(void *param) {
+    static capture_block_t block;
+    uint32_t written = 0;
+
+    while (xQueueReceive(capture_queue, &block, portMAX_DELAY) == pdTRUE && block.frames > 0) {
+        fwrite(block.samples, sizeof(int16_t) * AUDIO_CHANNELS, block.frames, capture_file);
+        written += block.frames;
+    }
+
+    write_wav_header(capture_file, written);
+    fclose(capture_file);
+    capture_file = NULL;
+    ESP_LOGI(TAG, "Captured %lu frames to %s (%lu blocks dropped)", (unsigned long) written, CAPTURE_PATH,
+             (unsigned long) capture_dropped);
+    xSemaphoreGive(capture_stopped);
+    vTaskDelete(NULL);
+}
+
+// Sent once, from the mixer task or from cleanup after the mixer has stopped
+static void finish_capture(void) {
+    if (!capture_queue || capture_done) return;
+    static const capture_block_t stop = {.frames = 0};
+    xQueueSend(capture_queue, &stop, portMAX_DELAY);
+    capture_done = true;
+}
+
+static esp_err_t backend_open(void) {
+    capture_queued = 0;
+    capture_dropped = 0;
+    if (CAPTURE_MAX_FRAMES > 0) {
+        capture_file = fopen(CAPTURE_PATH, "wb");
+        if (capture_file) {
+            write_wav_header(capture_file, 0);
+        }
+        capture_queue = capture_file ? xQueueCreate(CAPTURE_QUEUE_BLOCKS, sizeof(capture_block_t)) : NULL;
+        capture_stopped = capture_queue ? xSemaphoreCreateBinary() : NULL;
+        if (!capture_stopped || xTaskCreatePinnedToCore(capture_task, "audio_cap", CAPTURE_TASK_STACK, NULL,
+                                                        CAPTURE_TASK_PRIORITY, NULL, tskNO_AFFINITY) != pdPASS) {
+            ESP_LOGW(TAG, "Cannot open %s or start its writer, capture disabled", CAPTURE_PATH);
+            if (capture_stopped) vSemaphoreDelete(capture_stopped);
+            if (capture_queue) vQueueDelete(capture_queue);
+            if (capture_file) fclose(capture_file);
+            capture_stopped = NULL;
+            capture_queue = NULL;
+            capture_file = NULL;
+        }
+    }
+    next_block_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "Capture backend: %d Hz, %d ch, %d frames per block", AUDIO_SAMPLE_RATE, AUDIO_CHANNELS,
+             AUDIO_BLOCK_FRAMES);
+    return ESP_OK;
+}
+
+// No hardware clock, so pace blocks in real time to keep latency figures meaningful.
+// Captured blocks are queued without waiting; the writer task does the flash I/O.
+static void backend_write(const int16_t *samples, size_t frames) {
+    if (capture_queue && !capture_done) {
+        static capture_block_t block;
+        block.frames = frames;
+        memcpy(block.samples, samples, frames * AUDIO_CHANNELS * sizeof(int16_t));
+        if (xQueueSend(capture_queue, &block, 0) == pdTRUE) {
+            capture_queued += frames;
+        } else {
+            capture_dropped++;
+        }
+        if (capture_queued >= CAPTURE_MAX_FRAMES) {
+            finish_capture();
+        }
+    }
+
+    next_block_us += AUDIO_BLOCK_US;
+    int64_t wait_us = next_block_us - esp_timer_get_time();
+    if (wait_us > 1000) {
+        vTaskDelay(pdMS_TO_TICKS(wait_us / 1000));
+    } else if (wait_us < -(int64_t) AUDIO_BLOCK_US * 4) {
+        next_block_us = esp_timer_get_time();  // Fell far behind, resynchronize
+    }
+}
+
+static void backend_close(void) {
+    if (!capture_queue) return;
+    finish_capture();
+    xSemaphoreTake(capture_stopped, portMAX_DELAY);
+    vQueueDelete(capture_queue);
+    vSemaphoreDelete(capture_stopped);
+    capture_queue = NULL;
+    capture_stopped = NULL;
+    capture_done = false;
+}
+
+#endif  // CONFIG_FRUITLAND_AUDIO_BACKEND_CODEC
+
+// Mixer
+
+static void start_voice(const audio_cmd_t *cmd) {
+    const sfx_pcm_t *pcm = &sfx_pcm[cmd->sfx];
+    int slot = 0;
+    uint32_t most_played = 0;
+    for (int v = 0; v < AUDIO_MAX_VOICES; v++) {
+        if (!voices[v].data) {
+            slot = v;
+            break;
+        }
+        // All busy: steal the voice closest to finishing
+        if (voices[v].pos >= most_played) {
+            most_played = voices[v].pos;
+            slot = v;
+        }
+    }
+    voices[slot].data = pcm->data;
+    voices[slot].pos = 0;
+    voices[slot].frames = pcm->frames;
+}
+
+static void mix_block(void) {
+    memset(mix_acc, 0, sizeof(mix_acc));
+
+    for (int v = 0; v < AUDIO_MAX_VOICES; v++) {
+        voice_t *voice = &voices[v];
+        if (!voice->data) continue;
+
+        uint32_t n = voice->frames - voice->pos;
+        if (n > AUDIO_BLOCK_FRAMES) n = AUDIO_BLOCK_FRAMES;
+        const int16_t *src = voice->data + voice->pos;
+        for (uint32_t i = 0; i < n; i++) {
+            mix_acc[i] += (src[i] * AUDIO_VOICE_GAIN_Q15) >> 15;
+        }
+
+        voice->pos += n;
+        if (voice->pos >= voice->frames) {
+            voice->data = NULL;
+        }
+    }
+
+    int32_t volume = atomic_load_explicit(&master_volume, memory_order_relaxed);
+    for (int i = 0; i < AUDIO_BLOCK_FRAMES; i++) {
+        int32_t s = (mix_acc[i] * volume) >> 8;
+        if (s > 32767) s = 32767;
+        if (s < -32768) s = -32768;
+        out_buffer[i * 2] = (int16_t) s;
+        out_buffer[i * 2 + 1] = (int16_t) s;
+    }
+}
+
+static void audio_task(void *param) {
+    ESP_LOGI(TAG, "Mixer task started");
+    uint32_t pending_trigger_us[AUDIO_CMD_RING_SIZE];
+
+    while (audio_running) {
+        // Drain trigger commands published by the game thread
+        unsigned tail = atomic_load_explicit(&cmd_tail, memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&cmd_head, memory_order_acquire);
+        int started = 0;
+        while (tail != head) {
+            const audio_cmd_t *cmd = &cmd_ring[tail & (AUDIO_CMD_RING_SIZE - 1)];
+            start_voice(cmd);
+            pending_trigger_us[started++] = cmd->trigger_us;
+            tail++;
+        }
+        atomic_store_explicit(&cmd_tail, tail, memory_order_release);
+
+        int64_t mix_start = esp_timer_get_time();
+        mix_block();
+        uint32_t mix_us = (uint32_t) (esp_timer_get_time() - mix_start);
+        uint32_t handoff_us = (uint32_t) esp_timer_get_time();
+
+        taskENTER_CRITICAL(&stats_lock);
+        stats.blocks++;
+        stats.triggers += started;
+        total_mix_us += mix_us;
+        if (mix_us > stats.max_mix_us) stats.max_mix_us = mix_us;
+        for (int i = 0; i < started; i++) {
+            uint32_t latency = handoff_us - pending_trigger_us[i];
+            total_latency_us += latency;
+            if (latency > stats.max_latency_us) stats.max_latency_us = latency;
+        }
+        taskEXIT_CRITICAL(&stats_lock);
+
+        backend_write(out_buffer, AUDIO_BLOCK_FRAMES);
+
+        if (stats.blocks % AUDIO_STATS_INTERVAL_BLOCKS == 0) {
+            audio_stats_t snapshot;
+            audio_get_stats(&snapshot);
+            ESP_LOGI(TAG, "🔊 MIX: avg=%lu us max=%lu us per %d-frame block | LATENCY: avg=%lu us max=%lu us | "
+                     "triggers=%lu dropped=%lu",
+                     (unsigned long) snapshot.avg_mix_us, (unsigned long) snapshot.max_mix_us, AUDIO_BLOCK_FRAMES,
+                     (unsigned long) snapshot.avg_latency_us, (unsigned long) snapshot.max_latency_us,
+                     (unsigned long) snapshot.triggers, (unsigned long) snapshot.dropped);
+        }
+    }
+
+    xSemaphoreGive(audio_stopped);
+    vTaskDelete(NULL);
+}
+
+// Public API implementation
+
+esp_err_t init_audio(void) {
+    if (audio_initialized) {
+        ESP_LOGW(TAG, "Audio already initialized");
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "Synthesizing %d sound effects", AUDIO_SFX_COUNT);
+    for (int s = 0; s < AUDIO_SFX_COUNT; s++) {
+        esp_err_t ret = synthesize_sfx((audio_sfx_t) s);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to synthesize effect %d", s);
+            return ret;
+        }
+    }
+
+    out_buffer = heap_caps_malloc(AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS * sizeof(int16_t),
+                                  MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    audio_stopped = xSemaphoreCreateBinary();
+    if (!out_buffer || !audio_stopped) {
+        ESP_LOGE(TAG, "Failed to allocate mixer buffers");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = backend_open();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    audio_running = true;
+    if (xTaskCreatePinnedToCore(audio_task, "audio_mix", AUDIO_TASK_STACK, NULL, AUDIO_TASK_PRIORITY,
+                                &audio_task_handle, tskNO_AFFINITY) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create mixer task");
+        audio_running = false;
+        backend_close();
+        return ESP_FAIL;
+    }
+
+    audio_initialized = true;
+    ESP_LOGI(TAG, "Audio mixer initialized: %d voices, %d us per block", AUDIO_MAX_VOICES, AUDIO_BLOCK_US);
+    return ESP_OK;
+}
+
+bool is_audio_available(void) {
+    return audio_initialized;
+}
+
+void cleanup_audio(void) {
+    if (!audio_initialized) return;
+
+    audio_running = false;
+    xSemaphoreTake(audio_stopped, portMAX_DELAY);
+    backend_close();
+
+    for (int s = 0; s < AUDIO_SFX_COUNT; s++) {
+        heap_caps_free(sfx_pcm[s].data);
+        sfx_pcm[s].data = NULL;
+    }
+    heap_caps_free(out_buffer);
+    out_buffer = NULL;
+    vSemaphoreDelete(audio_stopped);
+    audio_stopped = NULL;
+    audio_task_handle = NULL;
+    audio_initialized = false;
+    ESP_LOGI(TAG, "Audio cleanup completed");
+}
+
+void audio_play(audio_sfx_t sfx) {
+    if (!audio_initialized || sfx >= AUDIO_SFX_COUNT) return;
+
+    unsigned head = atomic_load_explicit(&cmd_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&cmd_tail, memory_order_acquire);
+    if (head - tail >= AUDIO_CMD_RING_SIZE) {
+        atomic_fetch_add_explicit(&cmd_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    audio_cmd_t *cmd = &cmd_ring[head & (AUDIO_CMD_RING_SIZE - 1)];
+    cmd->sfx = (uint8_t) sfx;
+    cmd->trigger_us = (uint32_t) esp_timer_get_time();
+    atomic_store_explicit(&cmd_head, head + 1, memory_order_release);
+}
+
+void audio_set_volume(uint8_t volume) {
+    atomic_store_explicit(&master_volume, volume, memory_order_relaxed);
+}
+
+void audio_get_stats(audio_stats_t *out) {
+    taskENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    out->avg_mix_us = stats.blocks ? (uint32_t) (total_mix_us / stats.blocks) : 0;
+    out->avg_latency_us = stats.triggers ? (uint32_t) (total_latency_us / stats.triggers) : 0;
+    taskEXIT_CRITICAL(&stats_lock);
+    out->dropped = atomic_load_explicit(&cmd_dropped, memory_order_relaxed);
+}
+
+#else  // !CONFIG_FRUITLAND_AUDIO
+
+// Stub implementations for when audio is disabled
+esp_err_t init_audio(void) {
+    ESP_LOGW(TAG, "Audio is disabled in configuration");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool is_audio_available(void) {
+    return false;
+}
+
+void cleanup_audio(void) {
+    // No-op when audio is disabled
+}
+
+void audio_play(audio_sfx_t sfx) {
+    // No-op when audio is disabled
+}
+
+void audio_set_volume(uint8_t volume) {
+    // No-op when audio is disabled
+}
+
+void audio_get_stats(audio_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+#endif  // CONFIG_FRUITLAND_AUDIO
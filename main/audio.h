@@ -0,0 +1,84 @@
+/**
+ * @file audio.h
+ * @brief Sound effect mixer for ESP32-Fruitland
+ *
+ * Effects are synthesized to PCM once at startup. The game thread triggers
+ * them through a lock-free single-producer command ring; a dedicated task
+ * mixes active voices in fixed point and feeds the output backend (board
+ * codec over I2S DMA, or a WAV capture for boards without audio hardware).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Available sound effects
+ */
+typedef enum {
+    AUDIO_SFX_FRUIT = 0,  // fruit collected
+    AUDIO_SFX_BONUS,      // bonus, time, life or freeze item collected
+    AUDIO_SFX_DEATH,      // player died
+    AUDIO_SFX_TELEPORT,   // teleporter used
+    AUDIO_SFX_FLIP,       // screen flip item collected
+    AUDIO_SFX_COUNT
+} audio_sfx_t;
+
+/**
+ * @brief Mixer statistics
+ */
+typedef struct {
+    uint32_t blocks;          // blocks mixed and handed to the backend
+    uint32_t triggers;        // effects started
+    uint32_t dropped;         // triggers lost because the command ring was full
+    uint32_t avg_mix_us;      // average time to mix one block
+    uint32_t max_mix_us;      // worst time to mix one block
+    uint32_t avg_latency_us;  // average trigger -> block hand-off latency
+    uint32_t max_latency_us;  // worst trigger -> block hand-off latency
+} audio_stats_t;
+
+/**
+ * @brief Synthesize the effects, open the backend and start the mixer task
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if audio is disabled
+ */
+esp_err_t init_audio(void);
+
+/**
+ * @brief Check if the mixer is running
+ */
+bool is_audio_available(void);
+
+/**
+ * @brief Stop the mixer task and release the backend
+ */
+void cleanup_audio(void);
+
+/**
+ * @brief Trigger a sound effect
+ *
+ * Lock-free and non-blocking; safe to call from the game loop. Must only be
+ * called from a single task (the game thread).
+ */
+void audio_play(audio_sfx_t sfx);
+
+/**
+ * @brief Set the master volume (0-255)
+ */
+void audio_set_volume(uint8_t volume);
+
+/**
+ * @brief Copy the mixer statistics
+ */
+void audio_get_stats(audio_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
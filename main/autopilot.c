@@ -0,0 +1,298 @@
+/**
+ * @file autopilot.c
+ * @brief Budgeted A* path planning for the autopilot player
+ *
+ * Search state is kept in per-cell arrays sized to the largest map seen and
+ * validated with a generation stamp, so a plan never clears the whole map.
+ * The heuristic is the Manhattan distance to the nearest of a few fruits
+ * closest to the player.
+ */
+
+#include "autopilot.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "autopilot";
+
+#define MAX_GOALS 8
+#define DIR_TELEPORT 5  // came_from code: arrived through the teleporter pair
+#define TELEPORT_COST 1000  // Above any walk: using the pair clears both, so fruit on this side goes first
+#define HEAP_SIZE (AUTOPILOT_MAX_EXPANSIONS * 4)
+
+typedef struct {
+    uint16_t f;
+    uint16_t cell;
+} open_entry_t;
+
+static const int8_t dir_dx[5] = {0, 0, 0, -1, 1};
+static const int8_t dir_dy[5] = {0, -1, 1, 0, 0};
+
+static uint16_t *g_cost;
+static uint16_t *seen_stamp;
+static uint16_t *closed_stamp;
+static uint8_t *came_from;
+static size_t capacity;
+static uint16_t stamp;
+
+static open_entry_t open_heap[HEAP_SIZE];
+static int open_count;
+
+static int goal_x[MAX_GOALS], goal_y[MAX_GOALS];
+static int goal_count;
+static int teleporters[2], teleporter_count;
+
+static autopilot_stats_t stats;
+
+static bool ensure_buffers(size_t cells) {
+    if (cells <= capacity) return true;
+    heap_caps_free(g_cost);
+    heap_caps_free(seen_stamp);
+    heap_caps_free(closed_stamp);
+    heap_caps_free(came_from);
+    g_cost = heap_caps_malloc(cells * sizeof(uint16_t), MALLOC_CAP_8BIT);
+    seen_stamp = heap_caps_calloc(cells, sizeof(uint16_t), MALLOC_CAP_8BIT);
+    closed_stamp = heap_caps_calloc(cells, sizeof(uint16_t), MALLOC_CAP_8BIT);
+    came_from = heap_caps_malloc(cells, MALLOC_CAP_8BIT);
+    if (!g_cost || !seen_stamp || !closed_stamp || !came_from) {
+        ESP_LOGE(TAG, "Failed to allocate search state for %u cells", (unsigned) cells);
+        capacity = 0;
+        return false;
+    }
+    capacity = cells;
+    stamp = 0;
+    return true;
+}
+
+static void heap_push(uint16_t f, uint16_t cell) {
+    if (open_count >= HEAP_SIZE) return; // Budget exceeded anyway
+    int i = open_count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (open_heap[parent].f <= f) break;
+        open_heap[i] = open_heap[parent];
+        i = parent;
+    }
+    open_heap[i] = (open_entry_t){f, cell};
+}
+
+static open_entry_t heap_pop(void) {
+    open_entry_t top = open_heap[0];
+    open_entry_t last = open_heap[--open_count];
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= open_count) break;
+        if (child + 1 < open_count && open_heap[child + 1].f < open_heap[child].f) child++;
+        if (open_heap[child].f >= last.f) break;
+        open_heap[i] = open_heap[child];
+        i = child;
+    }
+    open_heap[i] = last;
+    return top;
+}
+
+// Keep the few fruits nearest to the player as heuristic targets, and note the teleporter pair
+static void collect_goals(const autopilot_view_t *v) {
+    int goal_dist[MAX_GOALS];
+    goal_count = 0;
+    teleporter_count = 0;
+    for (int c = 0; c < v->width * v->height; c++) {
+        if (v->map[c] == 6 && teleporter_count < 2) teleporters[teleporter_count++] = c;
+        if (v->map[c] != 4) continue;
+        int x = c % v->width, y = c / v->width;
+        int d = abs(x - v->player_x) + abs(y - v->player_y);
+        int i = goal_count < MAX_GOALS ? goal_count++ : MAX_GOALS;
+        while (i > 0 && goal_dist[i - 1] > d) {
+            if (i < MAX_GOALS) {
+                goal_dist[i] = goal_dist[i - 1];
+                goal_x[i] = goal_x[i - 1];
+                goal_y[i] = goal_y[i - 1];
+            }
+            i--;
+        }
+        if (i < MAX_GOALS) {
+            goal_dist[i] = d;
+            goal_x[i] = x;
+            goal_y[i] = y;
+        }
+    }
+}
+
+static int heuristic(int x, int y) {
+    int best = 0xffff;
+    for (int i = 0; i < goal_count; i++) {
+        int d = abs(x - goal_x[i]) + abs(y - goal_y[i]);
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+// Extra cost of standing near an enemy; -1 on the enemy itself
+static int danger(const autopilot_view_t *v, int x, int y) {
+    int cost = 0;
+    for (int e = 0; e < v->enemies; e++) {
+        int d = abs(x - v->enemy_x[e]) + abs(y - v->enemy_y[e]);
+        if (d == 0) return -1;
+        if (d == 1) cost += 40;
+        else if (d == 2) cost += 12;
+        else if (d == 3) cost += 4;
+    }
+    return cost;
+}
+
+// Cost of stepping from (x, y) in direction dir, -1 if the move is not possible
+static int step_cost(const autopilot_view_t *v, int x, int y, int dir) {
+    int nx = x + dir_dx[dir], ny = y + dir_dy[dir];
+    if (nx < 0 || ny < 0 || nx >= v->width || ny >= v->height) return -1;
+
+    int base;
+    switch ((uint8_t) v->map[ny * v->width + nx]) {
+        case 0: case 1: case 4: case 5: case 7: case 9: case 10:
+            base = 1;
+            break;
+        case 6: // Teleporter moves the player somewhere unplanned
+            base = 20;
+            break;
+        case 8: // Screen flip turns the whole map over
+            base = 40;
+            break;
+        case 3: case 11: {
+            // Rock or stone block: passable only if the push rules allow it
+            bool rock = v->map[ny * v->width + nx] == 3;
+            int bx = nx + dir_dx[dir], by = ny + dir_dy[dir];
+            if (rock && dir == AUTOPILOT_DOWN) return -1;
+            if (bx < 0 || by < 0 || bx >= v->width || by >= v->height) return -1;
+            if (v->map[by * v->width + bx] != 0) return -1;
+            if (rock && dir_dy[dir] == 0 && by < v->height - 1 && v->map[(by + 1) * v->width + bx] == 0) {
+                return -1; // Rock would fall after a sideways push
+            }
+            base = 4;
+            break;
+        }
+        default:
+            return -1;
+    }
+
+    int d = danger(v, nx, ny);
+    return d < 0 ? -1 : base + d;
+}
+
+// Without a path: stay if safe, otherwise step to the least dangerous neighbour
+static int safest_step(const autopilot_view_t *v) {
+    int best_dir = AUTOPILOT_STAY;
+    int best = danger(v, v->player_x, v->player_y);
+    if (best == 0) return AUTOPILOT_STAY;
+    if (best < 0) best = 0xffff;
+    for (int dir = AUTOPILOT_UP; dir <= AUTOPILOT_RIGHT; dir++) {
+        int cost = step_cost(v, v->player_x, v->player_y, dir);
+        if (cost >= 0 && cost < best) {
+            best = cost;
+            best_dir = dir;
+        }
+    }
+    return best_dir;
+}
+
+static int plan(const autopilot_view_t *v) {
+    if (!ensure_buffers((size_t) v->width * v->height)) return AUTOPILOT_STAY;
+
+    collect_goals(v);
+    if (goal_count == 0) return safest_step(v);
+
+    if (++stamp == 0) {
+        // Generation counter wrapped: start clean
+        memset(seen_stamp, 0, capacity * sizeof(uint16_t));
+        memset(closed_stamp, 0, capacity * sizeof(uint16_t));
+        stamp = 1;
+    }
+
+    int start = v->player_y * v->width + v->player_x;
+    g_cost[start] = 0;
+    seen_stamp[start] = stamp;
+    open_count = 0;
+    heap_push(heuristic(v->player_x, v->player_y), start);
+
+    int goal = -1, best_cell = start, best_h = heuristic(v->player_x, v->player_y);
+    int expansions = 0;
+    while (open_count > 0) {
+        int c = heap_pop().cell;
+        if (closed_stamp[c] == stamp) continue;
+        closed_stamp[c] = stamp;
+
+        int x = c % v->width, y = c / v->width;
+        if (v->map[c] == 4) {
+            goal = c;
+            break;
+        }
+        if (++expansions > AUTOPILOT_MAX_EXPANSIONS) {
+            stats.budget_hits++;
+            break;
+        }
+        int h = heuristic(x, y);
+        if (h < best_h) {
+            best_h = h;
+            best_cell = c;
+        }
+
+        if (v->map[c] == 6 && teleporter_count == 2 && c != start && came_from[c] != DIR_TELEPORT) {
+            // Stepping on a teleporter lands on the other one; both turn to floor once used, so
+            // they are also walked through below
+            int n = c == teleporters[0] ? teleporters[1] : teleporters[0];
+            int d = danger(v, n % v->width, n / v->width);
+            int ng = g_cost[c] + TELEPORT_COST + d;
+            if (d >= 0 && ng <= 0xffff - 0x100 && closed_stamp[n] != stamp &&
+                (seen_stamp[n] != stamp || ng < g_cost[n])) {
+                g_cost[n] = ng;
+                came_from[n] = DIR_TELEPORT;
+                seen_stamp[n] = stamp;
+                int f = ng + heuristic(n % v->width, n / v->width);
+                heap_push(f > 0xffff ? 0xffff : f, n);
+            }
+        }
+
+        for (int dir = AUTOPILOT_UP; dir <= AUTOPILOT_RIGHT; dir++) {
+            int cost = step_cost(v, x, y, dir);
+            if (cost < 0) continue;
+            int n = c + dir_dy[dir] * v->width + dir_dx[dir];
+            int ng = g_cost[c] + cost;
+            if (closed_stamp[n] == stamp || (seen_stamp[n] == stamp && ng >= g_cost[n])) continue;
+            if (ng > 0xffff - 0x100) continue;
+            g_cost[n] = ng;
+            came_from[n] = dir;
+            seen_stamp[n] = stamp;
+            int f = ng + heuristic(n % v->width, n / v->width);
+            heap_push(f > 0xffff ? 0xffff : f, n);
+        }
+    }
+
+    int target = goal >= 0 ? goal : best_cell;
+    if (target == start) return safest_step(v);
+
+    // Walk back to the first step of the path
+    for (;;) {
+        int dir = came_from[target];
+        int prev = dir == DIR_TELEPORT ? (target == teleporters[0] ? teleporters[1] : teleporters[0])
+                                       : target - dir_dy[dir] * v->width - dir_dx[dir];
+        if (prev == start) return dir;
+        target = prev;
+    }
+}
+
+int autopilot_plan(const autopilot_view_t *view) {
+    uint64_t t0 = esp_timer_get_time();
+    int dir = plan(view);
+    uint32_t us = (uint32_t) (esp_timer_get_time() - t0);
+
+    stats.plans++;
+    stats.total_us += us;
+    if (us > stats.max_us) stats.max_us = us;
+    return dir;
+}
+
+void autopilot_get_stats(autopilot_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file autopilot.h
+ * @brief Autopilot player for attract mode and endurance runs
+ *
+ * Plans a path to the nearest fruit over the tile graph with A*. Cells near
+ * enemies cost more (danger map), cells holding an enemy are avoided, and
+ * rocks and the stone block are treated as passable when the push rules
+ * would allow the push. The teleporter pair links its two cells, at a cost
+ * above any walk since using it clears both. Each plan expands a bounded number of nodes, so its
+ * cost per tick is capped; when the budget runs out the autopilot heads for
+ * the most promising node found so far.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUTOPILOT_MAX_ENEMIES 4
+#define AUTOPILOT_MAX_EXPANSIONS 512
+
+// Direction codes, matching the game's UP/DOWN/LEFT/RIGHT
+enum {
+    AUTOPILOT_STAY = 0,
+    AUTOPILOT_UP = 1,
+    AUTOPILOT_DOWN = 2,
+    AUTOPILOT_LEFT = 3,
+    AUTOPILOT_RIGHT = 4,
+};
+
+typedef struct {
+    const char *map;
+    int width;
+    int height;
+    int player_x;
+    int player_y;
+    int enemy_x[AUTOPILOT_MAX_ENEMIES];
+    int enemy_y[AUTOPILOT_MAX_ENEMIES];
+    int enemies;
+} autopilot_view_t;
+
+typedef struct {
+    uint32_t plans;
+    uint32_t budget_hits;  // Plans that ran out of expansions
+    uint64_t total_us;
+    uint32_t max_us;
+} autopilot_stats_t;
+
+/**
+ * @brief Choose the next move for a player standing still on a tile
+ *
+ * @return AUTOPILOT_STAY or the direction to move
+ */
+int autopilot_plan(const autopilot_view_t *view);
+
+/**
+ * @brief Planning cost counters since boot
+ */
+void autopilot_get_stats(autopilot_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file band_render.c
+ * @brief Dirty band tracking, band composition and the band backend
+ */
+
+#include "band_render.h"
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "tile_cache.h"
+#include "sprite_rle.h"
+#include "particles.h"
+
+static const char *TAG = "band";
+
+#define MAX_BANDS 32
+#define MAX_HELD_SPRITES 24
+
+static band_render_config_t cfg;
+static uint16_t *band_buf;
+static int band_count;
+static band_render_stats_t stats;
+static int band_y0, band_lines;  // Band being composed
+
+// Sprites of the last frame, replayed while held
+static rcmd_t held[MAX_HELD_SPRITES];
+static int held_count;
+static bool holding;
+
+esp_err_t band_render_init(const band_render_config_t *config) {
+    band_render_free();
+    cfg = *config;
+    band_count = (cfg.height + BAND_LINES - 1) / BAND_LINES;
+    if (band_count > MAX_BANDS) {
+        ESP_LOGE(TAG, "%d lines need %d bands, at most %d", cfg.height, band_count, MAX_BANDS);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#ifdef CONFIG_FRUITLAND_PANEL_DIRECT
+    // Bands go to the panel's DMA as they are
+    band_buf = heap_caps_malloc(cfg.width * BAND_LINES * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+#else
+    band_buf = heap_caps_malloc(cfg.width * BAND_LINES * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#endif
+    if (!band_buf) {
+        ESP_LOGE(TAG, "Failed to allocate %dx%d band", cfg.width, BAND_LINES);
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "%d bands of %dx%d (%d bytes)", band_count, cfg.width, BAND_LINES,
+             (int) (cfg.width * BAND_LINES * sizeof(uint16_t)));
+    return ESP_OK;
+}
+
+void band_blit(int x, int y, int sx, int sy, int w, int h) {
+    // Clip to the band's rows and the frame's columns before touching the cache
+    int r0 = y < band_y0 ? band_y0 - y : 0;
+    int r1 = y + h > band_y0 + band_lines ? band_y0 + band_lines - y : h;
+    int c0 = x < 0 ? -x : 0;
+    int c1 = x + w > cfg.width ? cfg.width - x : w;
+    if (r0 >= r1 || c0 >= c1) return;
+
+    const uint16_t *cell = tile_cache_get(sx & ~(TILE_CACHE_CELL - 1), sy & ~(TILE_CACHE_CELL - 1));
+    if (!cell) return;
+    cell += (sy & (TILE_CACHE_CELL - 1)) * TILE_CACHE_CELL + (sx & (TILE_CACHE_CELL - 1));
+
+    uint16_t *dst = band_buf + (y + r0 - band_y0) * cfg.width + x + c0;
+    cell += r0 * TILE_CACHE_CELL + c0;
+    for (int r = r0; r < r1; r++, dst += cfg.width, cell += TILE_CACHE_CELL) {
+        memcpy(dst, cell, (c1 - c0) * sizeof(uint16_t));
+    }
+}
+
+static void mark_rows(bool *dirty, int y, int h) {
+    if (h <= 0) return;
+    int b0 = y < 0 ? 0 : y / BAND_LINES;
+    int b1 = (y + h - 1) / BAND_LINES;
+    for (int b = b0; b <= b1 && b < band_count; b++) {
+        dirty[b] = true;
+    }
+}
+
+static void draw_sprites(const rcmd_t *cmds, int count, int y0, int lines) {
+    // Command order; no blending, so the translucent ghost is left out
+    for (int i = 0; i < count; i++) {
+        const rcmd_t *c = &cmds[i];
+        if (c->type != RCMD_SPRITE || c->sprite.alpha < 255) continue;
+        if (c->y + 16 <= y0 || c->y >= y0 + lines) continue;
+        const sprite_rle_t *spr = sprite_rle_get(c->sprite.sx, c->sprite.sy);
+        const uint16_t *cell = tile_cache_get(c->sprite.sx, c->sprite.sy);
+        if (spr && cell) {
+            sprite_rle_draw(band_buf, cfg.width, lines, cfg.width, c->x, c->y - y0, spr, cell);
+        }
+    }
+}
+
+static void band_execute(const rcmd_t *cmds, int count) {
+    if (!band_buf) return;
+
+    if (!holding) {
+        held_count = 0;
+        for (int i = 0; i < count && held_count < MAX_HELD_SPRITES; i++) {
+            if (cmds[i].type == RCMD_SPRITE) held[held_count++] = cmds[i];
+        }
+    }
+
+    // Bands touched by this frame
+    bool dirty[MAX_BANDS] = {false};
+    bool particles = false;
+    for (int i = 0; i < count; i++) {
+        const rcmd_t *c = &cmds[i];
+        switch (c->type) {
+            case RCMD_LEVEL:
+                mark_rows(dirty, 0, cfg.height);
+                break;
+            case RCMD_TILE:
+                mark_rows(dirty, cfg.cell_y0 + c->y * 16, 16);
+                break;
+            case RCMD_ERASE:
+            case RCMD_SPRITE:
+                mark_rows(dirty, c->y, 16);
+                break;
+            case RCMD_RESTORE:
+                mark_rows(dirty, c->y, c->rect.h);
+                break;
+            case RCMD_PARTICLES:
+                mark_rows(dirty, c->y, c->rect.h);
+                particles = true;
+                break;
+            case RCMD_HUD:
+                mark_rows(dirty, cfg.hud_y, cfg.hud_h);
+                break;
+        }
+    }
+
+    for (int b = 0; b < band_count; b++) {
+        if (!dirty[b]) continue;
+        int y0 = b * BAND_LINES;
+        int lines = y0 + BAND_LINES > cfg.height ? cfg.height - y0 : BAND_LINES;
+
+        memset(band_buf, 0, cfg.width * lines * sizeof(uint16_t));
+        band_y0 = y0;
+        band_lines = lines;
+        cfg.compose(y0, lines);
+
+        if (holding) {
+            draw_sprites(held, held_count, y0, lines);
+        } else {
+            draw_sprites(cmds, count, y0, lines);
+        }
+
+        if (particles) {
+            particles_set_origin(0, y0);
+            particles_draw_rgb565(band_buf, cfg.width, cfg.width, lines);
+            particles_set_origin(0, 0);
+        }
+
+        cfg.present(band_buf, y0, lines);
+        stats.bands++;
+    }
+    stats.frames++;
+}
+
+const rcmd_backend_t band_render_backend = {
+    .name = "band",
+    .execute = band_execute,
+};
+
+void band_render_hold_sprites(bool hold) {
+    holding = hold;
+}
+
+void band_render_get_stats(band_render_stats_t *out) {
+    *out = stats;
+}
+
+void band_render_free(void) {
+    heap_caps_free(band_buf);
+    band_buf = NULL;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file band_render.h
+ * @brief Band compositor for boards without PSRAM
+ *
+ * Instead of keeping a full game surface, a frame is composed in horizontal
+ * bands of a few lines in one small internal RAM buffer. Each band is built
+ * from scratch (static content from a callback, then the frame's sprites and
+ * particles) and handed to a present callback before the next band reuses
+ * the buffer. Only bands touched by the frame's render commands are redrawn.
+ *
+ * This relies on the frame emitter listing every visible sprite in every
+ * rendered frame, which it does: erase commands only mark the old position.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "render_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_FRUITLAND_BAND_LINES
+#define BAND_LINES CONFIG_FRUITLAND_BAND_LINES
+#else
+#define BAND_LINES 16
+#endif
+
+/**
+ * @brief Draw everything that is not a sprite or particle into the current band with band_blit()
+ *
+ * @param y0     Frame row of the band's first line; the band starts cleared to black
+ * @param lines  Lines in this band (the last band may be shorter)
+ */
+typedef void (*band_compose_fn)(int y0, int lines);
+
+/**
+ * @brief Send a finished band to the display
+ *
+ * The band is recomposed before the buffer is reused, so the callback may modify it.
+ */
+typedef void (*band_present_fn)(uint16_t *band, int y0, int lines);
+
+typedef struct {
+    int width, height;           // frame size in pixels
+    int cell_y0;                 // frame row of level cell row 0, for RCMD_TILE
+    int hud_y, hud_h;            // rows redrawn for RCMD_HUD
+    band_compose_fn compose;
+    band_present_fn present;
+} band_render_config_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t bands;  // bands composed and presented
+} band_render_stats_t;
+
+/**
+ * @brief Render command backend that composes dirty bands
+ */
+extern const rcmd_backend_t band_render_backend;
+
+/**
+ * @brief Allocate the band buffer
+ *
+ * @return ESP_OK, or ESP_ERR_NO_MEM
+ */
+esp_err_t band_render_init(const band_render_config_t *config);
+
+/**
+ * @brief Copy a rectangle of one atlas cell through the tile cache, clipped to the band being composed
+ *
+ * Only valid inside the compose callback. The rectangle (sx, sy, w, h) must
+ * lie inside a single 16x16 cell.
+ */
+void band_blit(int x, int y, int sx, int sy, int w, int h);
+
+/**
+ * @brief Keep drawing the last frame's sprites in the frames that follow
+ *
+ * For sequences that redraw the playfield without going through the frame
+ * emitter (the death effect), so the frozen objects stay visible.
+ */
+void band_render_hold_sprites(bool hold);
+
+void band_render_get_stats(band_render_stats_t *out);
+
+void band_render_free(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file binlog.c
+ * @brief Lock-free record ring and the drain task that prints it
+ *
+ * The ring is a bounded multi-producer queue: a writer claims a slot with a
+ * compare-and-swap on the head counter and publishes it through the slot's
+ * sequence number, so writers never block each other or the drain task.
+ * Sequence numbers are stored relative to the slot index, which makes the
+ * zeroed ring valid before init_binlog() runs.
+ */
+
+#include "binlog.h"
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "binlog";
+
+#ifdef CONFIG_FRUITLAND_BINLOG
+
+#define RING_SIZE CONFIG_FRUITLAND_BINLOG_RECORDS
+#define RING_MASK (RING_SIZE - 1)
+#define BINLOG_TASK_STACK 3072
+#define BINLOG_TASK_PRIORITY 1  // Only runs when nothing else wants the CPU
+#define BINLOG_DRAIN_MS 20
+
+_Static_assert((RING_SIZE & RING_MASK) == 0, "CONFIG_FRUITLAND_BINLOG_RECORDS must be a power of two");
+
+typedef struct {
+    atomic_uint seq;  // minus the slot index
+    const binlog_site_t *site;
+    uint32_t timestamp;
+    int32_t args[BINLOG_MAX_ARGS];
+} binlog_record_t;
+
+static binlog_record_t ring[RING_SIZE];
+static atomic_uint head;
+static uint32_t tail;  // Drain task only
+static atomic_uint written;
+static atomic_uint dropped;
+static TaskHandle_t binlog_task_handle;
+
+void binlog_write(const binlog_site_t *site, const int32_t *args) {
+    unsigned pos = atomic_load_explicit(&head, memory_order_relaxed);
+    binlog_record_t *rec;
+    for (;;) {
+        rec = &ring[pos & RING_MASK];
+        unsigned seq = atomic_load_explicit(&rec->seq, memory_order_acquire) + (pos & RING_MASK);
+        int diff = (int) (seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&head, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed); // Drain is a full lap behind
+            return;
+        } else {
+            pos = atomic_load_explicit(&head, memory_order_relaxed); // Another writer took this slot
+        }
+    }
+
+    rec->site = site;
+    rec->timestamp = esp_log_timestamp();
+    for (int i = 0; i < site->nargs; i++) {
+        rec->args[i] = args[i];
+    }
+    atomic_store_explicit(&rec->seq, pos + 1 - (pos & RING_MASK), memory_order_release);
+    atomic_fetch_add_explicit(&written, 1, memory_order_relaxed);
+}
+
+static void print_record(const binlog_site_t *site, uint32_t timestamp, const int32_t *a) {
+#ifdef CONFIG_FRUITLAND_BINLOG_RAW
+    // Hex words only; tools/binlog_decode.py resolves the site from the ELF
+    printf("BLOG %08lx %lu", (unsigned long) (uintptr_t) site, (unsigned long) timestamp);
+    for (int i = 0; i < site->nargs; i++) {
+        printf(" %lx", (unsigned long) (uint32_t) a[i]);
+    }
+    putchar('\n');
+#else
+    static const char letters[] = {'N', 'E', 'W', 'I', 'D', 'V'};
+    char msg[160];
+    // Every argument is one 32-bit word, so passing all slots matches any format
+    // on this ILP32 target; unused trailing arguments are ignored
+    snprintf(msg, sizeof(msg), site->fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+    esp_log_write((esp_log_level_t) site->level, site->tag, "%c (%lu) %s: %s\n",
+                  letters[site->level % sizeof(letters)], (unsigned long) timestamp, site->tag, msg);
+#endif
+}
+
+static void drain(void) {
+    for (;;) {
+        binlog_record_t *rec = &ring[tail & RING_MASK];
+        unsigned seq = atomic_load_explicit(&rec->seq, memory_order_acquire) + (tail & RING_MASK);
+        if (seq != tail + 1) return; // Empty, or the writer has not published yet
+
+        // Copy out and free the slot before the slow formatting
+        const binlog_site_t *site = rec->site;
+        uint32_t timestamp = rec->timestamp;
+        int32_t args[BINLOG_MAX_ARGS] = {0};
+        for (int i = 0; i < site->nargs; i++) {
+            args[i] = rec->args[i];
+        }
+        atomic_store_explicit(&rec->seq, tail + RING_SIZE - (tail & RING_MASK), memory_order_release);
+        tail++;
+
+        print_record(site, timestamp, args);
+    }
+}
+
+static void binlog_task(void *arg) {
+    uint32_t reported_drops = 0;
+    for (;;) {
+        drain();
+        uint32_t drops = atomic_load_explicit(&dropped, memory_order_relaxed);
+        if (drops != reported_drops) {
+            ESP_LOGW(TAG, "%lu records dropped (ring full)", (unsigned long) (drops - reported_drops));
+            reported_drops = drops;
+        }
+        vTaskDelay(pdMS_TO_TICKS(BINLOG_DRAIN_MS));
+    }
+}
+
+esp_err_t init_binlog(void) {
+    if (binlog_task_handle) return ESP_OK;
+    if (xTaskCreatePinnedToCore(binlog_task, "binlog", BINLOG_TASK_STACK, NULL, BINLOG_TASK_PRIORITY,
+                                &binlog_task_handle, tskNO_AFFINITY) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create drain task");
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "Binary logging: %d records%s", RING_SIZE,
+#ifdef CONFIG_FRUITLAND_BINLOG_RAW
+             ", raw output (decode with tools/binlog_decode.py)"
+#else
+             ""
+#endif
+    );
+    return ESP_OK;
+}
+
+void binlog_get_stats(binlog_stats_t *out) {
+    out->written = atomic_load_explicit(&written, memory_order_relaxed);
+    out->dropped = atomic_load_explicit(&dropped, memory_order_relaxed);
+}
+
+#else  // !CONFIG_FRUITLAND_BINLOG
+
+esp_err_t init_binlog(void) {
+    ESP_LOGD(TAG, "Binary logging disabled, hot-path logs are immediate");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void binlog_write(const binlog_site_t *site, const int32_t *args) {
+}
+
+void binlog_get_stats(binlog_stats_t *out) {
+    out->written = 0;
+    out->dropped = 0;
+}
+
+#endif  // CONFIG_FRUITLAND_BINLOG
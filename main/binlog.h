@@ -0,0 +1,105 @@
+/**
+ * @file binlog.h
+ * @brief Deferred binary logging for hot paths
+ *
+ * BINLOG_I(tag, fmt, ...) stores a pointer to a static call-site descriptor
+ * (tag, format, level, argument count), a timestamp and the raw argument
+ * words in a lock-free ring. A low-priority task formats and prints the
+ * records later, so the game thread pays a few dozen cycles instead of a
+ * printf and synchronous UART I/O.
+ *
+ * Arguments are 32-bit integers (%d, %u, %x, %c and their width and flag
+ * variants), at most BINLOG_MAX_ARGS of them. Strings must be literals or
+ * other static data, passed through BINLOG_STR(). With
+ * CONFIG_FRUITLAND_BINLOG_RAW the task prints records as hex and
+ * tools/binlog_decode.py formats them on the host from the firmware ELF.
+ * With CONFIG_FRUITLAND_BINLOG off the macros are plain ESP_LOGx calls.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BINLOG_MAX_ARGS 6
+
+/**
+ * @brief Static description of one log call site, kept in flash
+ *
+ * Layout is read by tools/binlog_decode.py; keep the two in step.
+ */
+typedef struct {
+    const char *tag;
+    const char *fmt;
+    uint8_t level;  // esp_log_level_t
+    uint8_t nargs;
+} binlog_site_t;
+
+/**
+ * @brief Drain statistics
+ */
+typedef struct {
+    uint32_t written;  // records accepted by the ring
+    uint32_t dropped;  // records lost because the ring was full
+} binlog_stats_t;
+
+/**
+ * @brief Start the drain task
+ *
+ * Records written before this call are kept and printed once it runs.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if binary logging is disabled
+ */
+esp_err_t init_binlog(void);
+
+/**
+ * @brief Append one record; drops it if the ring is full
+ */
+void binlog_write(const binlog_site_t *site, const int32_t *args);
+
+/**
+ * @brief Read the ring counters
+ */
+void binlog_get_stats(binlog_stats_t *out);
+
+#ifdef CONFIG_FRUITLAND_BINLOG
+
+#define BINLOG_STR(s) ((int32_t) (intptr_t) (s))
+
+#define BINLOG_NARGS(...) BINLOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+
+#define BINLOG_AT(level_, tag_, fmt_, ...)                                                           \
+    do {                                                                                             \
+        _Static_assert(BINLOG_NARGS(__VA_ARGS__) <= BINLOG_MAX_ARGS, "too many binlog arguments");   \
+        static const binlog_site_t binlog_site_ = {tag_, fmt_, level_, BINLOG_NARGS(__VA_ARGS__)};   \
+        if (LOG_LOCAL_LEVEL >= (level_)) {                                                           \
+            binlog_write(&binlog_site_, (const int32_t[]){0, ##__VA_ARGS__} + 1);                     \
+        }                                                                                            \
+    } while (0)
+
+#define BINLOG_E(tag, fmt, ...) BINLOG_AT(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define BINLOG_W(tag, fmt, ...) BINLOG_AT(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define BINLOG_I(tag, fmt, ...) BINLOG_AT(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#define BINLOG_D(tag, fmt, ...) BINLOG_AT(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+
+#else  // !CONFIG_FRUITLAND_BINLOG
+
+#define BINLOG_STR(s) (s)
+
+#define BINLOG_E(tag, fmt, ...) ESP_LOGE(tag, fmt, ##__VA_ARGS__)
+#define BINLOG_W(tag, fmt, ...) ESP_LOGW(tag, fmt, ##__VA_ARGS__)
+#define BINLOG_I(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#define BINLOG_D(tag, fmt, ...) ESP_LOGD(tag, fmt, ##__VA_ARGS__)
+
+#endif  // CONFIG_FRUITLAND_BINLOG
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,252 @@
+/**
+ * @file fov.c
+ * @brief Recursive shadowcasting and visibility diffing for the fog of war
+ *
+ * Two visibility buffers alternate: the new result is cast into the older
+ * one after clearing only the box it last lit, then compared with the
+ * previous result over the union of both boxes. Recompute cost is bounded
+ * by the sight radius, not the map size.
+ */
+
+#include "fov.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "fov";
+
+#ifdef CONFIG_FRUITLAND_FOG_OF_WAR
+
+typedef struct {
+    int x0, y0, x1, y1;  // Inclusive; empty when x0 > x1
+} fov_box_t;
+
+static const char *map_tiles;
+static int map_w, map_h;
+static uint8_t *vis[2];
+static fov_box_t vis_box[2];
+static int current;  // Index of the buffer holding the latest result
+static size_t vis_capacity;
+
+// Octant transforms for the shadowcaster
+static const int8_t octants[8][4] = {
+    {1, 0, 0, 1}, {0, 1, 1, 0}, {0, -1, 1, 0}, {-1, 0, 0, 1},
+    {-1, 0, 0, -1}, {0, -1, -1, 0}, {0, 1, -1, 0}, {1, 0, 0, -1},
+};
+
+static bool is_opaque(int x, int y) {
+    if (x < 0 || y < 0 || x >= map_w || y >= map_h) return true;
+    switch ((uint8_t) map_tiles[y * map_w + x]) {
+        case 2:   // Wall
+        case 3:   // Rock
+        case 11:  // Block
+        case 80:  // Rock leaving a tile
+        case 255: // Tile reserved by a moving rock
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void box_add(fov_box_t *box, int x, int y) {
+    if (x < box->x0) box->x0 = x;
+    if (y < box->y0) box->y0 = y;
+    if (x > box->x1) box->x1 = x;
+    if (y > box->y1) box->y1 = y;
+}
+
+static void light(uint8_t *out, fov_box_t *box, int x, int y) {
+    if (x < 0 || y < 0 || x >= map_w || y >= map_h) return;
+    out[y * map_w + x] = 1;
+    box_add(box, x, y);
+}
+
+// One octant of recursive shadowcasting; slopes run from start down to end
+static void cast_light(uint8_t *out, fov_box_t *box, int cx, int cy, int row, float start, float end,
+                       const int8_t *t) {
+    if (start < end) return;
+    const int r2 = FOV_RADIUS * FOV_RADIUS;
+    float new_start = 0.0f;
+
+    for (int j = row; j <= FOV_RADIUS; j++) {
+        int dy = -j;
+        bool blocked = false;
+        for (int dx = -j; dx <= 0; dx++) {
+            float l_slope = (dx - 0.5f) / (dy + 0.5f);
+            float r_slope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < r_slope) continue;
+            if (end > l_slope) break;
+
+            int x = cx + dx * t[0] + dy * t[1];
+            int y = cy + dx * t[2] + dy * t[3];
+            if (dx * dx + dy * dy <= r2) {
+                light(out, box, x, y);
+            }
+
+            bool opaque = is_opaque(x, y);
+            if (blocked) {
+                if (opaque) {
+                    new_start = r_slope;
+                } else {
+                    blocked = false;
+                    start = new_start;
+                }
+            } else if (opaque && j < FOV_RADIUS) {
+                blocked = true;
+                cast_light(out, box, cx, cy, j + 1, start, l_slope, t);
+                new_start = r_slope;
+            }
+        }
+        if (blocked) break;
+    }
+}
+
+esp_err_t fov_set_map(const char *map, int width, int height) {
+    size_t cells = (size_t) width * height;
+    if (cells > vis_capacity) {
+        for (int i = 0; i < 2; i++) {
+            heap_caps_free(vis[i]);
+            vis[i] = heap_caps_malloc(cells, MALLOC_CAP_8BIT);
+        }
+        if (!vis[0] || !vis[1]) {
+            ESP_LOGE(TAG, "Failed to allocate visibility for %dx%d", width, height);
+            heap_caps_free(vis[0]);
+            heap_caps_free(vis[1]);
+            vis[0] = vis[1] = NULL;
+            vis_capacity = 0;
+            map_tiles = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+        vis_capacity = cells;
+    }
+
+    map_tiles = map;
+    map_w = width;
+    map_h = height;
+    memset(vis[0], 0, cells);
+    memset(vis[1], 0, cells);
+    vis_box[0] = vis_box[1] = (fov_box_t){0, 0, -1, -1};
+    current = 0;
+    return ESP_OK;
+}
+
+bool fov_is_enabled(void) {
+    return map_tiles != NULL;
+}
+
+bool fov_is_visible(int x, int y) {
+    if (!map_tiles) return true;
+    return vis[current][y * map_w + x] != 0;
+}
+
+int fov_update(const int *viewer_x, const int *viewer_y, int viewers, fov_flip_fn on_flip) {
+    if (!map_tiles) return 0;
+
+    // Cast into the older buffer after clearing what it last lit
+    int next = current ^ 1;
+    uint8_t *out = vis[next];
+    fov_box_t *box = &vis_box[next];
+    for (int y = box->y0; y <= box->y1; y++) {
+        memset(&out[y * map_w + box->x0], 0, box->x1 - box->x0 + 1);
+    }
+    *box = (fov_box_t){map_w, map_h, -1, -1};
+
+    for (int v = 0; v < viewers && v < FOV_MAX_VIEWERS; v++) {
+        light(out, box, viewer_x[v], viewer_y[v]);
+        for (int o = 0; o < 8; o++) {
+            cast_light(out, box, viewer_x[v], viewer_y[v], 1, 1.0f, 0.0f, octants[o]);
+        }
+    }
+
+    // Diff against the previous result where either could be lit
+    const uint8_t *prev = vis[current];
+    fov_box_t area = vis_box[current];
+    if (area.x0 > area.x1) {
+        area = *box;
+    } else if (box->x0 <= box->x1) {
+        box_add(&area, box->x0, box->y0);
+        box_add(&area, box->x1, box->y1);
+    }
+    current = next;
+
+    int flips = 0;
+    for (int y = area.y0; y <= area.y1; y++) {
+        for (int x = area.x0; x <= area.x1; x++) {
+            int c = y * map_w + x;
+            if (out[c] != prev[c]) {
+                flips++;
+                if (on_flip) on_flip(x, y, out[c] != 0);
+            }
+        }
+    }
+    return flips;
+}
+
+void fov_benchmark(void) {
+    const int w = 64, h = 64, iterations = 500;
+    char *map = heap_caps_malloc(w * h, MALLOC_CAP_8BIT);
+    if (!map) {
+        ESP_LOGE(TAG, "Benchmark: failed to allocate map");
+        return;
+    }
+
+    const char *saved_map = map_tiles;
+    int saved_w = map_w, saved_h = map_h;
+
+    // Open field (worst case for the caster) and a field with 1 in 4 cells walled
+    for (int walled = 0; walled <= 1; walled++) {
+        uint32_t seed = 1;
+        for (int c = 0; c < w * h; c++) {
+            seed = seed * 1103515245 + 12345;
+            map[c] = (walled && ((seed >> 16) & 3) == 0) ? 2 : 1;
+        }
+        if (fov_set_map(map, w, h) != ESP_OK) break;
+
+        // Walk a viewer across the map so every update moves by one tile
+        int flips = 0;
+        uint64_t t0 = esp_timer_get_time();
+        for (int i = 0; i < iterations; i++) {
+            int x = 8 + i % (w - 16), y = 8 + (i / (w - 16)) % (h - 16);
+            flips += fov_update(&x, &y, 1, NULL);
+        }
+        uint64_t t1 = esp_timer_get_time();
+
+        ESP_LOGI(TAG, "📊 BENCH %s %dx%d, radius %d: recompute+diff=%llu us, %d flipped cells per step",
+                 walled ? "walled" : "open", w, h, FOV_RADIUS, (unsigned long long) ((t1 - t0) / iterations),
+                 flips / iterations);
+    }
+
+    heap_caps_free(map);
+    if (saved_map) {
+        fov_set_map(saved_map, saved_w, saved_h);
+    } else {
+        map_tiles = NULL;
+    }
+}
+
+#else  // !CONFIG_FRUITLAND_FOG_OF_WAR
+
+esp_err_t fov_set_map(const char *map, int width, int height) {
+    return ESP_OK;
+}
+
+bool fov_is_enabled(void) {
+    return false;
+}
+
+bool fov_is_visible(int x, int y) {
+    return true;
+}
+
+int fov_update(const int *viewer_x, const int *viewer_y, int viewers, fov_flip_fn on_flip) {
+    return 0;
+}
+
+void fov_benchmark(void) {
+    ESP_LOGI(TAG, "Fog of war disabled");
+}
+
+#endif  // CONFIG_FRUITLAND_FOG_OF_WAR
@@ -0,0 +1,59 @@
+/**
+ * @file fov.h
+ * @brief Fog-of-war visibility with recursive shadowcasting
+ *
+ * Visibility is recomputed only when the caller asks for it (a viewer
+ * changed tile or a sight-blocking tile moved). Each recompute is diffed
+ * against the previous one over the area either could have lit, and only
+ * cells whose visibility flipped are reported for redraw.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FOV_RADIUS 6  // Sight radius in tiles
+#define FOV_MAX_VIEWERS 2
+
+/**
+ * @brief Called for every cell whose visibility changed
+ */
+typedef void (*fov_flip_fn)(int x, int y, bool visible);
+
+/**
+ * @brief Set the map (not copied) and hide every cell
+ */
+esp_err_t fov_set_map(const char *map, int width, int height);
+
+/**
+ * @brief Check if fog of war is active for the current map
+ */
+bool fov_is_enabled(void);
+
+/**
+ * @brief Check if a cell is currently visible (always true when fog is off)
+ */
+bool fov_is_visible(int x, int y);
+
+/**
+ * @brief Recompute visibility from the viewers and report flipped cells
+ *
+ * @return number of cells whose visibility flipped
+ */
+int fov_update(const int *viewer_x, const int *viewer_y, int viewers, fov_flip_fn on_flip);
+
+/**
+ * @brief Log the cost of a recompute and diff on open and walled maps
+ */
+void fov_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
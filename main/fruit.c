@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <pthread.h>
 #include "SDL3/SDL.h"
 #include "SDL3/SDL_hints.h"
@@ -18,9 +19,30 @@
 #include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_random.h"
 #include "filesystem.h"
 #include "keyboard.h"
 #include "accelerometer.h"
+#include "persist.h"
+#include "audio.h"
+#include "particles.h"
+#include "tile_anim.h"
+#include "screen_fx.h"
+#include "scroll.h"
+#include "ghost.h"
+#include "levelgen.h"
+#include "fov.h"
+#include "autopilot.h"
+#include "state_trace.h"
+#include "binlog.h"
+#include "render_cmd.h"
+#include "sprite_rle.h"
+#include "tile_cache.h"
+#include "band_render.h"
+#include "native_render.h"
+#include "panel_out.h"
+#include "intro_stream.h"
+#include "qemu_smoke.h"
 #ifdef CONFIG_IDF_TARGET_ESP32P4
 #include "SDL3/SDL_esp-idf.h"  // For PPA hardware scaling
 #include "driver/ppa.h"         // Hardware acceleration
@@ -31,11 +53,25 @@
 #define GAME_WIDTH 256
 #define GAME_HEIGHT 224
 #define SPRITE_SIZE 16
-#define LEVEL_WIDTH 15
+#define LEVEL_WIDTH 15   // Stored level size, also the visible playfield in tiles
 #define LEVEL_HEIGHT 11
+#define MAX_LEVEL_WIDTH 128  // Largest scrolling map
+#define MAX_LEVEL_HEIGHT 128
+#define STORED_LEVELS 25 // Levels in fruit.dat
+#ifdef CONFIG_FRUITLAND_ENDLESS_MODE
+#define LAST_LEVEL INT_MAX // Generated levels follow the stored ones
+#else
+#define LAST_LEVEL STORED_LEVELS
+#endif
+#define WORLD_COLUMNS 5  // Stored levels per row when stitched into one world
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+#define MAX_OBJECTS 17
+#define PLAYER2 16  // Second player object
+#else
 #define MAX_OBJECTS 16
-#define HI_ENTRIES 8
-#define NAME_LENGTH 9
+#endif
+#define HI_ENTRIES PERSIST_HI_ENTRIES
+#define NAME_LENGTH PERSIST_NAME_LENGTH
 
 // Performance constants - tile-based movement system
 #ifdef CONFIG_IDF_TARGET_ESP32P4
@@ -99,9 +135,22 @@ typedef struct OBJECT {
 // Global game state
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
-static SDL_Texture *intro_texture = NULL;
 static SDL_Texture *patterns_texture = NULL;
 static SDL_Texture *game_surface = NULL;
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+static SDL_Texture *band_texture = NULL; // Low-memory mode: one band, uploaded and drawn per composed band
+#endif
+#ifdef CONFIG_FRUITLAND_NATIVE_SCALE
+static SDL_Texture *native_texture = NULL; // Frame composed at panel scale, drawn 1:1
+static int native_scale = 0; // 0 until the native-scale compositor is set up
+static bool native_rotated = false; // Frame composed turned for a portrait panel
+#endif
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+#define HUD_Y 192   // First game surface row of the HUD
+#define HUD_ROWS 16
+static SDL_Texture *hud_plane = NULL; // HUD rows at an integer scale, drawn 1:1 below the playfield
+static int hud_scale = 1;
+#endif
 
 // High-performance streaming buffers
 static SDL_Texture *render_line_buffer = NULL; // Small streaming buffer
@@ -111,14 +160,11 @@ static bool skip_next_clear = false; // Skip redundant clears
 
 // Game data
 static char levels[4736]; // storage space for 25 levels
-static char level_data[LEVEL_WIDTH * LEVEL_HEIGHT];
+static char level_data[MAX_LEVEL_WIDTH * MAX_LEVEL_HEIGHT];
+static int level_width = LEVEL_WIDTH;  // Current map size in tiles
+static int level_height = LEVEL_HEIGHT;
 static OBJECT objects[MAX_OBJECTS];
-// High scores (simplified for embedded version)
-// static int hi_scores[HI_ENTRIES] = {100000,90000,80000,70000,60000,50000,30000,100};
-// static char hi_names[HI_ENTRIES][NAME_LENGTH] = {
-//     "ARJAN   ","ERWIN   ","KARIN   ","ADDY    ",
-//     "GERRY   ","BAS     ","TOM     ","LAURENS "
-// };
+// High scores, unlocked levels and settings are cached and persisted by persist.c
 
 // Game variables
 static int av_time;
@@ -127,8 +173,19 @@ static int level;
 static int lives;
 static int fruit;
 static int dead;
+static int dead_player; // Object index of the player that died
+static int player_count = 1;
+static bool autopilot_mode; // Attract/endurance mode: the autopilot holds the controls
+static int start_level = 1; // Level a new game starts at, picked on the intro screen
+static const rcmd_backend_t *render_backend = &rcmd_null_backend; // Set by select_render_backend()
+
+// Time-trial ghost replaying the best run of the current level
+static bool ghost_visible;
+static int ghost_x, ghost_y;
+static int ghost_sy = 48;
 static int freeze_enemy;
 static int level_change_requested = 0; // Flag to track F2/F3 level changes
+static uint8_t sfx_volume = 192; // Master volume, loaded from the saved settings
 static int game_running = 1;
 
 #ifdef CONFIG_IDF_TARGET_ESP32P4
@@ -144,6 +201,7 @@ static esp_lcd_panel_handle_t lcd_panel = NULL;
 static TaskHandle_t draw_task_handle = NULL;
 static SemaphoreHandle_t fb_mutex = NULL;
 static volatile bool fb_ready = false;
+static const uint16_t *fb_fx_lut = NULL; // Colour effect LUT for scan-out, guarded by fb_mutex
 #endif
 
 // Performance tracking
@@ -162,18 +220,21 @@ static uint64_t fps_frame_count = 0;
 static const bool *keyboard_state;
 
 // Forward declarations
-void print_stats(void);
 
-void get_item(void);
+void get_item(int p);
 
 bool is_passable(int tile_type);
 
-void teleport(void);
+void teleport(int p);
+
+void print_hiscores(void);
 
-void turn_screen(void);
+void turn_screen(int p);
 
 void render_frame_minimal(void);
 
+void redraw_level_region(const SDL_Rect *rect);
+
 void update_character_animation(OBJECT *obj, bool is_moving);
 
 // Rock and gravity system
@@ -346,77 +407,114 @@ void update_character_animation(OBJECT *obj, bool is_moving) {
     }
 }
 
+// Direction key state for player p: alone, arrows and WASD both work; in two-player
+// mode player 1 uses the arrows and player 2 WASD
+bool player_key(int p, int dir) {
+    bool arrows = (p == 0);
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    bool wasd = (p == PLAYER2 || player_count == 1);
+#else
+    bool wasd = true;
+#endif
+    switch (dir) {
+        case UP: return (arrows && keyboard_state[SDL_SCANCODE_UP]) || (wasd && keyboard_state[SDL_SCANCODE_W]);
+        case DOWN: return (arrows && keyboard_state[SDL_SCANCODE_DOWN]) || (wasd && keyboard_state[SDL_SCANCODE_S]);
+        case LEFT: return (arrows && keyboard_state[SDL_SCANCODE_LEFT]) || (wasd && keyboard_state[SDL_SCANCODE_A]);
+        case RIGHT: return (arrows && keyboard_state[SDL_SCANCODE_RIGHT]) || (wasd && keyboard_state[SDL_SCANCODE_D]);
+        default: return false;
+    }
+}
+
+// Check if any player stands on tile (dx, dy)
+bool is_player_at(int dx, int dy) {
+    if (objects[0].l && objects[0].dx == dx && objects[0].dy == dy) return true;
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    return player_count == 2 && objects[PLAYER2].l && objects[PLAYER2].dx == dx && objects[PLAYER2].dy == dy;
+#else
+    return false;
+#endif
+}
+
+// Check if object i is a player
+static inline bool is_player_object(int i) {
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    return i == 0 || i == PLAYER2;
+#else
+    return i == 0;
+#endif
+}
+
 // Update player position with continuous smooth movement
-void update_player_position() {
-    if (!objects[0].is_moving) {
+void update_player_position(int p) {
+    if (!objects[p].is_moving) {
         // Not moving, but still update idle animation
-        update_character_animation(&objects[0], false); // Moving = false
+        update_character_animation(&objects[p], false); // Moving = false
         return;
     }
 
     uint64_t current_time = get_time_us();
-    float progress = interpolate_movement(objects[0].movement_start_time, current_time);
+    float progress = interpolate_movement(objects[p].movement_start_time, current_time);
 
     if (progress >= 1.0f) {
         // Movement to current target completed
-        objects[0].x = objects[0].target_x;
-        objects[0].y = objects[0].target_y;
-        objects[0].dx = objects[0].target_dx;
-        objects[0].dy = objects[0].target_dy;
+        objects[p].x = objects[p].target_x;
+        objects[p].y = objects[p].target_y;
+        objects[p].dx = objects[p].target_dx;
+        objects[p].dy = objects[p].target_dy;
 
         // Handle item collection at destination
-        get_item();
+        get_item(p);
 
         // Check if we should continue moving in the same direction
         bool continue_movement = false;
-        int next_target_dx = objects[0].dx;
-        int next_target_dy = objects[0].dy;
+        int next_target_dx = objects[p].dx;
+        int next_target_dy = objects[p].dy;
 
         // Check if the same direction key is still pressed and next tile is passable
-        if (objects[0].dir == UP && keyboard_state[SDL_SCANCODE_UP] && objects[0].dy > 0) {
-            next_target_dy = objects[0].dy - 1;
+        if (objects[p].dir == UP && player_key(p, UP) && objects[p].dy > 0) {
+            next_target_dy = objects[p].dy - 1;
             continue_movement = true;
-        } else if (objects[0].dir == DOWN && keyboard_state[SDL_SCANCODE_DOWN] && objects[0].dy < LEVEL_HEIGHT - 1) {
-            next_target_dy = objects[0].dy + 1;
+        } else if (objects[p].dir == DOWN && player_key(p, DOWN) && objects[p].dy < level_height - 1) {
+            next_target_dy = objects[p].dy + 1;
             continue_movement = true;
-        } else if (objects[0].dir == LEFT && keyboard_state[SDL_SCANCODE_LEFT] && objects[0].dx > 0) {
-            next_target_dx = objects[0].dx - 1;
+        } else if (objects[p].dir == LEFT && player_key(p, LEFT) && objects[p].dx > 0) {
+            next_target_dx = objects[p].dx - 1;
             continue_movement = true;
-        } else if (objects[0].dir == RIGHT && keyboard_state[SDL_SCANCODE_RIGHT] && objects[0].dx < LEVEL_WIDTH - 1) {
-            next_target_dx = objects[0].dx + 1;
+        } else if (objects[p].dir == RIGHT && player_key(p, RIGHT) && objects[p].dx < level_width - 1) {
+            next_target_dx = objects[p].dx + 1;
             continue_movement = true;
         }
 
         if (continue_movement) {
             // Check if next tile is passable
-            int next_tile = level_data[next_target_dx + next_target_dy * LEVEL_WIDTH];
+            int next_tile = level_data[next_target_dx + next_target_dy * level_width];
             if (is_passable(next_tile)) {
                 // Continue smooth movement to next tile
-                objects[0].target_dx = next_target_dx;
-                objects[0].target_dy = next_target_dy;
-                objects[0].start_x = objects[0].x;
-                objects[0].start_y = objects[0].y;
-                objects[0].target_x = next_target_dx * 16 + 8;
-                objects[0].target_y = next_target_dy * 16 + 8;
-                objects[0].movement_start_time = current_time; // Start new movement immediately
+                objects[p].target_dx = next_target_dx;
+                objects[p].target_dy = next_target_dy;
+                objects[p].start_x = objects[p].x;
+                objects[p].start_y = objects[p].y;
+                objects[p].target_x = next_target_dx * 16 + 8;
+                objects[p].target_y = next_target_dy * 16 + 8;
+                objects[p].movement_start_time = current_time; // Start new movement immediately
                 // Keep is_moving = true and dir unchanged for continuous movement
             } else {
                 // Stop movement - blocked
-                objects[0].is_moving = false;
-                objects[0].dir = 0;
+                objects[p].is_moving = false;
+                objects[p].dir = 0;
             }
         } else {
             // Stop movement - key released or different direction
-            objects[0].is_moving = false;
-            objects[0].dir = 0;
+            objects[p].is_moving = false;
+            objects[p].dir = 0;
         }
     } else {
         // Interpolate between start and target positions
-        objects[0].x = objects[0].start_x + (int) ((objects[0].target_x - objects[0].start_x) * progress);
-        objects[0].y = objects[0].start_y + (int) ((objects[0].target_y - objects[0].start_y) * progress);
+        objects[p].x = objects[p].start_x + (int) ((objects[p].target_x - objects[p].start_x) * progress);
+        objects[p].y = objects[p].start_y + (int) ((objects[p].target_y - objects[p].start_y) * progress);
 
         // Enhanced smooth walking animation
-        update_character_animation(&objects[0], true); // Moving = true
+        update_character_animation(&objects[p], true); // Moving = true
     }
 }
 
@@ -482,10 +580,11 @@ static void draw_task(void *param) {
                     // Fast memcpy from our framebuffer to SDL texture
                     uint32_t *dst = (uint32_t *) pixels;
                     uint16_t *src = framebuf[current_fb];
+                    const uint16_t *lut = fb_fx_lut;
 
-                    // Convert RGB565 to RGBA8888 efficiently
+                    // Convert RGB565 to RGBA8888 efficiently, applying screen effects on the way
                     for (int i = 0; i < GAME_WIDTH * GAME_HEIGHT; i++) {
-                        uint16_t rgb565 = src[i];
+                        uint16_t rgb565 = lut ? lut[src[i]] : src[i];
                         uint8_t r = (rgb565 >> 8) & 0xF8;
                         uint8_t g = (rgb565 >> 3) & 0xFC;
                         uint8_t b = (rgb565 << 3) & 0xF8;
@@ -637,43 +736,6 @@ static inline uint16_t rgb_to_rgb565(uint8_t r, uint8_t g, uint8_t b) {
     return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
 }
 
-// Fast sprite drawing to framebuffer (much faster than SDL)
-static void fb_draw_sprite(int dst_x, int dst_y, int src_x, int src_y, int w, int h, SDL_Surface *sprite_surface) {
-    if (!framebuf[current_fb] || !sprite_surface || !sprite_surface->pixels) return;
-
-    uint32_t *src_pixels = (uint32_t *) sprite_surface->pixels;
-    int src_pitch = sprite_surface->pitch / 4; // Assuming RGBA format
-
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int screen_x = dst_x + x;
-            int screen_y = dst_y + y;
-
-            // Bounds checking
-            if (screen_x < 0 || screen_x >= GAME_WIDTH ||
-                screen_y < 0 || screen_y >= GAME_HEIGHT)
-                continue;
-
-            int sprite_x = src_x + x;
-            int sprite_y = src_y + y;
-            if (sprite_x >= sprite_surface->w || sprite_y >= sprite_surface->h) continue;
-
-            uint32_t rgba = src_pixels[sprite_y * src_pitch + sprite_x];
-            uint8_t a = (rgba >> 24) & 0xFF;
-
-            // Skip transparent pixels
-            if (a == 0) continue;
-
-            uint8_t r = (rgba >> 16) & 0xFF;
-            uint8_t g = (rgba >> 8) & 0xFF;
-            uint8_t b = rgba & 0xFF;
-
-            uint16_t rgb565 = rgb_to_rgb565(r, g, b);
-            framebuf[current_fb][screen_y * GAME_WIDTH + screen_x] = rgb565;
-        }
-    }
-}
-
 // Fast level tile drawing to framebuffer
 static void fb_draw_level_tile(int tile_x, int tile_y, int tile_type) {
     if (!framebuf[current_fb]) return;
@@ -681,6 +743,18 @@ static void fb_draw_level_tile(int tile_x, int tile_y, int tile_type) {
     int screen_x = tile_x * 16 + 8;
     int screen_y = tile_y * 16 + 8;
 
+    // Atlas pixels from the tile cache when it is filled (animation bob and shade are not applied here)
+    tile_anim_frame_t frame = tile_anim_frame(tile_type, tile_x, tile_y);
+    const uint16_t *cell = tile_type ? tile_cache_get(frame.atlas_x, frame.atlas_y) : NULL;
+    if (cell && screen_x >= 0 && screen_x + 16 <= GAME_WIDTH && screen_y >= 0 && screen_y + 16 <= GAME_HEIGHT) {
+        uint16_t *dst = framebuf[current_fb] + screen_y * GAME_WIDTH + screen_x;
+        for (int dy = 0; dy < 16; dy++, dst += GAME_WIDTH, cell += 16) {
+            memcpy(dst, cell, 16 * sizeof(uint16_t));
+        }
+        return;
+    }
+
+    // No cache: flat colours
     uint16_t tile_color;
     switch (tile_type) {
         case 0: return; // Empty - skip drawing
@@ -770,6 +844,7 @@ void init_render_system() {
 
     ESP_LOGI("game", "Starting game...");
     ESP_LOGI("controls", "🎮 Movement: Arrow Keys OR WASD | ESC = Exit");
+    ESP_LOGI("controls", "🔊 Volume: - / = | Up/Down on the intro = Start level");
     ESP_LOGI("debug", "🔧 Debug: F2 = Previous Level | F3 = Next Level");
 }
 
@@ -777,6 +852,21 @@ void cleanup_render_system() {
     cleanup_streaming_render();
 #ifdef CONFIG_IDF_TARGET_ESP32P4
     cleanup_p4_acceleration();
+#endif
+    sprite_rle_free();
+    tile_cache_free();
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+    band_render_free();
+    if (band_texture) SDL_DestroyTexture(band_texture);
+    band_texture = NULL;
+    panel_out_free();
+#endif
+#ifdef CONFIG_FRUITLAND_NATIVE_SCALE
+    native_render_free();
+    if (native_texture) SDL_DestroyTexture(native_texture);
+    native_texture = NULL;
+    native_scale = 0;
+    native_rotated = false;
 #endif
 }
 
@@ -804,9 +894,9 @@ void render_frame_direct_fb() {
     // to replicate all SDL drawing operations
 
     // Draw level tiles (simplified - just walls and empty space)
-    for (int y = 0; y < LEVEL_HEIGHT; y++) {
-        for (int x = 0; x < LEVEL_WIDTH; x++) {
-            int tile = level_data[y * LEVEL_WIDTH + x];
+    for (int y = 0; y < level_height; y++) {
+        for (int x = 0; x < level_width; x++) {
+            int tile = level_data[y * level_width + x];
             uint16_t tile_color;
 
             switch (tile) {
@@ -859,6 +949,56 @@ void render_frame_direct_fb() {
 }
 #endif
 
+// Draw a texture to the window with the screen effects: colour mod, additive fill for flashes
+static void render_with_fx(SDL_Texture *texture, const SDL_FRect *src_rect, const SDL_FRect *dst_rect) {
+    screen_fx_transform_t fx;
+    bool fx_active = screen_fx_get_transform(&fx);
+    SDL_SetRenderTarget(renderer, NULL);
+    SDL_SetTextureColorMod(texture, fx.mul[0], fx.mul[1], fx.mul[2]);
+    SDL_RenderTexture(renderer, texture, src_rect, dst_rect);
+    if (fx_active && (fx.add[0] | fx.add[1] | fx.add[2])) {
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_ADD);
+        SDL_SetRenderDrawColor(renderer, fx.add[0], fx.add[1], fx.add[2], 255);
+        SDL_RenderFillRect(renderer, dst_rect);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    }
+}
+
+// Move a frame rectangle by the screen offset, in window pixels. The part of the window it
+// covered last time and no longer does gets the border colour, at most two strips.
+static SDL_FRect offset_rect(const SDL_FRect *home, float dx, float dy, SDL_FRect *last) {
+    SDL_FRect now = {home->x + dx, home->y + dy, home->w, home->h};
+    if (last->w > 0 && (now.x != last->x || now.y != last->y)) {
+        screen_fx_transform_t fx;
+        screen_fx_get_transform(&fx);
+        SDL_FRect strips[2];
+        int count = 0;
+        if (now.x > last->x) {
+            strips[count++] = (SDL_FRect) {last->x, last->y, now.x - last->x, last->h};
+        } else if (now.x < last->x) {
+            strips[count++] = (SDL_FRect) {now.x + now.w, last->y, last->x - now.x, last->h};
+        }
+        if (now.y > last->y) {
+            strips[count++] = (SDL_FRect) {last->x, last->y, last->w, now.y - last->y};
+        } else if (now.y < last->y) {
+            strips[count++] = (SDL_FRect) {last->x, now.y + now.h, last->w, last->y - now.y};
+        }
+        SDL_SetRenderTarget(renderer, NULL);
+        SDL_SetRenderDrawColor(renderer, fx.border[0], fx.border[1], fx.border[2], 255);
+        SDL_RenderFillRects(renderer, strips, count);
+    }
+    *last = now;
+    return now;
+}
+
+// Screen offset in window pixels for a frame drawn at the given scale
+static void screen_offset(float scale, float *dx, float *dy) {
+    screen_fx_transform_t fx;
+    screen_fx_get_transform(&fx);
+    *dx = fx.offset[0] * scale;
+    *dy = fx.offset[1] * scale;
+}
+
 // Ultra-fast minimal render function for 2x performance
 void render_frame_minimal() {
     // Skip frame if nothing significant changed
@@ -870,17 +1010,35 @@ void render_frame_minimal() {
     static float cached_scale = 0;
     static int cached_offset_x = 0, cached_offset_y = 0;
     static int cached_scaled_w = 0, cached_scaled_h = 0;
+    static int playfield_rows = GAME_HEIGHT; // Game surface rows scaled to the window
+    static SDL_FRect last_rect;
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+    static SDL_FRect hud_rect, last_hud_rect;
+#endif
 
     // Cache scaling calculations (only once)
     if (cached_scale == 0) {
         float scale_x = (float) SCREEN_WIDTH / GAME_WIDTH;
         float scale_y = (float) SCREEN_HEIGHT / GAME_HEIGHT;
+        int plane_h = 0;
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+        if (hud_plane) {
+            // Playfield rows fill the height the HUD plane leaves; the plane goes 1:1 below them
+            playfield_rows = HUD_Y;
+            plane_h = HUD_ROWS * hud_scale;
+            scale_y = (float) (SCREEN_HEIGHT - plane_h) / HUD_Y;
+        }
+#endif
         cached_scale = (scale_x < scale_y) ? scale_x : scale_y;
 
         cached_scaled_w = GAME_WIDTH * cached_scale;
-        cached_scaled_h = GAME_HEIGHT * cached_scale;
+        cached_scaled_h = playfield_rows * cached_scale;
         cached_offset_x = (SCREEN_WIDTH - cached_scaled_w) / 2;
-        cached_offset_y = (SCREEN_HEIGHT - cached_scaled_h) / 2;
+        cached_offset_y = (SCREEN_HEIGHT - cached_scaled_h - plane_h) / 2;
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+        hud_rect = (SDL_FRect) {(SCREEN_WIDTH - GAME_WIDTH * hud_scale) / 2, cached_offset_y + cached_scaled_h,
+                                GAME_WIDTH * hud_scale, plane_h};
+#endif
     }
 
     // Only clear screen on first render or level change
@@ -892,12 +1050,28 @@ void render_frame_minimal() {
         }
         skip_next_clear = true;
         first_render = false;
+        last_rect.w = 0;
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+        last_hud_rect.w = 0;
+#endif
     }
 
-    // Direct render to screen for maximum speed
-    SDL_SetRenderTarget(renderer, NULL);
-    SDL_FRect dst_rect = {cached_offset_x, cached_offset_y, cached_scaled_w, cached_scaled_h};
-    SDL_RenderTexture(renderer, game_surface, NULL, &dst_rect);
+    // Direct render to screen for maximum speed; screen effects and the offset are applied while scaling.
+    // Both planes move by the same window pixels so the seam between them stays closed.
+    float dx, dy;
+    screen_offset(cached_scale, &dx, &dy);
+    SDL_FRect src_rect = {0, 0, GAME_WIDTH, playfield_rows};
+    SDL_FRect home_rect = {cached_offset_x, cached_offset_y, cached_scaled_w, cached_scaled_h};
+    SDL_FRect dst_rect = offset_rect(&home_rect, dx, dy, &last_rect);
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+    SDL_FRect hud_dst_rect = offset_rect(&hud_rect, dx, dy, &last_hud_rect);
+#endif
+    render_with_fx(game_surface, &src_rect, &dst_rect);
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+    if (hud_plane) {
+        render_with_fx(hud_plane, NULL, &hud_dst_rect);
+    }
+#endif
 
     // Clear update flags
     pending_update.line_count = 0;
@@ -937,28 +1111,15 @@ int load_assets() {
     fread(levels, 1, 4736, levdat);
     fclose(levdat);
 
-    // Load intro bitmap (convert to RGB565 for faster blit on embedded)
-    SDL_Surface *intro_surface = SDL_LoadBMP("/assets/intro.bmp");
-    if (!intro_surface) {
-        printf("Failed to load /assets/intro.bmp: %s\n", SDL_GetError());
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+    // No PSRAM: no game surface; atlas cells are read from the BMP on
+    // demand through the tile cache and sprites are encoded from there (patterns.bmp is 256 wide)
+    if (tile_cache_init_file("/assets/patterns.bmp") != ESP_OK || sprite_rle_init(NULL, 256, 0, 1, 5) != ESP_OK) {
+        printf("Failed to load /assets/patterns.bmp\n");
         return 0;
     }
-    SDL_Surface *intro565 = SDL_ConvertSurface(intro_surface, SDL_PIXELFORMAT_RGB565);
-    SDL_DestroySurface(intro_surface);
-    if (!intro565) {
-        printf("Failed to convert intro to RGB565: %s\n", SDL_GetError());
-        return 0;
-    }
-    intro_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STATIC,
-                                      intro565->w, intro565->h);
-    if (!intro_texture) {
-        printf("Failed to create intro texture: %s\n", SDL_GetError());
-        SDL_DestroySurface(intro565);
-        return 0;
-    }
-    SDL_UpdateTexture(intro_texture, NULL, intro565->pixels, intro565->pitch);
-    SDL_DestroySurface(intro565);
-
+    tile_cache_flush();
+#else
     // Load patterns bitmap and convert to RGB565
     SDL_Surface *patterns_surface = SDL_LoadBMP("/assets/patterns.bmp");
     if (!patterns_surface) {
@@ -979,6 +1140,14 @@ int load_assets() {
         return 0;
     }
     SDL_UpdateTexture(patterns_texture, NULL, patterns565->pixels, patterns565->pitch);
+    // Pixel art: cells are copied 1:1 to the game surface, and HUD glyphs enlarged into the HUD plane stay sharp
+    SDL_SetTextureScaleMode(patterns_texture, SDL_SCALEMODE_NEAREST);
+#if defined(CONFIG_FRUITLAND_NATIVE_SCALE) || defined(CONFIG_FRUITLAND_STARTUP_BENCHMARKS)
+    // Atlas cells through an internal RAM cache, sprite cell rows 1-5 as opaque runs;
+    // read by the native-scale compositor and the blit benchmarks
+    tile_cache_init((const uint16_t *) patterns565->pixels, patterns565->w, patterns565->h, patterns565->pitch / 2);
+    sprite_rle_init((const uint16_t *) patterns565->pixels, patterns565->w, patterns565->pitch / 2, 1, 5);
+#endif
     SDL_DestroySurface(patterns565);
 
     // Create game surface texture for off-screen rendering in RGB565
@@ -989,25 +1158,52 @@ int load_assets() {
         return 0;
     }
 
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+    // HUD text at the largest integer scale of the game that fits, so it is never blurred
+    int fit_x = SCREEN_WIDTH / GAME_WIDTH, fit_y = SCREEN_HEIGHT / GAME_HEIGHT;
+    hud_scale = fit_x < fit_y ? fit_x : fit_y;
+    if (hud_scale < 1) hud_scale = 1;
+    hud_plane = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_TARGET,
+                                  GAME_WIDTH * hud_scale, HUD_ROWS * hud_scale);
+    if (hud_plane) {
+        printf("HUD plane: %dx%d\n", GAME_WIDTH * hud_scale, HUD_ROWS * hud_scale);
+    } else {
+        printf("Warning: No HUD plane, the HUD is scaled with the playfield: %s\n", SDL_GetError());
+    }
+#endif
+#endif
+
     return 1;
 }
 
+// Select where text at game position (x, y) goes and return its first 8x8 glyph rectangle:
+// the HUD plane at its scale for HUD rows, otherwise the game surface
+static SDL_FRect text_target(int x, int y) {
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+    if (hud_plane && y >= HUD_Y) {
+        SDL_SetRenderTarget(renderer, hud_plane);
+        return (SDL_FRect) {x * hud_scale, (y - HUD_Y) * hud_scale, 8 * hud_scale, 8 * hud_scale};
+    }
+#endif
+    SDL_SetRenderTarget(renderer, game_surface);
+    return (SDL_FRect) {x, y, 8, 8};
+}
+
 // Print number on screen
 void print_number(int px, int py, int n, int s) {
-    SDL_SetRenderTarget(renderer, game_surface);
-    px = px + 8 * (s - 1);
+    SDL_FRect dst_rect = text_target(px + 8 * (s - 1), py);
     for (int c = 0; c < s; c++) {
         SDL_FRect src_rect = {(n % 10) * 8 + 48, 8, 8, 8};
-        SDL_FRect dst_rect = {px, py, 8, 8};
         SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
         n = n / 10;
-        px = px - 8;
+        dst_rect.x -= dst_rect.w;
     }
+    SDL_SetRenderTarget(renderer, game_surface);
 }
 
 // Draw text using pattern font
 void draw_text_out(int x, int y, const char *s) {
-    SDL_SetRenderTarget(renderer, game_surface);
+    SDL_FRect dst_rect = text_target(x, y);
     for (int c = 0; c < strlen(s); c++) {
         int sx, sy;
         if (s[c] == ':') {
@@ -1018,9 +1214,10 @@ void draw_text_out(int x, int y, const char *s) {
             sy = 0;
         }
         SDL_FRect src_rect = {sx, sy, 8, 8};
-        SDL_FRect dst_rect = {x + c * 8, y, 8, 8};
         SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+        dst_rect.x += dst_rect.w;
     }
+    SDL_SetRenderTarget(renderer, game_surface);
 }
 
 // Draw game stats
@@ -1031,14 +1228,6 @@ void draw_texts() {
     draw_text_out(176, 200, "LIVES:");
 }
 
-// Print game statistics
-void print_stats() {
-    print_number(64, 192, score, 8);
-    print_number(64, 200, av_time, 4);
-    print_number(232, 192, level, 2);
-    print_number(232, 200, lives, 2);
-}
-
 // Draw level border
 void draw_border() {
     SDL_SetRenderTarget(renderer, game_surface);
@@ -1068,72 +1257,274 @@ void draw_border() {
     }
 }
 
+// Draw one animation frame of a level tile at pixel (px, py) of the current render target
+void draw_tile_frame_at(float px, float py, const tile_anim_frame_t *frame) {
+    SDL_FRect src_rect = {(float) frame->atlas_x, (float) frame->atlas_y, 16.0f, 16.0f};
+    SDL_FRect dst_rect = {px, py, 16.0f, 16.0f};
+
+    if (frame->dy != 0) {
+        // Bobbing frame: clear the cell and clip the sprite to it
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &dst_rect);
+        int shift = frame->dy < 0 ? -frame->dy : frame->dy;
+        src_rect.h -= shift;
+        dst_rect.h -= shift;
+        if (frame->dy < 0) {
+            src_rect.y += shift;
+        } else {
+            dst_rect.y += shift;
+        }
+    }
+
+    if (frame->shade != 255) {
+        SDL_SetTextureColorMod(patterns_texture, frame->shade, frame->shade, frame->shade);
+        SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+        SDL_SetTextureColorMod(patterns_texture, 255, 255, 255);
+    } else {
+        SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+    }
+}
+
+// Draw one animation frame of a level tile (render target must already be game_surface)
+void draw_tile_frame(int x, int y, const tile_anim_frame_t *frame) {
+    draw_tile_frame_at((float) (x * 16 + 8), (float) (y * 16 + 8), frame);
+}
+
+// Tile callback for the scroll ring
+static void draw_ring_tile(int tile, int tile_x, int tile_y, float dst_x, float dst_y) {
+    if (!fov_is_visible(tile_x, tile_y)) {
+        SDL_FRect rect = {dst_x, dst_y, 16, 16};
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &rect);
+        return;
+    }
+    tile_anim_frame_t frame = tile_anim_frame(tile, tile_x, tile_y);
+    draw_tile_frame_at(dst_x, dst_y, &frame);
+}
+
+// Draw a level cell with the given content (render target must already be game_surface)
+static void draw_tile_code(int x, int y, int tile, bool hidden) {
+    if (hidden) {
+        // Fogged cell
+        SDL_FRect rect = {x * 16 + 8, y * 16 + 8, 16, 16};
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &rect);
+        return;
+    }
+    tile_anim_frame_t frame = tile_anim_frame(tile, x, y);
+    draw_tile_frame(x, y, &frame);
+}
+
+// Draw a single level tile (render target must already be game_surface)
+void draw_tile(int x, int y) {
+    draw_tile_code(x, y, level_data[y * level_width + x], !fov_is_visible(x, y));
+}
+
+// Queue a redraw of one level cell; scrolling levels refresh it in the tile ring instead
+static void emit_tile(int x, int y) {
+    if (scroll_is_active()) {
+        scroll_invalidate_tile(x, y); // Redrawn into the ring if visible
+        return;
+    }
+    rcmd_tile(x, y, level_data[y * level_width + x], !fov_is_visible(x, y));
+}
+
 // Draw the game level
 void draw_level() {
+    if (scroll_is_active()) {
+        // Scrolling map: the tile ring refills itself on the next frame
+        scroll_invalidate_all();
+        tile_anim_reset(level_data, level_width, level_height);
+        return;
+    }
+
     SDL_SetRenderTarget(renderer, game_surface);
-    for (int y = 0; y < LEVEL_HEIGHT; y++) {
-        for (int x = 0; x < LEVEL_WIDTH; x++) {
-            int tile = level_data[y * LEVEL_WIDTH + x];
-            int xx = tile % 16;
-            int yy = tile / 16;
-            SDL_FRect src_rect = {(float) (xx * 16), (float) (yy * 16 + 16), 16.0f, 16.0f};
-            SDL_FRect dst_rect = {(float) (x * 16 + 8), (float) (y * 16 + 8), 16.0f, 16.0f};
-            SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+    for (int y = 0; y < level_height; y++) {
+        for (int x = 0; x < level_width; x++) {
+            draw_tile(x, y);
         }
     }
+    tile_anim_reset(level_data, level_width, level_height);
 }
 
-// Initialize level data
-void init_level_data() {
-    int a = (level - 1) * (LEVEL_WIDTH * LEVEL_HEIGHT + 4);
+// Redraw callback for tile_anim_update; the backend draws the cell's current frame
+static bool redraw_animated_tile(int x, int y, const tile_anim_frame_t *frame) {
+    if (!fov_is_visible(x, y)) {
+        return false; // Drawn with its current frame when it comes into view
+    }
+    emit_tile(x, y);
+    return true;
+}
+
+// Redraw callback for fov_update: a cell came into or went out of view
+static void redraw_fog_tile(int x, int y, bool visible) {
+    emit_tile(x, y);
+}
+
+// Recast the fog of war when a player changed tile or a rock or the block moved;
+// returns true if any cell flipped
+bool update_fog(bool force) {
+    if (!fov_is_enabled()) {
+        return false;
+    }
+
+    static uint32_t last_signature;
+    uint32_t signature = 2166136261u; // FNV-1a over everything that moves sight lines
+    for (int i = 0; i < MAX_OBJECTS; i++) {
+        if (i >= 1 && i <= 4) continue; // Enemies do not block sight
+        uint32_t v = (objects[i].l ? 1u : 0u) | (objects[i].is_moving ? 2u : 0u) |
+                     ((uint32_t) objects[i].dx << 2) | ((uint32_t) objects[i].dy << 10);
+        signature = (signature ^ v) * 16777619u;
+    }
+    if (!force && signature == last_signature) {
+        return false;
+    }
+    last_signature = signature;
+
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    int viewer_x[2] = {objects[0].dx, objects[PLAYER2].dx};
+    int viewer_y[2] = {objects[0].dy, objects[PLAYER2].dy};
+#else
+    int viewer_x[1] = {objects[0].dx};
+    int viewer_y[1] = {objects[0].dy};
+#endif
+    return fov_update(viewer_x, viewer_y, player_count, redraw_fog_tile) > 0;
+}
+
+// Advance tile animations and redraw only the cells whose frame changed
+int animate_level_tiles() {
+    tile_anim_tick(get_time_us());
+#ifdef CONFIG_IDF_TARGET_ESP32P4
+    if (direct_framebuffer_mode) {
+        return 0; // Flat-colour framebuffer tiles have no animation frames
+    }
+#endif
+    return tile_anim_update(level_data, redraw_animated_tile);
+}
+
+// Restore the level background under a dirty rectangle (game surface pixels)
+void redraw_level_region(const SDL_Rect *rect) {
+    int x0 = (rect->x - 8) / 16;
+    int y0 = (rect->y - 8) / 16;
+    int x1 = (rect->x + rect->w - 1 - 8) / 16;
+    int y1 = (rect->y + rect->h - 1 - 8) / 16;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= level_width) x1 = level_width - 1;
+    if (y1 >= level_height) y1 = level_height - 1;
+
+    SDL_SetRenderTarget(renderer, game_surface);
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            draw_tile(x, y);
+        }
+    }
+    mark_area_dirty(y0 * 16 + 8, (y1 - y0 + 1) * 16);
+}
+
+// Copy stored level lvl into level_data at tile offset (ox, oy), return its time limit
+int copy_stored_level(int lvl, int ox, int oy, bool place_player) {
+    int a = (lvl - 1) * (LEVEL_WIDTH * LEVEL_HEIGHT + 4);
 
     // Binary Coded Decimal conversion for time
-    av_time = (levels[a + 1] & 15) + ((levels[a + 1] & 240) >> 4) * 10;
-    av_time = av_time + (levels[a] & 15) * 100 + ((levels[a] & 240) >> 4) * 1000;
-    av_time = av_time + av_time / 2; // 50% extra time
+    int time = (levels[a + 1] & 15) + ((levels[a + 1] & 240) >> 4) * 10;
+    time = time + (levels[a] & 15) * 100 + ((levels[a] & 240) >> 4) * 1000;
+    time = time + time / 2; // 50% extra time
 
     a = a + 4;
     for (int c = 0; c < LEVEL_WIDTH * LEVEL_HEIGHT; c++) {
         int d = levels[a + c];
         // Note: Re-enabled type 15 enemies (ghosts) - they were disabled in original
         // if (d == 15) d--; // Remove old enemy type - DISABLED to allow ghosts
-        level_data[c] = d;
+        level_data[(oy + c / LEVEL_WIDTH) * level_width + ox + c % LEVEL_WIDTH] = d;
+    }
+    if (place_player) {
+        a = a - 2;
+        level_data[(oy + levels[a]) * level_width + ox + levels[a + 1]] = 32; // Player start position
+    }
+    return time;
+}
+
+#ifdef CONFIG_FRUITLAND_ENDLESS_MODE
+// Take the next level from the background generator, return its time limit
+int copy_generated_level() {
+    levelgen_level_t gen;
+    levelgen_next(&gen);
+    memcpy(level_data, gen.tiles, sizeof(gen.tiles));
+    level_data[gen.player_y * level_width + gen.player_x] = 32; // Player start position
+    ESP_LOGI("game", "Generated level from seed %lu (%d candidates)", (unsigned long) gen.seed, gen.attempts);
+    return gen.time;
+}
+#endif
+
+// Initialize level data
+void init_level_data() {
+#ifdef CONFIG_FRUITLAND_WORLD_MAP
+    // All stored levels stitched into one scrolling world, starting from level 1
+    level_width = LEVEL_WIDTH * WORLD_COLUMNS;
+    level_height = LEVEL_HEIGHT * ((25 + WORLD_COLUMNS - 1) / WORLD_COLUMNS);
+    memset(level_data, 2, level_width * level_height); // Walls where the grid has no level
+    av_time = 0;
+    for (int l = 0; l < 25; l++) {
+        av_time += copy_stored_level(l + 1, (l % WORLD_COLUMNS) * LEVEL_WIDTH, (l / WORLD_COLUMNS) * LEVEL_HEIGHT, l == 0);
+    }
+#elif defined(CONFIG_FRUITLAND_ENDLESS_MODE)
+    level_width = LEVEL_WIDTH;
+    level_height = LEVEL_HEIGHT;
+    av_time = (level > STORED_LEVELS) ? copy_generated_level() : copy_stored_level(level, 0, 0, true);
+#else
+    level_width = LEVEL_WIDTH;
+    level_height = LEVEL_HEIGHT;
+    av_time = copy_stored_level(level, 0, 0, true);
+#endif
+
+#ifndef CONFIG_FRUITLAND_LOW_MEMORY
+    // Two players get a half-width view each, but only when the map does not fit on screen
+    bool split = player_count == 2 && (level_width > LEVEL_WIDTH || level_height > LEVEL_HEIGHT);
+    int views = split ? 2 : 1;
+    if (scroll_view_count() != views &&
+        scroll_set_views(views, LEVEL_WIDTH * 16 / views, LEVEL_HEIGHT * 16) != ESP_OK) {
+        ESP_LOGW("game", "Could not allocate %d scroll views", views);
     }
-    a = a - 2;
-    level_data[levels[a] * LEVEL_WIDTH + levels[a + 1]] = 32; // Player start position
+    scroll_set_map(level_data, level_width, level_height);
+#endif
 }
 
 // Count fruits in level
 void count_fruit() {
     fruit = 0;
-    for (int a = 0; a < LEVEL_WIDTH * LEVEL_HEIGHT; a++) {
+    for (int a = 0; a < level_width * level_height; a++) {
         if (level_data[a] == 4) fruit++;
     }
 }
 
 // Clear game surface
 void clear_game_surface() {
-    SDL_SetRenderTarget(renderer, game_surface);
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+    if (hud_plane) {
+        SDL_SetRenderTarget(renderer, hud_plane);
+        SDL_RenderClear(renderer);
+    }
+#endif
+    SDL_SetRenderTarget(renderer, game_surface);
     SDL_RenderClear(renderer);
 }
 
 // Global flag for level drawing optimization
 static bool level_drawn = false;
 
-// Print entire level with optimized drawing
+// Queue the whole level for the render backend, which draws it with the next frame
 void print_level() {
-    // Only draw level once unless it's a new level
+    // Only once unless it's a new level
     if (!level_drawn) {
-        clear_game_surface();
-        draw_border();
-        draw_level();
-        draw_texts();
+        tile_anim_reset(level_data, level_width, level_height);
+        rcmd_reset(); // Cell updates queued for the previous level are covered by the redraw
+        rcmd_level();
         level_drawn = true;
 
         // Force full redraw on level change
         full_redraw_needed = true;
-        mark_full_update();
     }
 }
 
@@ -1143,26 +1534,56 @@ void reset_level_drawing() {
     full_redraw_needed = true; // Force full redraw for new level
 }
 
-// Show intro screen
+#ifdef CONFIG_FRUITLAND_PANEL_DIRECT
+// Intro bands go to the panel as they are decoded, centred in the game frame
+static void intro_band(uint16_t *band, int width, int height, int y0, int lines) {
+    panel_out_band(band, GAME_WIDTH, GAME_HEIGHT, y0 + (GAME_HEIGHT - height) / 2, lines);
+}
+
+// Show intro screen, streamed from storage a band at a time
 void show_intro() {
-    SDL_SetRenderTarget(renderer, NULL);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+    panel_out_clear();
+    intro_stream("/assets/intro.bmp", GAME_WIDTH, GAME_HEIGHT, BAND_LINES, intro_band);
+}
+#else
+static SDL_Texture *intro_band_texture = NULL; // Only while the intro is being streamed
 
-    // Scale intro to fit screen while maintaining aspect ratio
+// Upload an intro band and draw it into its rows of the game frame, scaled like the frame
+// and centred vertically in it, the same layout as on the direct panel path
+static void intro_band(uint16_t *band, int width, int height, int y0, int lines) {
     float scale_x = (float) SCREEN_WIDTH / GAME_WIDTH;
     float scale_y = (float) SCREEN_HEIGHT / GAME_HEIGHT;
     float scale = (scale_x < scale_y) ? scale_x : scale_y;
+    float frame_y = (SCREEN_HEIGHT - GAME_HEIGHT * scale) / 2;
 
-    int scaled_w = GAME_WIDTH * scale;
-    int scaled_h = GAME_HEIGHT * scale;
-    int offset_x = (SCREEN_WIDTH - scaled_w) / 2;
-    int offset_y = (SCREEN_HEIGHT - scaled_h) / 2;
+    SDL_Rect src = {0, 0, width, lines};
+    SDL_UpdateTexture(intro_band_texture, &src, band, width * sizeof(uint16_t));
 
-    SDL_FRect dst_rect = {offset_x, offset_y, scaled_w, scaled_h};
-    SDL_RenderTexture(renderer, intro_texture, NULL, &dst_rect);
+    SDL_FRect src_rect = {0, 0, width, lines};
+    SDL_FRect dst_rect = {(SCREEN_WIDTH - GAME_WIDTH * scale) / 2,
+                          frame_y + (y0 + (GAME_HEIGHT - height) / 2) * scale,
+                          GAME_WIDTH * scale, lines * scale};
+    SDL_RenderTexture(renderer, intro_band_texture, &src_rect, &dst_rect);
+}
+
+// Show intro screen, streamed from storage a band at a time; nothing stays resident afterwards
+void show_intro() {
+    SDL_SetRenderTarget(renderer, NULL);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    intro_band_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING,
+                                           GAME_WIDTH, BAND_LINES);
+    if (intro_band_texture) {
+        intro_stream("/assets/intro.bmp", GAME_WIDTH, GAME_HEIGHT, BAND_LINES, intro_band);
+        SDL_DestroyTexture(intro_band_texture);
+        intro_band_texture = NULL;
+    } else {
+        printf("Failed to create intro band texture: %s\n", SDL_GetError());
+    }
     SDL_RenderPresent(renderer);
 }
+#endif
 
 // Basic menu selection (simplified for embedded)
 int select_option() {
@@ -1192,6 +1613,46 @@ int select_option() {
     return option;
 }
 
+// Log the cached high-score table (served from RAM, never from flash)
+void print_hiscores() {
+    persist_hiscore_t table[HI_ENTRIES];
+    persist_get_hiscores(table);
+    ESP_LOGI("hiscore", "🏆 HIGH SCORES (unlocked up to level %d)", persist_get_unlocked_level());
+    for (int i = 0; i < HI_ENTRIES; i++) {
+        if (table[i].score <= 0) continue;
+        ESP_LOGI("hiscore", "%d. %s %8ld  L%02d", i + 1, table[i].name, (long) table[i].score, table[i].level);
+    }
+}
+
+// Intro hold: up/down step the start level among the levels unlocked so far; each
+// step keeps the intro up for another two seconds
+void choose_start_level(uint64_t until_us) {
+    int unlocked = persist_get_unlocked_level();
+    if (start_level > unlocked) start_level = unlocked;
+    bool held = false;
+    while (get_time_us() < until_us) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+        }
+#ifdef CONFIG_IDF_TARGET_ESP32P4
+        if (is_keyboard_available()) {
+            process_keyboard();
+        }
+#endif
+        const bool *keys = SDL_GetKeyboardState(NULL);
+        int step = keys[SDL_SCANCODE_UP] ? 1 : keys[SDL_SCANCODE_DOWN] ? -1 : 0;
+        if (step && !held) {
+            if (start_level + step >= 1 && start_level + step <= unlocked) {
+                start_level += step;
+                ESP_LOGI("game", "Start level %d (unlocked up to %d)", start_level, unlocked);
+            }
+            until_us = get_time_us() + 2000000;
+        }
+        held = (step != 0);
+        vTaskDelay(pdMS_TO_TICKS(16));
+    }
+}
+
 // Initialize game objects
 void init_objects() {
     // Reset all objects
@@ -1201,10 +1662,10 @@ void init_objects() {
     int c = 0;
     while (level_data[c] != 32) c++;
 
-    objects[0].dx = c % LEVEL_WIDTH;
-    objects[0].dy = c / LEVEL_WIDTH;
-    objects[0].x = (c % LEVEL_WIDTH) * 16 + 8;
-    objects[0].y = (c / LEVEL_WIDTH) * 16 + 8;
+    objects[0].dx = c % level_width;
+    objects[0].dy = c / level_width;
+    objects[0].x = (c % level_width) * 16 + 8;
+    objects[0].y = (c / level_width) * 16 + 8;
     objects[0].l = 1;
     objects[0].sx = 0;
     objects[0].sy = 48;
@@ -1223,17 +1684,45 @@ void init_objects() {
     objects[0].base_sy = 48; // Default facing down
     level_data[c] = 0;
 
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    // Second player starts on the nearest free tile next to player 1
+    if (player_count == 2) {
+        int start = c;
+        for (int radius = 1; radius <= 3 && start == c; radius++) {
+            for (int oy = -radius; oy <= radius && start == c; oy++) {
+                for (int ox = -radius; ox <= radius; ox++) {
+                    int nx = objects[0].dx + ox, ny = objects[0].dy + oy;
+                    if (nx >= 0 && nx < level_width && ny >= 0 && ny < level_height &&
+                        level_data[ny * level_width + nx] == 0) {
+                        start = ny * level_width + nx;
+                        break;
+                    }
+                }
+            }
+        }
+        objects[PLAYER2] = objects[0];
+        objects[PLAYER2].dx = start % level_width;
+        objects[PLAYER2].dy = start / level_width;
+        objects[PLAYER2].x = objects[PLAYER2].dx * 16 + 8;
+        objects[PLAYER2].y = objects[PLAYER2].dy * 16 + 8;
+        objects[PLAYER2].target_dx = objects[PLAYER2].dx;
+        objects[PLAYER2].target_dy = objects[PLAYER2].dy;
+        objects[PLAYER2].start_x = objects[PLAYER2].target_x = objects[PLAYER2].x;
+        objects[PLAYER2].start_y = objects[PLAYER2].target_y = objects[PLAYER2].y;
+    }
+#endif
+
     // Initialize rocks and enemies
     int cur_rock = 5;
     int cur_enemy = 1;
 
-    for (c = 0; c < LEVEL_WIDTH * LEVEL_HEIGHT; c++) {
+    for (c = 0; c < level_width * level_height; c++) {
         if (level_data[c] == 3 && cur_rock < 15) {
             // Rock - initialize with tile-based movement support
-            objects[cur_rock].dx = c % LEVEL_WIDTH;
-            objects[cur_rock].dy = c / LEVEL_WIDTH;
-            objects[cur_rock].x = (c % LEVEL_WIDTH) * 16 + 8;
-            objects[cur_rock].y = (c / LEVEL_WIDTH) * 16 + 8;
+            objects[cur_rock].dx = c % level_width;
+            objects[cur_rock].dy = c / level_width;
+            objects[cur_rock].x = (c % level_width) * 16 + 8;
+            objects[cur_rock].y = (c / level_width) * 16 + 8;
             objects[cur_rock].l = 1; // Stationary rock
             objects[cur_rock].sx = 48;
             objects[cur_rock].sy = 16;
@@ -1251,10 +1740,10 @@ void init_objects() {
         }
         if ((level_data[c] == 14 || level_data[c] == 13 || level_data[c] == 15) && cur_enemy < 5) {
             // Enemy
-            objects[cur_enemy].dx = c % LEVEL_WIDTH;
-            objects[cur_enemy].dy = c / LEVEL_WIDTH;
-            objects[cur_enemy].x = (c % LEVEL_WIDTH) * 16 + 8;
-            objects[cur_enemy].y = (c / LEVEL_WIDTH) * 16 + 8;
+            objects[cur_enemy].dx = c % level_width;
+            objects[cur_enemy].dy = c / level_width;
+            objects[cur_enemy].x = (c % level_width) * 16 + 8;
+            objects[cur_enemy].y = (c / level_width) * 16 + 8;
             objects[cur_enemy].sx = 112; // Starting sprite x-coordinate
             
             if (level_data[c] == 14) {
@@ -1267,7 +1756,7 @@ void init_objects() {
                 // Vertical ghost (blue ghost) 
                 objects[cur_enemy].l = 2; // Type 2 = vertical movement
                 objects[cur_enemy].sy = 48; // Blue ghost sprites
-                objects[cur_enemy].dir = (objects[cur_enemy].dy > 0 && level_data[c-LEVEL_WIDTH] == 0) ? UP : DOWN;
+                objects[cur_enemy].dir = (objects[cur_enemy].dy > 0 && level_data[c-level_width] == 0) ? UP : DOWN;
                 objects[cur_enemy].base_sy = 48;
             } else if (level_data[c] == 15) {
                 // Special ghost (green/purple ghost) - diagonal or special movement
@@ -1301,25 +1790,28 @@ void init_objects() {
 }
 
 // Teleport player to the other teleporter location
-void teleport() {
+void teleport(int p) {
+    particles_spawn_burst(objects[p].x + 8, objects[p].y + 8, PARTICLE_BURST_TELEPORT);
+
     // Clear current player position in level data
-    level_data[objects[0].dx + objects[0].dy * LEVEL_WIDTH] = 0;
+    level_data[objects[p].dx + objects[p].dy * level_width] = 0;
 
     // Find the other teleporter (tile type 6)
     int teleporter_found = 0;
-    for (int c = 0; c < LEVEL_WIDTH * LEVEL_HEIGHT; c++) {
+    for (int c = 0; c < level_width * level_height; c++) {
         if (level_data[c] == 6) {
             // Found the destination teleporter
-            objects[0].dx = c % LEVEL_WIDTH;
-            objects[0].dy = c / LEVEL_WIDTH;
-            objects[0].x = (c % LEVEL_WIDTH) * 16 + 8;
-            objects[0].y = (c / LEVEL_WIDTH) * 16 + 8;
+            objects[p].dx = c % level_width;
+            objects[p].dy = c / level_width;
+            objects[p].x = (c % level_width) * 16 + 8;
+            objects[p].y = (c / level_width) * 16 + 8;
 
             // Clear the destination teleporter as well
             level_data[c] = 0;
 
             teleporter_found = 1;
-            ESP_LOGI("game", "Teleported to position (%d, %d)", objects[0].dx, objects[0].dy);
+            particles_spawn_burst(objects[p].x + 8, objects[p].y + 8, PARTICLE_BURST_TELEPORT);
+            BINLOG_I("game", "Teleported to position (%d, %d)", objects[p].dx, objects[p].dy);
             break;
         }
     }
@@ -1330,17 +1822,17 @@ void teleport() {
 }
 
 // Turn screen upside down (flip vertically) based on original game
-void turn_screen() {
-    ESP_LOGI("game", "Screen flip activated!");
+void turn_screen(int p) {
+    BINLOG_I("game", "Screen flip activated!");
 
     // Clear player position in level data
-    level_data[objects[0].dx + objects[0].dy * LEVEL_WIDTH] = 0;
+    level_data[objects[p].dx + objects[p].dy * level_width] = 0;
 
     // Flip the level data vertically
-    for (int y = 0; y < LEVEL_HEIGHT / 2; y++) {
-        for (int x = 0; x < LEVEL_WIDTH; x++) {
-            int top_pos = y * LEVEL_WIDTH + x;
-            int bottom_pos = (LEVEL_HEIGHT - 1 - y) * LEVEL_WIDTH + x;
+    for (int y = 0; y < level_height / 2; y++) {
+        for (int x = 0; x < level_width; x++) {
+            int top_pos = y * level_width + x;
+            int bottom_pos = (level_height - 1 - y) * level_width + x;
 
             // Swap tiles
             int temp = level_data[top_pos];
@@ -1352,14 +1844,13 @@ void turn_screen() {
     // Flip all objects (including player) vertically
     for (int c = 0; c < MAX_OBJECTS; c++) {
         if (objects[c].l) {
-            objects[c].dy = LEVEL_HEIGHT - 1 - objects[c].dy;
-            objects[c].y = (LEVEL_HEIGHT - 1) * 16 + 8 - (objects[c].y - 8);
+            objects[c].dy = level_height - 1 - objects[c].dy;
+            objects[c].y = (level_height - 1) * 16 + 8 - (objects[c].y - 8);
         }
     }
 
-    // Force level redraw
+    // Whole level changed: the next frame redraws it
     reset_level_drawing();
-    print_level();
 }
 
 // Search for rock at specific coordinates
@@ -1401,9 +1892,9 @@ bool is_passable(int tile_type) {
 }
 
 // Handle item collection based on original game mechanics
-void get_item() {
-    int item = level_data[objects[0].dx + objects[0].dy * LEVEL_WIDTH];
-    level_data[objects[0].dx + objects[0].dy * LEVEL_WIDTH] = 0;
+void get_item(int p) {
+    int item = level_data[objects[p].dx + objects[p].dy * level_width];
+    level_data[objects[p].dx + objects[p].dy * level_width] = 0;
 
     switch (item) {
         case 1: // Small dot/pellet
@@ -1412,36 +1903,46 @@ void get_item() {
         case 4: // Fruit
             fruit--;
             score += 500;
-            ESP_LOGI("game", "Fruit collected! Remaining: %d, Score: %d", fruit, score);
+            audio_play(AUDIO_SFX_FRUIT);
+            particles_spawn_burst(objects[p].x + 8, objects[p].y + 8, PARTICLE_BURST_PICKUP);
+            BINLOG_I("game", "Fruit collected! Remaining: %d, Score: %d", fruit, score);
             break;
         case 5: // Bonus item
             score += 100;
-            ESP_LOGI("game", "Bonus collected! Score: %d", score);
+            audio_play(AUDIO_SFX_BONUS);
+            particles_spawn_burst(objects[p].x + 8, objects[p].y + 8, PARTICLE_BURST_PICKUP);
+            BINLOG_I("game", "Bonus collected! Score: %d", score);
             break;
         case 6: // Teleporter
-            teleport();
+            teleport(p);
             score += 200;
+            audio_play(AUDIO_SFX_TELEPORT);
             break;
         case 7: // Time bonus
             av_time += 50; // Add extra time (reduced from original 500 for balance)
-            ESP_LOGI("game", "Time bonus! Extra time: %d", av_time);
+            audio_play(AUDIO_SFX_BONUS);
+            BINLOG_I("game", "Time bonus! Extra time: %d", av_time);
             break;
         case 8: // Screen flip
-            turn_screen();
+            turn_screen(p);
             score += 300;
+            audio_play(AUDIO_SFX_FLIP);
             break;
         case 9: // Extra life
             lives++;
-            ESP_LOGI("game", "Extra life! Lives: %d", lives);
+            audio_play(AUDIO_SFX_BONUS);
+            BINLOG_I("game", "Extra life! Lives: %d", lives);
             break;
         case 10: // Freeze enemies
             freeze_enemy = 300; // 5 seconds at 60fps (reduced from original 500)
             score += 150;
-            ESP_LOGI("game", "Enemy freeze activated! Duration: %d frames", freeze_enemy);
+            audio_play(AUDIO_SFX_BONUS);
+            BINLOG_I("game", "Enemy freeze activated! Duration: %d frames", freeze_enemy);
             break;
         case 12: // Death trap
             dead = 1;
-            ESP_LOGI("game", "Death trap hit!");
+            dead_player = p;
+            BINLOG_I("game", "Death trap hit!");
             break;
         default:
             // No item or unknown item - do nothing
@@ -1455,14 +1956,14 @@ void move_rocks() {
         if (objects[r].l) {
             // Is there a rock?
             // Check if rock should fall (gravity) - only if not currently moving
-            if (!objects[r].is_moving && objects[r].dy < LEVEL_HEIGHT - 1) {
-                int below_pos = objects[r].dx + (objects[r].dy + 1) * LEVEL_WIDTH;
+            if (!objects[r].is_moving && objects[r].dy < level_height - 1) {
+                int below_pos = objects[r].dx + (objects[r].dy + 1) * level_width;
                 int d = level_data[below_pos];
 
                 if (d == 0 || d == 81) {
                     // Rock allowed to fall?
                     // Check if player is directly below (don't crush player immediately)
-                    bool player_below = (objects[r].dx == objects[0].dx && objects[r].dy == objects[0].dy - 1);
+                    bool player_below = is_player_at(objects[r].dx, objects[r].dy + 1);
                     if (!player_below) {
                         objects[r].movement_start_time = get_time_us();
                         objects[r].is_moving = true;
@@ -1474,8 +1975,8 @@ void move_rocks() {
                         objects[r].target_dy = objects[r].dy + 1;
                         objects[r].target_x = objects[r].dx * 16 + 8;
                         objects[r].target_y = (objects[r].dy + 1) * 16 + 8;
-                        level_data[objects[r].dx + objects[r].dy * LEVEL_WIDTH] = 80; // Mark old pos as moving
-                        ESP_LOGI("gravity", "Rock at (%d,%d) starting to fall", objects[r].dx, objects[r].dy);
+                        level_data[objects[r].dx + objects[r].dy * level_width] = 80; // Mark old pos as moving
+                        BINLOG_I("gravity", "Rock at (%d,%d) starting to fall", objects[r].dx, objects[r].dy);
                     }
                 }
             }
@@ -1487,11 +1988,12 @@ void move_rocks() {
 
                 if (elapsed >= TILE_MOVEMENT_DURATION_US) {
                     // Movement complete - check if we can continue falling or must stop
+                    bool was_falling = objects[r].dir == DOWN;
                     objects[r].is_moving = false;
                     objects[r].dir = 0;
 
                     // Clear old position (but check first to avoid clearing wrong tile)
-                    int old_pos = objects[r].dx + objects[r].dy * LEVEL_WIDTH;
+                    int old_pos = objects[r].dx + objects[r].dy * level_width;
                     if (level_data[old_pos] == 80 || level_data[old_pos] == 255) {
                         level_data[old_pos] = 0; // Clear the moving marker
                     }
@@ -1503,19 +2005,19 @@ void move_rocks() {
                     objects[r].y = objects[r].target_y;
 
                     // Place rock at new position
-                    level_data[objects[r].dx + objects[r].dy * LEVEL_WIDTH] = 3;
+                    level_data[objects[r].dx + objects[r].dy * level_width] = 3;
                     objects[r].l = 1; // Rock is stationary again
-                    ESP_LOGI("gravity", "Rock moved to (%d,%d)", objects[r].dx, objects[r].dy);
+                    BINLOG_I("gravity", "Rock moved to (%d,%d)", objects[r].dx, objects[r].dy);
 
                     // Check if rock can continue falling (based on original logic)
-                    if (objects[r].dy < LEVEL_HEIGHT - 1) {
-                        int below_pos = objects[r].dx + (objects[r].dy + 1) * LEVEL_WIDTH;
+                    if (objects[r].dy < level_height - 1) {
+                        int below_pos = objects[r].dx + (objects[r].dy + 1) * level_width;
                         int d = level_data[below_pos];
                         
                         // Only continue falling if destination is clear
                         if (d == 0 || d == 81) {
                             // Check if player is directly below (don't crush player immediately)
-                            bool player_below = (objects[r].dx == objects[0].dx && objects[r].dy == objects[0].dy - 1);
+                            bool player_below = is_player_at(objects[r].dx, objects[r].dy + 1);
                             if (!player_below) {
                                 // Continue falling immediately - set up next fall
                                 objects[r].movement_start_time = current_time; // Start next fall immediately
@@ -1528,11 +2030,14 @@ void move_rocks() {
                                 objects[r].target_dy = objects[r].dy + 1;
                                 objects[r].target_x = objects[r].dx * 16 + 8;
                                 objects[r].target_y = (objects[r].dy + 1) * 16 + 8;
-                                level_data[objects[r].dx + objects[r].dy * LEVEL_WIDTH] = 80; // Mark old pos as moving
-                                ESP_LOGI("gravity", "Rock continues falling from (%d,%d)", objects[r].dx, objects[r].dy);
+                                level_data[objects[r].dx + objects[r].dy * level_width] = 80; // Mark old pos as moving
+                                BINLOG_I("gravity", "Rock continues falling from (%d,%d)", objects[r].dx, objects[r].dy);
                             }
                         } else {
-                            ESP_LOGI("gravity", "Rock stopped at (%d,%d) - blocked by tile %d", objects[r].dx, objects[r].dy, d);
+                            BINLOG_I("gravity", "Rock stopped at (%d,%d) - blocked by tile %d", objects[r].dx, objects[r].dy, d);
+                            if (was_falling) {
+                                screen_fx_shake(2, 150); // Landing thud
+                            }
                         }
                     }
                 } else {
@@ -1572,19 +2077,13 @@ void move_block() {
             objects[15].l = 0; // Deactivate object, level tile takes over
             
             // Ensure level data is set correctly at final position
-            level_data[objects[15].dx + objects[15].dy * LEVEL_WIDTH] = 11;
+            level_data[objects[15].dx + objects[15].dy * level_width] = 11;
             
-            ESP_LOGI("stone_block", "Stone block movement completed at (%d,%d) - object deactivated, level tile active", 
+            BINLOG_I("stone_block", "Stone block movement completed at (%d,%d) - object deactivated, level tile active", 
                      objects[15].dx, objects[15].dy);
             
-            // Immediately draw the stone block tile at its final position to prevent flicker
-            SDL_SetRenderTarget(renderer, game_surface);
-            int tile = 11; // Stone block tile
-            int xx = tile % 16;
-            int yy = tile / 16; 
-            SDL_FRect src_rect = {(float)(xx * 16), (float)(yy * 16 + 16), 16.0f, 16.0f};
-            SDL_FRect dst_rect = {(float)(objects[15].dx * 16 + 8), (float)(objects[15].dy * 16 + 8), 16.0f, 16.0f};
-            SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+            // The tile takes over from the sprite in the same frame, so nothing flickers
+            emit_tile(objects[15].dx, objects[15].dy);
         } else {
             // Interpolate position during movement
             float progress = (float) elapsed / TILE_MOVEMENT_DURATION_US;
@@ -1609,15 +2108,15 @@ void move_type_hor(int e) {
         
         // Check if left position is available
         if (objects[e].dx > 0) {
-            int left_tile = level_data[(objects[e].dx - 1) + objects[e].dy * LEVEL_WIDTH];
+            int left_tile = level_data[(objects[e].dx - 1) + objects[e].dy * level_width];
             if (left_tile == 0 || left_tile == 81) {
                 pos_left = 1;
             }
         }
         
         // Check if right position is available
-        if (objects[e].dx < LEVEL_WIDTH - 1) {
-            int right_tile = level_data[(objects[e].dx + 1) + objects[e].dy * LEVEL_WIDTH];
+        if (objects[e].dx < level_width - 1) {
+            int right_tile = level_data[(objects[e].dx + 1) + objects[e].dy * level_width];
             if (right_tile == 0 || right_tile == 81) {
                 pos_right = 1;
             }
@@ -1654,7 +2153,7 @@ void move_type_hor(int e) {
             objects[e].is_moving = true;
             
             // Mark destination as occupied temporarily
-            level_data[objects[e].target_dx + objects[e].target_dy * LEVEL_WIDTH] = 81;
+            level_data[objects[e].target_dx + objects[e].target_dy * level_width] = 81;
         }
     } else {
         // Currently moving - update position
@@ -1666,7 +2165,7 @@ void move_type_hor(int e) {
             objects[e].is_moving = false;
             
             // Clear old position
-            level_data[objects[e].dx + objects[e].dy * LEVEL_WIDTH] = 0;
+            level_data[objects[e].dx + objects[e].dy * level_width] = 0;
             
             // Update to new position
             objects[e].dx = objects[e].target_dx;
@@ -1702,15 +2201,15 @@ void move_type_ver(int e) {
         
         // Check if up position is available
         if (objects[e].dy > 0) {
-            int up_tile = level_data[objects[e].dx + (objects[e].dy - 1) * LEVEL_WIDTH];
+            int up_tile = level_data[objects[e].dx + (objects[e].dy - 1) * level_width];
             if (up_tile == 0 || up_tile == 81) {
                 pos_up = 1;
             }
         }
         
         // Check if down position is available
-        if (objects[e].dy < LEVEL_HEIGHT - 1) {
-            int down_tile = level_data[objects[e].dx + (objects[e].dy + 1) * LEVEL_WIDTH];
+        if (objects[e].dy < level_height - 1) {
+            int down_tile = level_data[objects[e].dx + (objects[e].dy + 1) * level_width];
             if (down_tile == 0 || down_tile == 81) {
                 pos_down = 1;
             }
@@ -1747,7 +2246,7 @@ void move_type_ver(int e) {
             objects[e].is_moving = true;
             
             // Mark destination as occupied temporarily
-            level_data[objects[e].target_dx + objects[e].target_dy * LEVEL_WIDTH] = 81;
+            level_data[objects[e].target_dx + objects[e].target_dy * level_width] = 81;
         }
     } else {
         // Currently moving - update position
@@ -1759,7 +2258,7 @@ void move_type_ver(int e) {
             objects[e].is_moving = false;
             
             // Clear old position
-            level_data[objects[e].dx + objects[e].dy * LEVEL_WIDTH] = 0;
+            level_data[objects[e].dx + objects[e].dy * level_width] = 0;
             
             // Update to new position
             objects[e].dx = objects[e].target_dx;
@@ -1791,9 +2290,19 @@ void move_type_ghost(int e) {
     }
     
     if (!objects[e].is_moving) {
-        // Simple AI: try to move toward player, but still respect walls
+        // Simple AI: try to move toward the nearest player, but still respect walls
         int dx_diff = objects[0].dx - objects[e].dx;
         int dy_diff = objects[0].dy - objects[e].dy;
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+        if (player_count == 2 && objects[PLAYER2].l) {
+            int dx2 = objects[PLAYER2].dx - objects[e].dx;
+            int dy2 = objects[PLAYER2].dy - objects[e].dy;
+            if (abs(dx2) + abs(dy2) < abs(dx_diff) + abs(dy_diff)) {
+                dx_diff = dx2;
+                dy_diff = dy2;
+            }
+        }
+#endif
         
         int preferred_dir = objects[e].dir; // Default to current direction
         
@@ -1814,7 +2323,7 @@ void move_type_ghost(int e) {
         switch (preferred_dir) {
             case LEFT:
                 if (objects[e].dx > 0) {
-                    int tile = level_data[(objects[e].dx - 1) + objects[e].dy * LEVEL_WIDTH];
+                    int tile = level_data[(objects[e].dx - 1) + objects[e].dy * level_width];
                     if (tile == 0 || tile == 81) {
                         target_dx = objects[e].dx - 1;
                         can_move = true;
@@ -1822,8 +2331,8 @@ void move_type_ghost(int e) {
                 }
                 break;
             case RIGHT:
-                if (objects[e].dx < LEVEL_WIDTH - 1) {
-                    int tile = level_data[(objects[e].dx + 1) + objects[e].dy * LEVEL_WIDTH];
+                if (objects[e].dx < level_width - 1) {
+                    int tile = level_data[(objects[e].dx + 1) + objects[e].dy * level_width];
                     if (tile == 0 || tile == 81) {
                         target_dx = objects[e].dx + 1;
                         can_move = true;
@@ -1832,7 +2341,7 @@ void move_type_ghost(int e) {
                 break;
             case UP:
                 if (objects[e].dy > 0) {
-                    int tile = level_data[objects[e].dx + (objects[e].dy - 1) * LEVEL_WIDTH];
+                    int tile = level_data[objects[e].dx + (objects[e].dy - 1) * level_width];
                     if (tile == 0 || tile == 81) {
                         target_dy = objects[e].dy - 1;
                         can_move = true;
@@ -1840,8 +2349,8 @@ void move_type_ghost(int e) {
                 }
                 break;
             case DOWN:
-                if (objects[e].dy < LEVEL_HEIGHT - 1) {
-                    int tile = level_data[objects[e].dx + (objects[e].dy + 1) * LEVEL_WIDTH];
+                if (objects[e].dy < level_height - 1) {
+                    int tile = level_data[objects[e].dx + (objects[e].dy + 1) * level_width];
                     if (tile == 0 || tile == 81) {
                         target_dy = objects[e].dy + 1;
                         can_move = true;
@@ -1862,7 +2371,7 @@ void move_type_ghost(int e) {
                 switch (dir) {
                     case LEFT:
                         if (objects[e].dx > 0) {
-                            int tile = level_data[(objects[e].dx - 1) + objects[e].dy * LEVEL_WIDTH];
+                            int tile = level_data[(objects[e].dx - 1) + objects[e].dy * level_width];
                             if (tile == 0 || tile == 81) {
                                 target_dx = objects[e].dx - 1;
                                 preferred_dir = LEFT;
@@ -1871,8 +2380,8 @@ void move_type_ghost(int e) {
                         }
                         break;
                     case RIGHT:
-                        if (objects[e].dx < LEVEL_WIDTH - 1) {
-                            int tile = level_data[(objects[e].dx + 1) + objects[e].dy * LEVEL_WIDTH];
+                        if (objects[e].dx < level_width - 1) {
+                            int tile = level_data[(objects[e].dx + 1) + objects[e].dy * level_width];
                             if (tile == 0 || tile == 81) {
                                 target_dx = objects[e].dx + 1;
                                 preferred_dir = RIGHT;
@@ -1882,7 +2391,7 @@ void move_type_ghost(int e) {
                         break;
                     case UP:
                         if (objects[e].dy > 0) {
-                            int tile = level_data[objects[e].dx + (objects[e].dy - 1) * LEVEL_WIDTH];
+                            int tile = level_data[objects[e].dx + (objects[e].dy - 1) * level_width];
                             if (tile == 0 || tile == 81) {
                                 target_dy = objects[e].dy - 1;
                                 preferred_dir = UP;
@@ -1891,8 +2400,8 @@ void move_type_ghost(int e) {
                         }
                         break;
                     case DOWN:
-                        if (objects[e].dy < LEVEL_HEIGHT - 1) {
-                            int tile = level_data[objects[e].dx + (objects[e].dy + 1) * LEVEL_WIDTH];
+                        if (objects[e].dy < level_height - 1) {
+                            int tile = level_data[objects[e].dx + (objects[e].dy + 1) * level_width];
                             if (tile == 0 || tile == 81) {
                                 target_dy = objects[e].dy + 1;
                                 preferred_dir = DOWN;
@@ -1918,7 +2427,7 @@ void move_type_ghost(int e) {
             objects[e].is_moving = true;
             
             // Mark destination as occupied temporarily
-            level_data[target_dx + target_dy * LEVEL_WIDTH] = 81;
+            level_data[target_dx + target_dy * level_width] = 81;
         }
     } else {
         // Currently moving - update position
@@ -1930,7 +2439,7 @@ void move_type_ghost(int e) {
             objects[e].is_moving = false;
             
             // Clear old position
-            level_data[objects[e].dx + objects[e].dy * LEVEL_WIDTH] = 0;
+            level_data[objects[e].dx + objects[e].dy * level_width] = 0;
             
             // Update to new position
             objects[e].dx = objects[e].target_dx;
@@ -1979,8 +2488,9 @@ void check_overlap(int i) {
     int sy = objects[i].y;
     
     // Check collision with rocks (5-14) if this is an enemy
-    int start_check = (i == 0) ? 5 : 1; // Player checks rocks, enemies check player
-    int end_check = (i == 0) ? 15 : 1;
+    bool is_player = is_player_object(i);
+    int start_check = is_player ? 5 : 1; // Player checks rocks, enemies check player
+    int end_check = is_player ? 15 : 1;
     
     for (int c = start_check; c < end_check; c++) {
         if (objects[c].l && i != c) {
@@ -1989,18 +2499,20 @@ void check_overlap(int i) {
             
             // Check if sprites overlap (using 13 pixel threshold like original)
             if (abs(sx1 - sx) < 13 && abs(sy1 - sy) < 13) {
-                if (i == 0) {
+                if (is_player) {
                     // Player hit something
                     if (c >= 1 && c <= 4) {
                         // Player hit enemy - player dies
                         dead = 1;
-                        ESP_LOGI("collision", "Player hit enemy %d!", c);
+                        dead_player = i;
+                        BINLOG_I("collision", "Player hit enemy %d!", c);
                     }
                 } else {
                     // Enemy hit player - player dies
-                    if (c == 0) {
+                    if (is_player_object(c)) {
                         dead = 1;
-                        ESP_LOGI("collision", "Enemy %d hit player!", i);
+                        dead_player = c;
+                        BINLOG_I("collision", "Enemy %d hit player!", i);
                     }
                 }
             }
@@ -2013,6 +2525,11 @@ void check_collision(void) {
     for (int e = 0; e < 5; e++) {
         check_overlap(e);
     }
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    if (player_count == 2) {
+        check_overlap(PLAYER2);
+    }
+#endif
 }
 
 // Render game objects with optimized rendering
@@ -2052,7 +2569,7 @@ void print_objects() {
                         // Log enemy positions for debugging
                         static int debug_enemy_counter = 0;
                         if ((++debug_enemy_counter % 300) == nc) { // Log every 5 seconds per enemy
-                            ESP_LOGI("enemy_render", "Enemy %d (type %d) at (%d,%d) sprite(%d,%d)", 
+                            BINLOG_I("enemy_render", "Enemy %d (type %d) at (%d,%d) sprite(%d,%d)", 
                                      nc, objects[nc].l, objects[nc].dx, objects[nc].dy, objects[nc].sx, objects[nc].sy);
                         }
                     }
@@ -2060,19 +2577,13 @@ void print_objects() {
 }
 
 // Tile-based player movement with continuous smooth sliding
-void move_player() {
-    // Always update position first
-    update_player_position();
-
-    // If still moving, don't start new movement
-    if (objects[0].is_moving) {
-        return;
-    }
-
+// Escape, the F2/F3 level skip keys and -/= for the volume; returns true if this frame's input was consumed
+bool handle_global_keys() {
     // Handle escape key
     if (keyboard_state[SDL_SCANCODE_ESCAPE]) {
         dead = 1;
-        return;
+        dead_player = 0;
+        return true;
     }
 
     // Handle level navigation keys for testing
@@ -2087,50 +2598,84 @@ void move_player() {
             ESP_LOGI("debug", "F2 pressed - moving to previous level %d", level);
         }
         f2_pressed = true;
-        return;
+        return true;
     } else if (!keyboard_state[SDL_SCANCODE_F2]) {
         f2_pressed = false;
     }
     
     if (keyboard_state[SDL_SCANCODE_F3] && !f3_pressed) {
         // Next level (F3) - only trigger once per press
-        if (level < 25) {
+        if (level < LAST_LEVEL) {
             level++;
             level_change_requested = 1; // Set flag to indicate level change
             fruit = 0; // End current level
             ESP_LOGI("debug", "F3 pressed - moving to next level %d", level);
         }
         f3_pressed = true;
-        return;
+        return true;
     } else if (!keyboard_state[SDL_SCANCODE_F3]) {
         f3_pressed = false;
     }
 
+    // Volume in steps of 32, saved in the background so it survives a restart
+    static bool volume_pressed = false;
+    bool down = keyboard_state[SDL_SCANCODE_MINUS], up = keyboard_state[SDL_SCANCODE_EQUALS];
+    if ((down || up) && !volume_pressed) {
+        int volume = sfx_volume + (up ? 32 : -32);
+        sfx_volume = volume < 0 ? 0 : volume > 255 ? 255 : volume;
+        audio_set_volume(sfx_volume);
+        persist_settings_t settings;
+        persist_get_settings(&settings);
+        settings.volume = sfx_volume;
+        persist_set_settings(&settings);
+        ESP_LOGI("audio", "Volume %d", sfx_volume);
+        volume_pressed = true;
+    } else if (!down && !up) {
+        volume_pressed = false;
+    }
+
+    return false;
+}
+
+void move_player(int p) {
+    // Always update position first
+    update_player_position(p);
+
+    // If still moving, don't start new movement
+    if (objects[p].is_moving) {
+        return;
+    }
+
+    // Global keys and tilt control belong to player 1
+    if (p == 0 && handle_global_keys()) {
+        return;
+    }
+
     // Not currently moving - check for new movement input
-    int target_dx = objects[0].dx;
-    int target_dy = objects[0].dy;
+    int target_dx = objects[p].dx;
+    int target_dy = objects[p].dy;
     int direction = 0;
-    int sprite_sy = objects[0].sy; // Keep current sprite direction
+    int sprite_sy = objects[p].sy; // Keep current sprite direction
 
     // First check for accelerometer single moves (higher precision)
 #ifdef CONFIG_FRUITLAND_ACCELEROMETER_INPUT
-    int accel_move = accelerometer_get_pending_move();
+    int accel_move = (p == 0) ? accelerometer_get_pending_move() : 0;
     if (accel_move != 0) {
         // Process accelerometer move (dir_index + 1: LEFT=1, RIGHT=2, UP=3, DOWN=4)
-        if (accel_move == 3 && objects[0].dy > 0) { // UP
-            target_dy = objects[0].dy - 1;
+        if (accel_move == 3 && objects[p].dy > 0) { // UP
+            target_dy = objects[p].dy - 1;
             direction = UP;
             sprite_sy = 64;
-        } else if (accel_move == 4 && objects[0].dy < LEVEL_HEIGHT - 1) { // DOWN
-            target_dy = objects[0].dy + 1;
+        } else if (accel_move == 4 && objects[p].dy < level_height - 1) { // DOWN
+            target_dy = objects[p].dy + 1;
             direction = DOWN;
             sprite_sy = 80;
-        } else if (accel_move == 1 && objects[0].dx > 0) { // LEFT
-            target_dx = objects[0].dx - 1;
+        } else if (accel_move == 1 && objects[p].dx > 0) { // LEFT
+            target_dx = objects[p].dx - 1;
             direction = LEFT;
             sprite_sy = 32;
-        } else if (accel_move == 2 && objects[0].dx < LEVEL_WIDTH - 1) { // RIGHT
-            target_dx = objects[0].dx + 1;
+        } else if (accel_move == 2 && objects[p].dx < level_width - 1) { // RIGHT
+            target_dx = objects[p].dx + 1;
             direction = RIGHT;
             sprite_sy = 48;
         }
@@ -2141,20 +2686,20 @@ void move_player() {
 #endif
 
     // If no accelerometer move, check keyboard input (Arrow keys or WASD)
-    if (direction == 0 && (keyboard_state[SDL_SCANCODE_UP] || keyboard_state[SDL_SCANCODE_W]) && objects[0].dy > 0) {
-        target_dy = objects[0].dy - 1;
+    if (direction == 0 && player_key(p, UP) && objects[p].dy > 0) {
+        target_dy = objects[p].dy - 1;
         direction = UP;
         sprite_sy = 64; // Up-facing sprite
-    } else if ((keyboard_state[SDL_SCANCODE_DOWN] || keyboard_state[SDL_SCANCODE_S]) && objects[0].dy < LEVEL_HEIGHT - 1) {
-        target_dy = objects[0].dy + 1;
+    } else if (direction == 0 && player_key(p, DOWN) && objects[p].dy < level_height - 1) {
+        target_dy = objects[p].dy + 1;
         direction = DOWN;
         sprite_sy = 80; // Down-facing sprite
-    } else if ((keyboard_state[SDL_SCANCODE_LEFT] || keyboard_state[SDL_SCANCODE_A]) && objects[0].dx > 0) {
-        target_dx = objects[0].dx - 1;
+    } else if (direction == 0 && player_key(p, LEFT) && objects[p].dx > 0) {
+        target_dx = objects[p].dx - 1;
         direction = LEFT;
         sprite_sy = 32; // Left-facing sprite
-    } else if ((keyboard_state[SDL_SCANCODE_RIGHT] || keyboard_state[SDL_SCANCODE_D]) && objects[0].dx < LEVEL_WIDTH - 1) {
-        target_dx = objects[0].dx + 1;
+    } else if (direction == 0 && player_key(p, RIGHT) && objects[p].dx < level_width - 1) {
+        target_dx = objects[p].dx + 1;
         direction = RIGHT;
         sprite_sy = 48; // Right-facing sprite
     }
@@ -2165,7 +2710,7 @@ void move_player() {
     }
 
     // Check if target tile is passable or pushable
-    int target_tile = level_data[target_dx + target_dy * LEVEL_WIDTH];
+    int target_tile = level_data[target_dx + target_dy * level_width];
 
     // Handle stone block pushing (type 11 = stone block) - Sokoban-style like original
     if (target_tile == 11) {
@@ -2178,18 +2723,18 @@ void move_player() {
             if (target_dx <= 0) return; // At left edge
             push_target_dx = target_dx - 1;
         } else if (direction == RIGHT) {
-            if (target_dx >= LEVEL_WIDTH - 1) return; // At right edge  
+            if (target_dx >= level_width - 1) return; // At right edge  
             push_target_dx = target_dx + 1;
         } else if (direction == UP) {
             if (target_dy <= 0) return; // At top edge
             push_target_dy = target_dy - 1;
         } else if (direction == DOWN) {
-            if (target_dy >= LEVEL_HEIGHT - 1) return; // At bottom edge
+            if (target_dy >= level_height - 1) return; // At bottom edge
             push_target_dy = target_dy + 1;
         }
         
         // Check if push destination is free (basic Sokoban rule)
-        int destination_tile = level_data[push_target_dx + push_target_dy * LEVEL_WIDTH];
+        int destination_tile = level_data[push_target_dx + push_target_dy * level_width];
         if (destination_tile != 0) {
             ESP_LOGD("stone_push", "Stone block destination (%d,%d) blocked by tile %d", 
                      push_target_dx, push_target_dy, destination_tile);
@@ -2197,13 +2742,13 @@ void move_player() {
         }
         
         // Stone block push is allowed - set up object 15 movement
-        ESP_LOGI("stone_push", "Pushing stone block %s from (%d,%d) to (%d,%d)",
-                 (direction == LEFT) ? "left" : (direction == RIGHT) ? "right" :
-                 (direction == UP) ? "up" : "down",
+        BINLOG_I("stone_push", "Pushing stone block %s from (%d,%d) to (%d,%d)",
+                 BINLOG_STR((direction == LEFT) ? "left" : (direction == RIGHT) ? "right" :
+                            (direction == UP) ? "up" : "down"),
                  target_dx, target_dy, push_target_dx, push_target_dy);
         
         // Clear old stone block position
-        level_data[target_dx + target_dy * LEVEL_WIDTH] = 0;
+        level_data[target_dx + target_dy * level_width] = 0;
         
         // Set up object 15 (stone block) movement
         objects[15].l = 1; // Activate stone block object
@@ -2220,7 +2765,7 @@ void move_player() {
         objects[15].dir = direction;
         
         // Place stone block at destination in level data
-        level_data[push_target_dx + push_target_dy * LEVEL_WIDTH] = 11;
+        level_data[push_target_dx + push_target_dy * level_width] = 11;
         
         // Player can move into the stone block's old position
     } else if (target_tile == 3) {
@@ -2240,7 +2785,7 @@ void move_player() {
             if (target_dx <= 0) return; // At left edge, cannot push
             push_target_dx = target_dx - 1;
         } else if (direction == RIGHT) {
-            if (target_dx >= LEVEL_WIDTH - 1) return; // At right edge, cannot push
+            if (target_dx >= level_width - 1) return; // At right edge, cannot push
             push_target_dx = target_dx + 1;
         } else if (direction == UP) {
             if (target_dy <= 0) return; // At top edge, cannot push
@@ -2252,7 +2797,7 @@ void move_player() {
         }
 
         // Check if push destination is free (basic Sokoban rule)
-        int destination_tile = level_data[push_target_dx + push_target_dy * LEVEL_WIDTH];
+        int destination_tile = level_data[push_target_dx + push_target_dy * level_width];
         if (destination_tile != 0) {
             ESP_LOGD("push", "Push destination (%d,%d) blocked by tile %d", push_target_dx, push_target_dy, destination_tile);
             return; // Destination blocked, cannot push
@@ -2261,8 +2806,8 @@ void move_player() {
         // Additional stability check for LEFT/RIGHT pushes (from original)
         if (direction == LEFT || direction == RIGHT) {
             // Check if rock would be stable after push (has support below)
-            if (push_target_dy < LEVEL_HEIGHT - 1) {
-                int below_target = level_data[push_target_dx + (push_target_dy + 1) * LEVEL_WIDTH];
+            if (push_target_dy < level_height - 1) {
+                int below_target = level_data[push_target_dx + (push_target_dy + 1) * level_width];
                 if (below_target == 0) {
                     ESP_LOGD("push", "Rock would be unsupported after push - blocking");
                     return; // Rock would fall, don't allow push
@@ -2271,13 +2816,13 @@ void move_player() {
         }
 
         // Push is allowed - set up rock movement (using time-based animation)
-        ESP_LOGI("push", "Pushing rock %s from (%d,%d) to (%d,%d)",
-                 (direction == LEFT) ? "left" : (direction == RIGHT) ? "right" :
-                 (direction == UP) ? "up" : "down",
+        BINLOG_I("push", "Pushing rock %s from (%d,%d) to (%d,%d)",
+                 BINLOG_STR((direction == LEFT) ? "left" : (direction == RIGHT) ? "right" :
+                            (direction == UP) ? "up" : "down"),
                  target_dx, target_dy, push_target_dx, push_target_dy);
 
         // Clear old rock position in level data
-        level_data[target_dx + target_dy * LEVEL_WIDTH] = 0;
+        level_data[target_dx + target_dy * level_width] = 0;
         
         // Set up rock movement animation
         objects[rock_idx].target_dx = push_target_dx;
@@ -2291,7 +2836,7 @@ void move_player() {
         objects[rock_idx].dir = direction;
 
         // Mark destination as reserved to prevent conflicts
-        level_data[push_target_dx + push_target_dy * LEVEL_WIDTH] = 255;
+        level_data[push_target_dx + push_target_dy * level_width] = 255;
         
         // Player can move into the rock's old position
     } else if (!is_passable(target_tile)) {
@@ -2300,25 +2845,25 @@ void move_player() {
     }
 
     // Start movement to target tile
-    objects[0].target_dx = target_dx;
-    objects[0].target_dy = target_dy;
-    objects[0].start_x = objects[0].x;
-    objects[0].start_y = objects[0].y;
-    objects[0].target_x = target_dx * 16 + 8;
-    objects[0].target_y = target_dy * 16 + 8;
-    objects[0].movement_start_time = get_time_us();
-    objects[0].is_moving = true;
-    objects[0].dir = direction;
+    objects[p].target_dx = target_dx;
+    objects[p].target_dy = target_dy;
+    objects[p].start_x = objects[p].x;
+    objects[p].start_y = objects[p].y;
+    objects[p].target_x = target_dx * 16 + 8;
+    objects[p].target_y = target_dy * 16 + 8;
+    objects[p].movement_start_time = get_time_us();
+    objects[p].is_moving = true;
+    objects[p].dir = direction;
 
     // Initialize enhanced animation state
-    objects[0].base_sy = sprite_sy; // Store base y-coordinate for this direction
-    objects[0].current_frame = 0; // Start with first animation frame
-    objects[0].last_anim_time = get_time_us(); // Reset animation timer
-    objects[0].sx = 0; // Will be updated by animation system
-    objects[0].sy = sprite_sy; // Will be updated by animation system
-
-    ESP_LOGI("movement", "Starting movement from (%d, %d) to (%d, %d)",
-             objects[0].dx, objects[0].dy, target_dx, target_dy);
+    objects[p].base_sy = sprite_sy; // Store base y-coordinate for this direction
+    objects[p].current_frame = 0; // Start with first animation frame
+    objects[p].last_anim_time = get_time_us(); // Reset animation timer
+    objects[p].sx = 0; // Will be updated by animation system
+    objects[p].sy = sprite_sy; // Will be updated by animation system
+
+    BINLOG_I("movement", "Starting movement from (%d, %d) to (%d, %d)",
+             objects[p].dx, objects[p].dy, target_dx, target_dy);
 }
 
 // Initialize pushable stone block sprite coordinates (object 15)
@@ -2333,22 +2878,693 @@ void init_block_sprite() {
     ESP_LOGD("init", "Stone block object 15 initialized and ready");
 }
 
-// Main game loop
-int game() {
-    level = 1;
-    lives = 3;
-    score = 0;
+// Draw a player sprite; player 2 shares the atlas frames with a colour tint
+void draw_player_sprite(int p, float x, float y) {
+    SDL_FRect src_rect = {objects[p].sx, objects[p].sy, 16, 16};
+    SDL_FRect dst_rect = {x, y, 16, 16};
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    if (p == PLAYER2) {
+        SDL_SetTextureColorMod(patterns_texture, 128, 255, 255);
+        SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+        SDL_SetTextureColorMod(patterns_texture, 255, 255, 255);
+        return;
+    }
+#endif
+    SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+}
 
-    while (level <= 25 && lives > 0) {
-        reset_level_drawing(); // Reset level drawing flag for new level
-        ESP_LOGI("game", "🎯 Starting Level %d (Lives: %d, Score: %d)", level, lives, score);
-        init_level_data();
-        print_level();
+// Advance the ghost one tick, facing it the way it moved; returns true if it changed
+bool update_ghost() {
+    int x, y;
+    if (!ghost_playback_tick(&x, &y)) {
+        bool was_visible = ghost_visible;
+        ghost_visible = false;
+        return was_visible;
+    }
+    bool moved = !ghost_visible || x != ghost_x || y != ghost_y;
+    if (ghost_visible) {
+        if (y < ghost_y) ghost_sy = 64;
+        else if (y > ghost_y) ghost_sy = 80;
+        else if (x < ghost_x) ghost_sy = 32;
+        else if (x > ghost_x) ghost_sy = 48;
+    }
+    ghost_x = x;
+    ghost_y = y;
+    ghost_visible = true;
+    return moved;
+}
+
+// The ghost is the player sprite drawn translucent through the texture alpha mod
+void draw_ghost_sprite(float x, float y) {
+    SDL_FRect src_rect = {0, ghost_sy, 16, 16};
+    SDL_FRect dst_rect = {x, y, 16, 16};
+    SDL_SetTextureBlendMode(patterns_texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureAlphaMod(patterns_texture, 96);
+    SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+    SDL_SetTextureAlphaMod(patterns_texture, 255);
+    SDL_SetTextureBlendMode(patterns_texture, SDL_BLENDMODE_NONE);
+}
+
+// Position and width of each HUD number
+static const struct {
+    int x, y, digits;
+} hud_fields[] = {
+    [RCMD_HUD_SCORE] = {64, 192, 8},
+    [RCMD_HUD_TIME] = {64, 200, 4},
+    [RCMD_HUD_LEVEL] = {232, 192, 2},
+    [RCMD_HUD_LIVES] = {232, 200, 2},
+};
+
+// SDL backend: executes render commands into the game surface
+static void sdl_execute(const rcmd_t *cmds, int count) {
+    SDL_SetRenderTarget(renderer, game_surface);
+    for (int i = 0; i < count; i++) {
+        const rcmd_t *c = &cmds[i];
+        switch (c->type) {
+            case RCMD_LEVEL:
+                clear_game_surface();
+                draw_border();
+                draw_level();
+                draw_texts();
+                mark_full_update();
+                SDL_SetRenderTarget(renderer, game_surface);
+                break;
+            case RCMD_TILE:
+                draw_tile_code(c->x, c->y, c->tile.code, c->tile.hidden);
+                mark_area_dirty(c->y * 16 + 8, 16);
+                break;
+            case RCMD_ERASE: {
+                SDL_FRect rect = {c->x, c->y, 16, 16};
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+                SDL_RenderFillRect(renderer, &rect);
+                break;
+            }
+            case RCMD_RESTORE: {
+                SDL_Rect rect = {c->x, c->y, c->rect.w, c->rect.h};
+                redraw_level_region(&rect);
+                break;
+            }
+            case RCMD_SPRITE: {
+                SDL_FRect src_rect = {c->sprite.sx, c->sprite.sy, 16, 16};
+                SDL_FRect dst_rect = {c->x, c->y, 16, 16};
+                if (c->sprite.kind == RCMD_SPRITE_PLAYER2) {
+                    SDL_SetTextureColorMod(patterns_texture, 128, 255, 255); // Player 2 tint
+                }
+                if (c->sprite.alpha < 255) {
+                    SDL_SetTextureBlendMode(patterns_texture, SDL_BLENDMODE_BLEND);
+                    SDL_SetTextureAlphaMod(patterns_texture, c->sprite.alpha);
+                    mark_area_dirty(c->y, 16);
+                }
+                SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+                if (c->sprite.alpha < 255) {
+                    SDL_SetTextureAlphaMod(patterns_texture, 255);
+                    SDL_SetTextureBlendMode(patterns_texture, SDL_BLENDMODE_NONE);
+                }
+                if (c->sprite.kind == RCMD_SPRITE_PLAYER2) {
+                    SDL_SetTextureColorMod(patterns_texture, 255, 255, 255);
+                }
+                break;
+            }
+            case RCMD_PARTICLES:
+                particles_draw(renderer);
+                mark_area_dirty(c->y, c->rect.h);
+                break;
+            case RCMD_HUD:
+                print_number(hud_fields[c->hud.field].x, hud_fields[c->hud.field].y, c->hud.value,
+                             hud_fields[c->hud.field].digits);
+                break;
+        }
+    }
+}
+
+static const rcmd_backend_t sdl_backend = {
+    .name = "sdl",
+    .execute = sdl_execute,
+};
+
+#ifdef CONFIG_IDF_TARGET_ESP32P4
+// Direct framebuffer backend: atlas tiles through the tile cache, flat-colour sprites, handed to the draw task
+static void fb_execute(const rcmd_t *cmds, int count) {
+    static const uint8_t sprite_rgb[][3] = {
+        [RCMD_SPRITE_PLAYER] = {255, 255, 0},
+        [RCMD_SPRITE_PLAYER2] = {0, 255, 255},
+        [RCMD_SPRITE_ROCK] = {139, 69, 19},
+        [RCMD_SPRITE_BLOCK] = {128, 128, 128},
+    };
+
+    xSemaphoreTake(fb_mutex, portMAX_DELAY);
+    for (int i = 0; i < count; i++) {
+        const rcmd_t *c = &cmds[i];
+        switch (c->type) {
+            case RCMD_LEVEL:
+                fb_clear(rgb_to_rgb565(0, 0, 0));
+                for (int y = 0; y < level_height; y++) {
+                    for (int x = 0; x < level_width; x++) {
+                        fb_draw_level_tile(x, y, level_data[y * level_width + x]);
+                    }
+                }
+                break;
+            case RCMD_TILE:
+                fb_draw_rect(c->x * 16 + 8, c->y * 16 + 8, 16, 16, rgb_to_rgb565(0, 0, 0));
+                if (!c->tile.hidden) {
+                    fb_draw_level_tile(c->x, c->y, c->tile.code);
+                }
+                break;
+            case RCMD_ERASE:
+                fb_draw_rect(c->x, c->y, 16, 16, rgb_to_rgb565(0, 0, 0));
+                break;
+            case RCMD_RESTORE: {
+                int tx0 = (c->x - 8) / 16, tx1 = (c->x + c->rect.w - 9) / 16;
+                int ty0 = (c->y - 8) / 16, ty1 = (c->y + c->rect.h - 9) / 16;
+                for (int ty = ty0; ty <= ty1; ty++) {
+                    for (int tx = tx0; tx <= tx1; tx++) {
+                        if (tx >= 0 && tx < level_width && ty >= 0 && ty < level_height) {
+                            fb_draw_rect(tx * 16 + 8, ty * 16 + 8, 16, 16, rgb_to_rgb565(0, 0, 0));
+                            fb_draw_level_tile(tx, ty, level_data[ty * level_width + tx]);
+                        }
+                    }
+                }
+                break;
+            }
+            case RCMD_SPRITE:
+                if (c->sprite.kind != RCMD_SPRITE_GHOST) { // No blending in the flat-colour path
+                    const uint8_t *rgb = sprite_rgb[c->sprite.kind];
+                    fb_draw_rect(c->x, c->y, 16, 16, rgb_to_rgb565(rgb[0], rgb[1], rgb[2]));
+                }
+                break;
+            case RCMD_PARTICLES:
+                particles_draw_rgb565(framebuf[current_fb], GAME_WIDTH, GAME_WIDTH, GAME_HEIGHT);
+                break;
+            case RCMD_HUD:
+                break; // The framebuffer path has no HUD yet
+        }
+    }
+
+    // LUT is rebuilt here, under fb_mutex, only when the effect transform changed
+    fb_fx_lut = screen_fx_lut();
+    fb_ready = false;
+    xSemaphoreGive(fb_mutex);
+
+    // Trigger display update
+    fb_present();
+}
+
+static const rcmd_backend_t fb_backend = {
+    .name = "direct-fb",
+    .execute = fb_execute,
+};
+#endif
+
+#if defined(CONFIG_FRUITLAND_LOW_MEMORY) || defined(CONFIG_FRUITLAND_NATIVE_SCALE)
+// Atlas copy of a software compositor, clipped to the region it is composing
+typedef void (*atlas_blit_fn)(int x, int y, int sx, int sy, int w, int h);
+
+// Text in the patterns font: letters on atlas row 0, ':' and digits on row 8
+static void compose_text(atlas_blit_fn blit, int x, int y, const char *s) {
+    for (; *s; s++, x += 8) {
+        if (*s == ':') {
+            blit(x, y, 128, 8, 8, 8);
+        } else if (*s >= 'A' && *s <= 'Z') {
+            blit(x, y, (*s - 65) * 8 + 48, 0, 8, 8);
+        }
+    }
+}
+
+static void compose_number(atlas_blit_fn blit, int field, int n) {
+    int px = hud_fields[field].x + 8 * (hud_fields[field].digits - 1);
+    for (int c = 0; c < hud_fields[field].digits; c++, px -= 8, n /= 10) {
+        blit(px, hud_fields[field].y, (n % 10) * 8 + 48, 8, 8, 8);
+    }
+}
+
+// Border, level cells and HUD in rows y0..y1-1; the compositors add sprites and particles
+static void compose_static(atlas_blit_fn blit, int y0, int y1) {
+    // Border, as draw_border()
+    for (int x = 8; x < 248; x += 16) {
+        blit(x, 0, 16, 0, 16, 8);
+        blit(x, 184, 16, 8, 16, 8);
+    }
+    for (int y = 8; y < 184; y += 16) {
+        blit(0, y, 0, 0, 8, 16);
+        blit(248, y, 8, 0, 8, 16);
+    }
+    blit(0, 0, 32, 0, 8, 8);
+    blit(0, 184, 40, 0, 8, 8);
+    blit(248, 0, 32, 8, 8, 8);
+    blit(248, 184, 40, 8, 8, 8);
+
+    // Level cells in these rows (no bobbing or shading on this path)
+    int ty0 = y0 < 8 ? 0 : (y0 - 8) / 16, ty1 = (y1 - 1 - 8) / 16;
+    for (int ty = ty0; ty <= ty1 && ty < level_height; ty++) {
+        for (int tx = 0; tx < level_width; tx++) {
+            int tile = level_data[ty * level_width + tx];
+            if (tile == 0 || !fov_is_visible(tx, ty)) continue;
+            tile_anim_frame_t frame = tile_anim_frame(tile, tx, ty);
+            blit(tx * 16 + 8, ty * 16 + 8, frame.atlas_x, frame.atlas_y, 16, 16);
+        }
+    }
+
+    // HUD labels and values
+    if (y0 < 208 && y1 > 192) {
+        compose_text(blit, 8, 192, "SCORE:");
+        compose_text(blit, 8, 200, "TIME :");
+        compose_text(blit, 176, 192, "LEVEL:");
+        compose_text(blit, 176, 200, "LIVES:");
+        compose_number(blit, RCMD_HUD_SCORE, score);
+        compose_number(blit, RCMD_HUD_TIME, av_time);
+        compose_number(blit, RCMD_HUD_LEVEL, level);
+        compose_number(blit, RCMD_HUD_LIVES, lives);
+    }
+}
+
+#endif
+
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+static void band_compose(int y0, int lines) {
+    compose_static(band_blit, y0, y0 + lines);
+}
+
+#ifdef CONFIG_FRUITLAND_PANEL_DIRECT
+// Bands are already in the panel's byte order: straight to the panel, effects applied in software
+static void band_present(uint16_t *band, int y0, int lines) {
+    panel_out_band(band, GAME_WIDTH, GAME_HEIGHT, y0, lines);
+}
+#else
+// Upload a band and draw it scaled into its rows of the window, with screen effects and offset.
+// Every band is presented when the effects change, so the frame never moves in pieces.
+static void band_present(uint16_t *band, int y0, int lines) {
+    static SDL_FRect last_rect;
+    static SDL_FRect frame_rect;
+    float scale_x = (float) SCREEN_WIDTH / GAME_WIDTH;
+    float scale_y = (float) SCREEN_HEIGHT / GAME_HEIGHT;
+    float scale = (scale_x < scale_y) ? scale_x : scale_y;
+
+    if (y0 == 0) {
+        float dx, dy;
+        screen_offset(scale, &dx, &dy);
+        SDL_FRect home_rect = {(SCREEN_WIDTH - GAME_WIDTH * scale) / 2, (SCREEN_HEIGHT - GAME_HEIGHT * scale) / 2,
+                               GAME_WIDTH * scale, GAME_HEIGHT * scale};
+        frame_rect = offset_rect(&home_rect, dx, dy, &last_rect);
+    }
+
+    SDL_Rect src = {0, 0, GAME_WIDTH, lines};
+    SDL_UpdateTexture(band_texture, &src, band, GAME_WIDTH * sizeof(uint16_t));
+
+    SDL_FRect src_rect = {0, 0, GAME_WIDTH, lines};
+    SDL_FRect dst_rect = {frame_rect.x, frame_rect.y + y0 * scale, frame_rect.w, lines * scale};
+    render_with_fx(band_texture, &src_rect, &dst_rect);
+}
+#endif
+
+esp_err_t init_band_render() {
+#ifndef CONFIG_FRUITLAND_PANEL_DIRECT
+    band_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING,
+                                     GAME_WIDTH, BAND_LINES);
+    if (!band_texture) {
+        printf("Failed to create band texture: %s\n", SDL_GetError());
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+    band_render_config_t config = {
+        .width = GAME_WIDTH,
+        .height = GAME_HEIGHT,
+        .cell_y0 = 8,
+        .hud_y = 192,
+        .hud_h = 16,
+        .compose = band_compose,
+        .present = band_present,
+    };
+    return band_render_init(&config);
+}
+
+// Internal RAM in use now and at its peak, and the game thread's unused stack
+void log_memory_footprint(const char *stage) {
+    size_t total = heap_caps_get_total_size(MALLOC_CAP_INTERNAL);
+    size_t free_now = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t free_min = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    ESP_LOGI("memory", "🧠 %s: internal heap %u/%u KB used, peak %u KB, largest free block %u KB, "
+             "stack headroom %u bytes of %d", stage, (unsigned) ((total - free_now) / 1024), (unsigned) (total / 1024),
+             (unsigned) ((total - free_min) / 1024), (unsigned) (heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL) / 1024),
+             (unsigned) uxTaskGetStackHighWaterMark(NULL), CONFIG_FRUITLAND_GAME_STACK_SIZE);
+}
+#endif
+
+#ifdef CONFIG_FRUITLAND_NATIVE_SCALE
+static void native_compose(int x, int y, int w, int h) {
+    compose_static(native_blit, y, y + h);
+}
+
+// Upload the recomposed spans and draw the native frame 1:1, centred in the window. Tiled
+// spans are single cells with the cell width as pitch, linearized by the upload itself.
+// A turned frame is already in panel orientation and is drawn as it is, its offset turned with it.
+static void native_present(const native_span_t *spans, int count) {
+    static SDL_FRect last_rect;
+    for (int i = 0; i < count; i++) {
+        SDL_Rect rect = {spans[i].rect.x, spans[i].rect.y, spans[i].rect.w, spans[i].rect.h};
+        SDL_UpdateTexture(native_texture, &rect, spans[i].pixels, spans[i].pitch * sizeof(uint16_t));
+    }
+    float w = GAME_WIDTH * native_scale, h = GAME_HEIGHT * native_scale;
+    float dx, dy;
+    screen_offset(native_scale, &dx, &dy);
+    if (native_rotated) {
+        // Clockwise: game right is panel down, game down is panel left
+        w = GAME_HEIGHT * native_scale;
+        h = GAME_WIDTH * native_scale;
+        float turned_dx = -dy;
+        dy = dx;
+        dx = turned_dx;
+    }
+    SDL_FRect home_rect = {(SCREEN_WIDTH - w) / 2, (SCREEN_HEIGHT - h) / 2, w, h};
+    SDL_FRect dst_rect = offset_rect(&home_rect, dx, dy, &last_rect);
+    render_with_fx(native_texture, NULL, &dst_rect);
+}
+
+// Compose at the configured integer scale, or the largest one that fits the panel
+esp_err_t init_native_render() {
+    int fit_x = SCREEN_WIDTH / GAME_WIDTH, fit_y = SCREEN_HEIGHT / GAME_HEIGHT;
+    int fit = fit_x < fit_y ? fit_x : fit_y;
+    if (fit > NATIVE_MAX_SCALE) fit = NATIVE_MAX_SCALE;
+    bool rotate = false;
+#ifdef CONFIG_FRUITLAND_NATIVE_ROTATE
+    // Portrait panel: turn the frame when that allows a larger scale
+    int turned_x = SCREEN_WIDTH / GAME_HEIGHT, turned_y = SCREEN_HEIGHT / GAME_WIDTH;
+    int turned = turned_x < turned_y ? turned_x : turned_y;
+    if (turned > NATIVE_MAX_SCALE) turned = NATIVE_MAX_SCALE;
+    if (turned > fit) {
+        fit = turned;
+        rotate = true;
+    }
+#endif
+    int s = CONFIG_FRUITLAND_NATIVE_SCALE_FACTOR ? CONFIG_FRUITLAND_NATIVE_SCALE_FACTOR : fit;
+    if (s > fit) {
+        ESP_LOGW("render", "%dx does not fit %dx%d, composing at %dx", s, SCREEN_WIDTH, SCREEN_HEIGHT, fit);
+        s = fit;
+    }
+    if (s < 1) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    native_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING,
+                                       (rotate ? GAME_HEIGHT : GAME_WIDTH) * s, (rotate ? GAME_WIDTH : GAME_HEIGHT) * s);
+    if (!native_texture) {
+        printf("Failed to create native frame texture: %s\n", SDL_GetError());
+        return ESP_ERR_NO_MEM;
+    }
+    native_render_config_t config = {
+        .width = GAME_WIDTH,
+        .height = GAME_HEIGHT,
+        .scale = s,
+#ifdef CONFIG_FRUITLAND_NATIVE_TILED
+        .tiled = true,
+#endif
+        .rotate = rotate,
+        .atlas_w = 256,
+        .atlas_h = 256,
+        .cell_x0 = 8,
+        .cell_y0 = 8,
+        .compose = native_compose,
+        .present = native_present,
+    };
+    for (int f = RCMD_HUD_SCORE; f <= RCMD_HUD_LIVES; f++) {
+        config.hud[f] = (native_rect_t) {hud_fields[f].x, hud_fields[f].y, hud_fields[f].digits * 8, 8};
+    }
+    esp_err_t err = native_render_init(&config);
+    if (err != ESP_OK) {
+        SDL_DestroyTexture(native_texture);
+        native_texture = NULL;
+        return err;
+    }
+    native_scale = s;
+    native_rotated = rotate;
+    return ESP_OK;
+}
+#endif
+
+// Backends that recompose regions from each frame's command list instead of drawing into the game surface
+static bool backend_composes_frames() {
+    return render_backend == &band_render_backend || render_backend == &native_render_backend;
+}
+
+// Keep the frozen objects of the last frame on screen while the playfield is redrawn without them
+static void hold_composed_sprites(bool hold) {
+    if (render_backend == &band_render_backend) {
+        band_render_hold_sprites(hold);
+    } else if (render_backend == &native_render_backend) {
+        native_render_hold_sprites(hold);
+    }
+}
+
+// Pick the backend for render commands once the display path is known
+void select_render_backend() {
+#ifdef CONFIG_FRUITLAND_HEADLESS_RENDER
+    render_backend = &rcmd_null_backend;
+#elif defined(CONFIG_FRUITLAND_LOW_MEMORY)
+    render_backend = &band_render_backend;
+#elif defined(CONFIG_IDF_TARGET_ESP32P4)
+    render_backend = direct_framebuffer_mode ? &fb_backend : &sdl_backend;
+#ifdef CONFIG_FRUITLAND_NATIVE_SCALE
+    if (native_scale) {
+        render_backend = &native_render_backend;
+    }
+#endif
+#else
+    render_backend = &sdl_backend;
+#endif
+    ESP_LOGI("render", "Render backend: %s", render_backend->name);
+}
+
+// Scrolling levels: refresh each view's tile ring, compose it and draw objects relative to its camera.
+// With two players each follows its own player in one half of the playfield.
+void render_scrolled_playfield() {
+    int views = scroll_view_count();
+    int view_w = LEVEL_WIDTH * 16 / views;
+
+    for (int v = 0; v < views; v++) {
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+        int p = (v == 0) ? 0 : PLAYER2;
+#else
+        int p = 0;
+#endif
+        int view_x = 8 + v * view_w;
+        scroll_follow(v, objects[p].x, objects[p].y);
+        scroll_update(v);
+        scroll_compose(v, game_surface, view_x, 8);
+
+        int cam_x, cam_y;
+        scroll_get_camera(v, &cam_x, &cam_y);
+        int off_x = view_x - 8 - cam_x;
+        int off_y = -cam_y;
+        SDL_Rect clip = {view_x, 8, view_w, LEVEL_HEIGHT * 16};
+        SDL_SetRenderClipRect(renderer, &clip);
+
+        // Ghost first so every real object stays on top of it
+        if (ghost_visible) {
+            draw_ghost_sprite(ghost_x + off_x, ghost_y + off_y);
+        }
+
+        // Players, rocks and the stone block; enemies live in level_data like in the fixed view
+        for (int i = 0; i < MAX_OBJECTS; i++) {
+            if (!objects[i].l || (i >= 1 && i <= 4)) continue;
+            if (i >= 5 && i <= 15 && !fov_is_visible(objects[i].dx, objects[i].dy)) continue; // Rock or block in the fog
+            if (is_player_object(i)) {
+                draw_player_sprite(i, objects[i].x + off_x, objects[i].y + off_y);
+                continue;
+            }
+            SDL_FRect src_rect = {objects[i].sx, objects[i].sy, 16, 16};
+            if (i >= 5 && i < 15) {
+                src_rect.x = 48; // Rock sprite
+                src_rect.y = 16;
+            }
+            SDL_FRect dst_rect = {objects[i].x + off_x, objects[i].y + off_y, 16, 16};
+            SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
+        }
+
+        particles_set_origin(-off_x, -off_y);
+        particles_draw(renderer);
+    }
+    SDL_SetRenderClipRect(renderer, NULL);
+    mark_area_dirty(8, LEVEL_HEIGHT * 16);
+}
+
+// Let the death burst play out over the frozen playfield before the level restarts
+void play_death_effect() {
+    particles_spawn_burst(objects[dead_player].x + 8, objects[dead_player].y + 8, PARTICLE_BURST_DEATH);
+    screen_fx_flash(255, 64, 64, 400);
+    screen_fx_shake(4, 400);
+
+    // Last life: fade the playfield out under the burst
+    uint64_t fade_end = get_time_us();
+    if (lives == 0) {
+        screen_fx_fade(true, 600);
+        fade_end += 600000;
+    }
+
+    SDL_Rect prev_bounds;
+    bool prev_drawn = false;
+    bool composed = backend_composes_frames();
+    hold_composed_sprites(true); // Objects stay frozen on screen under the burst
+    while (particles_active() > 0 || get_time_us() < fade_end) {
+        bool fx_changed = screen_fx_update(get_time_us());
+        particles_update();
+        if (composed) {
+            // Only the particle area; the band compositor applies effects per band, so it
+            // redraws every band while a fade or flash is running
+            if (fx_changed && render_backend == &band_render_backend) {
+                rcmd_level();
+            } else if (prev_drawn) {
+                rcmd_restore(prev_bounds.x, prev_bounds.y, prev_bounds.w, prev_bounds.h);
+            }
+            prev_drawn = particles_get_bounds(&prev_bounds);
+            if (prev_drawn) {
+                rcmd_particles(prev_bounds.x, prev_bounds.y, prev_bounds.w, prev_bounds.h);
+            }
+            rcmd_submit(render_backend);
+            SDL_RenderPresent(renderer);
+            wait_for_frame_time();
+            continue;
+        }
+        if (scroll_is_active()) {
+            render_scrolled_playfield();
+        } else {
+            if (prev_drawn) {
+                redraw_level_region(&prev_bounds);
+            }
+            SDL_SetRenderTarget(renderer, game_surface);
+            particles_draw(renderer);
+            prev_drawn = particles_get_bounds(&prev_bounds);
+        }
+
+        render_frame_minimal();
+        SDL_RenderPresent(renderer);
+        wait_for_frame_time();
+    }
+    hold_composed_sprites(false);
+}
+
+#ifdef CONFIG_FRUITLAND_STATE_TRACE
+// Hash this tick's simulation state for the determinism trace. Only logical state is
+// included: timestamps and render-side fields (sprite frames) are left out.
+void trace_game_state() {
+    uint32_t parts[TRACE_PARTS];
+    parts[TRACE_PART_LEVEL] = trace_hash_bytes(TRACE_HASH_SEED, level_data, level_width * level_height);
+
+    uint32_t h = TRACE_HASH_SEED;
+    for (int i = 0; i < MAX_OBJECTS; i++) {
+        const OBJECT *o = &objects[i];
+        h = trace_hash_int(h, o->l);
+        h = trace_hash_int(h, o->dx);
+        h = trace_hash_int(h, o->dy);
+        h = trace_hash_int(h, o->x);
+        h = trace_hash_int(h, o->y);
+        h = trace_hash_int(h, o->dir);
+        h = trace_hash_int(h, o->step);
+        h = trace_hash_int(h, o->is_moving);
+        h = trace_hash_int(h, o->target_dx);
+        h = trace_hash_int(h, o->target_dy);
+    }
+    parts[TRACE_PART_OBJECTS] = h;
+
+    h = TRACE_HASH_SEED;
+    const int counters[] = {score, av_time, lives, level, fruit, dead, freeze_enemy, level_change_requested,
+                            player_count, level_width, level_height};
+    for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+        h = trace_hash_int(h, counters[i]);
+    }
+    parts[TRACE_PART_STATS] = h;
+
+    trace_tick(parts);
+}
+#endif
+
+// Autopilot: plan player 1's next move and present it through a synthetic keyboard state.
+// Returns false when a real key press ends attract mode.
+bool autopilot_drive() {
+    static bool keys[SDL_SCANCODE_COUNT];
+    int numkeys = 0;
+    const bool *real_keys = SDL_GetKeyboardState(&numkeys);
+#ifndef CONFIG_FRUITLAND_AUTOPILOT_ENDURANCE
+    for (int k = 0; k < numkeys; k++) {
+        if (real_keys[k]) {
+            return false;
+        }
+    }
+#else
+    (void) real_keys;
+#endif
+
+    memset(keys, 0, sizeof(keys));
+    // Moves are only read while the player stands on a tile; plan just then
+    if (objects[0].l && !objects[0].is_moving) {
+        autopilot_view_t view = {
+            .map = level_data,
+            .width = level_width,
+            .height = level_height,
+            .player_x = objects[0].dx,
+            .player_y = objects[0].dy,
+        };
+        for (int e = 1; e <= 4; e++) {
+            if (objects[e].l && view.enemies < AUTOPILOT_MAX_ENEMIES) {
+                view.enemy_x[view.enemies] = objects[e].dx;
+                view.enemy_y[view.enemies] = objects[e].dy;
+                view.enemies++;
+            }
+        }
+        switch (autopilot_plan(&view)) {
+            case AUTOPILOT_UP: keys[SDL_SCANCODE_UP] = true; break;
+            case AUTOPILOT_DOWN: keys[SDL_SCANCODE_DOWN] = true; break;
+            case AUTOPILOT_LEFT: keys[SDL_SCANCODE_LEFT] = true; break;
+            case AUTOPILOT_RIGHT: keys[SDL_SCANCODE_RIGHT] = true; break;
+            default: break;
+        }
+    }
+    keyboard_state = keys;
+    return true;
+}
+
+// Main game loop; returns 0 on quit, 1 when the game is over, 2 when a key interrupted attract mode
+int game() {
+    // Players start at the level picked on the intro; the demo always starts at the first
+    level = autopilot_mode ? 1 : start_level;
+    lives = 3;
+    score = 0;
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+    player_count = autopilot_mode ? 1 : 2; // Co-op: shared lives and score
+#endif
+#ifdef CONFIG_FRUITLAND_ENDLESS_MODE
+    levelgen_start(esp_random()); // Fresh endless sequence, generated ahead on the idle core
+#endif
+#ifdef CONFIG_FRUITLAND_STATE_TRACE
+    trace_begin(autopilot_mode ? "autopilot" : "player");
+#endif
+
+    while (level <= LAST_LEVEL && lives > 0) {
+        reset_level_drawing(); // Reset level drawing flag for new level
+        tile_cache_flush();    // Refills with this level's cells on first use
+        native_render_report(); // Bytes touched per frame in the last level, when composing at native scale
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+        log_memory_footprint("Level start");
+#endif
+        ESP_LOGI("game", "🎯 Starting Level %d (Lives: %d, Score: %d)", level, lives, score);
+        init_level_data();
+#ifdef CONFIG_FRUITLAND_FOG_OF_WAR
+        fov_set_map(level_data, level_width, level_height); // Everything starts hidden
+#endif
+        print_level();
         count_fruit();
         init_objects();
+        update_fog(true);
         dead = 0;
         freeze_enemy = 0;
         level_change_requested = 0; // Reset level change flag for new level
+        particles_clear();
+        particles_set_clip(8, 8, level_width * 16, level_height * 16);
+        particles_set_origin(0, 0);
+        screen_fx_reset();
+        screen_fx_fade(false, 300);
+        ghost_visible = false;
+        if (level <= 25 && !autopilot_mode) {
+            ghost_begin_level(level, objects[0].x, objects[0].y); // Generated levels have no stored best run
+        }
 
         // Calculate scaling factor once for ESP32-P4 PPA optimization
         static float cached_scale = 0;
@@ -2409,31 +3625,86 @@ int game() {
 #endif
 
             keyboard_state = SDL_GetKeyboardState(NULL);
+            if (autopilot_mode && !autopilot_drive()) {
+                return 2;
+            }
 
             // Store previous state for change detection
             static int prev_score = -1, prev_time = -1, prev_level = -1, prev_lives = -1;
             static int prev_player_x = -1, prev_player_y = -1;
+            static int prev_player2_x = -1, prev_player2_y = -1;
+            static SDL_Rect prev_ghost_rect; // Ghost drawn last frame, restored before redrawing
+            static bool prev_ghost_drawn = false;
             static int prev_rock_x[10] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
             static int prev_rock_y[10] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
             static int prev_block_x = -1, prev_block_y = -1; // Stone block position tracking
+            static SDL_Rect prev_particle_bounds; // Area covered by last frame's particles
+            static bool prev_particles_drawn = false;
             static bool first_render = true;
 
             // Update game state
-            move_player();
+            move_player(0);
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+            if (player_count == 2) {
+                move_player(PLAYER2);
+            }
+#endif
             move_rocks(); // Handle rock gravity and movement
             move_block(); // Handle pushable block movement
             move_enemy(); // Handle enemy movement
             check_collision(); // Check player-enemy collisions
+            particles_update(); // Advance pickup/teleport effects
+
+            // One ghost tick per game tick keeps the replay in step with the recording
+            ghost_record_tick(objects[0].x, objects[0].y);
+            bool ghost_moved = update_ghost();
+
+            // Animated tiles are redrawn before objects so sprites stay on top
+            bool tiles_animated = animate_level_tiles() > 0;
+
+            // Fog of war is recast only when sight lines can have changed
+            bool fog_changed = update_fog(false);
 
             // Decrease time every second (TARGET_FPS frames at target fps)
             static int time_counter = 0;
             if (++time_counter >= TARGET_FPS) {
                 av_time--;
                 time_counter = 0;
+                if (av_time > 0 && av_time <= 10) {
+                    screen_fx_flash(255, 0, 0, 300); // Time running out
+                }
             }
 
+#ifdef CONFIG_FRUITLAND_STATE_TRACE
+            trace_game_state(); // Simulation for this tick is complete
+#endif
+#ifdef CONFIG_FRUITLAND_QEMU_SMOKE
+            if (qemu_smoke_tick()) {
+                qemu_smoke_finish(renderer, game_surface, level, score); // Does not return
+            }
+#endif
+
+            // Icy tint while enemies are frozen; applied at scan-out, no redraw
+            if (freeze_enemy > 0) {
+                screen_fx_set_tint(160, 200, 255);
+            } else {
+                screen_fx_set_tint(255, 255, 255);
+            }
+            bool fx_changed = screen_fx_update(get_time_us());
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+            if (fx_changed) {
+                full_redraw_needed = true; // Effects are applied to each band as it is presented
+            }
+#endif
+
             // Detect what changed for tile-based movement optimization
             bool player_moved = (objects[0].x != prev_player_x || objects[0].y != prev_player_y);
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+            bool player2_moved = (player_count == 2 &&
+                                  (objects[PLAYER2].x != prev_player2_x || objects[PLAYER2].y != prev_player2_y));
+#else
+            bool player2_moved = false;
+#endif
             bool stats_changed = (score != prev_score || av_time != prev_time ||
                                   level != prev_level || lives != prev_lives);
 
@@ -2453,8 +3724,12 @@ int game() {
             bool block_moved = (objects[15].l && 
                                (objects[15].x != prev_block_x || objects[15].y != prev_block_y));
 
+            // Particles need a frame while alive and one more to erase the last positions
+            bool particles_changed = particles_active() > 0 || prev_particles_drawn;
+
             // Efficient rendering: only render when something actually changed
-            bool should_render = player_moved || rocks_moved || block_moved || stats_changed || first_render || full_redraw_needed;
+            bool should_render = player_moved || player2_moved || ghost_moved || rocks_moved || block_moved || particles_changed || tiles_animated || fog_changed ||
+                                 fx_changed || stats_changed || first_render || full_redraw_needed || rcmd_count() > 0;
 
             // Skip rendering if nothing changed
             if (!should_render) {
@@ -2465,69 +3740,102 @@ int game() {
             // Only render if absolutely necessary
             if (should_render) {
 #ifdef CONFIG_IDF_TARGET_ESP32P4
-                if (direct_framebuffer_mode) {
-                    // Use fast direct framebuffer rendering
-                    if (!fb_ready) {
-                        wait_for_frame_time();
-                        continue;
-                    }
+                if (direct_framebuffer_mode && !fb_ready) {
+                    wait_for_frame_time(); // Draw task still owns the framebuffer
+                    continue;
+                }
+#endif
+                // Describe the frame as render commands; the backend draws it in one pass.
+                // Past half a list of cell updates one full redraw costs about the same.
+                if (first_render || full_redraw_needed || rcmd_overflowed() || rcmd_count() > RCMD_CAPACITY / 2) {
+                    rcmd_reset(); // Queued cell updates are covered by the full redraw
+                    rcmd_level();
+                    full_redraw_needed = false;
+                }
 
-                    xSemaphoreTake(fb_mutex, portMAX_DELAY);
+                bool compose_scrolled = scroll_is_active();
+                if (compose_scrolled) {
+                    // Scrolling level: the view is recomposed from the tile ring after the commands
+                    prev_player_x = objects[0].x;
+                    prev_player_y = objects[0].y;
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+                    prev_player2_x = objects[PLAYER2].x;
+                    prev_player2_y = objects[PLAYER2].y;
+#endif
+                    for (int r = 5; r < 15; r++) {
+                        prev_rock_x[r - 5] = objects[r].l ? objects[r].x : -1;
+                        prev_rock_y[r - 5] = objects[r].l ? objects[r].y : -1;
+                    }
+                    prev_block_x = objects[15].l ? objects[15].x : -1;
+                    prev_block_y = objects[15].l ? objects[15].y : -1;
+                    prev_particles_drawn = particles_active() > 0;
+                    prev_ghost_drawn = false;
+                } else {
+                    // Erase old object positions (the level under a moving object is empty)
+                    if (!first_render) {
+                        if (player_moved && prev_player_x >= 0) {
+                            rcmd_erase(prev_player_x, prev_player_y);
+                        }
 
-                    // Full level redraw only on first render
-                    if (first_render || full_redraw_needed) {
-                        fb_clear(rgb_to_rgb565(0, 0, 0));
+                        if (player2_moved && prev_player2_x >= 0) {
+                            rcmd_erase(prev_player2_x, prev_player2_y);
+                        }
 
-                        // Draw all level tiles efficiently
-                        for (int y = 0; y < LEVEL_HEIGHT; y++) {
-                            for (int x = 0; x < LEVEL_WIDTH; x++) {
-                                int tile = level_data[y * LEVEL_WIDTH + x];
-                                if (tile != 0) {
-                                    fb_draw_level_tile(x, y, tile);
+                        if (rocks_moved) {
+                            for (int r = 0; r < 10; r++) {
+                                if (prev_rock_x[r] >= 0) {
+                                    rcmd_erase(prev_rock_x[r], prev_rock_y[r]);
                                 }
                             }
                         }
-                        full_redraw_needed = false;
-                    }
 
-                    // Clear previous positions if objects moved
-                    if (player_moved && !first_render && prev_player_x >= 0) {
-                        int tile_x = prev_player_x / 16;
-                        int tile_y = (prev_player_y - 8) / 16;
-                        if (tile_x >= 0 && tile_x < LEVEL_WIDTH && tile_y >= 0 && tile_y < LEVEL_HEIGHT) {
-                            fb_draw_level_tile(tile_x, tile_y, level_data[tile_y * LEVEL_WIDTH + tile_x]);
+                        if (block_moved && prev_block_x >= 0) {
+                            rcmd_erase(prev_block_x, prev_block_y);
                         }
-                    }
 
-                    // Clear previous rock positions
-                    if (rocks_moved && !first_render) {
-                        for (int r = 0; r < 10; r++) {
-                            int rock_idx = r + 5;
-                            if (prev_rock_x[r] >= 0 &&
-                                (objects[rock_idx].l && (
-                                     objects[rock_idx].x != prev_rock_x[r] || objects[rock_idx].y != prev_rock_y[r]))) {
-                                int tile_x = prev_rock_x[r] / 16;
-                                int tile_y = (prev_rock_y[r] - 8) / 16;
-                                if (tile_x >= 0 && tile_x < LEVEL_WIDTH && tile_y >= 0 && tile_y < LEVEL_HEIGHT) {
-                                    fb_draw_level_tile(tile_x, tile_y, level_data[tile_y * LEVEL_WIDTH + tile_x]);
-                                }
-                            }
+                        // Restore only the tiles under last frame's particle bounding box
+                        if (prev_particles_drawn) {
+                            rcmd_restore(prev_particle_bounds.x, prev_particle_bounds.y,
+                                         prev_particle_bounds.w, prev_particle_bounds.h);
+                        }
+
+                        // The translucent ghost blends with what is under it, so restore the
+                        // tiles before every redraw instead of clearing to black
+                        if (prev_ghost_drawn) {
+                            rcmd_restore(prev_ghost_rect.x, prev_ghost_rect.y, prev_ghost_rect.w, prev_ghost_rect.h);
                         }
                     }
 
-                    // Draw player using fast direct framebuffer
+                    // Ghost under the real objects
+                    prev_ghost_drawn = ghost_visible;
+                    if (ghost_visible) {
+                        rcmd_sprite(RCMD_SPRITE_GHOST, ghost_x, ghost_y, 0, ghost_sy, 96);
+                        prev_ghost_rect = (SDL_Rect){ghost_x, ghost_y, 16, 16};
+                    }
+
+                    // Player
                     if (objects[0].l) {
-                        uint16_t player_color = rgb_to_rgb565(255, 255, 0); // Yellow
-                        fb_draw_rect(objects[0].x, objects[0].y, 16, 16, player_color);
+                        rcmd_sprite(RCMD_SPRITE_PLAYER, objects[0].x, objects[0].y, objects[0].sx, objects[0].sy, 255);
+                        prev_player_x = objects[0].x;
+                        prev_player_y = objects[0].y;
+                    }
+
+#ifdef CONFIG_FRUITLAND_TWO_PLAYER
+                    // Second player shares the playfield when the level fits on screen
+                    if (player_count == 2 && objects[PLAYER2].l) {
+                        rcmd_sprite(RCMD_SPRITE_PLAYER2, objects[PLAYER2].x, objects[PLAYER2].y,
+                                    objects[PLAYER2].sx, objects[PLAYER2].sy, 255);
+                        prev_player2_x = objects[PLAYER2].x;
+                        prev_player2_y = objects[PLAYER2].y;
                     }
+#endif
 
-                    // Draw rocks using fast direct framebuffer
+                    // Rocks
                     for (int r = 5; r < 15; r++) {
                         if (objects[r].l) {
-                            uint16_t rock_color = rgb_to_rgb565(139, 69, 19); // Brown
-                            fb_draw_rect(objects[r].x, objects[r].y, 16, 16, rock_color);
-
-                            // Update cached position
+                            if (fov_is_visible(objects[r].dx, objects[r].dy)) {
+                                rcmd_sprite(RCMD_SPRITE_ROCK, objects[r].x, objects[r].y, 48, 16, 255);
+                            }
                             prev_rock_x[r - 5] = objects[r].x;
                             prev_rock_y[r - 5] = objects[r].y;
                         } else {
@@ -2536,10 +3844,11 @@ int game() {
                         }
                     }
 
-                    // Draw stone block (object 15) using fast direct framebuffer
+                    // Stone block (object 15)
                     if (objects[15].l) {
-                        uint16_t stone_color = rgb_to_rgb565(128, 128, 128); // Gray for stone block
-                        fb_draw_rect(objects[15].x, objects[15].y, 16, 16, stone_color);
+                        if (fov_is_visible(objects[15].dx, objects[15].dy)) {
+                            rcmd_sprite(RCMD_SPRITE_BLOCK, objects[15].x, objects[15].y, objects[15].sx, objects[15].sy, 255);
+                        }
                         prev_block_x = objects[15].x;
                         prev_block_y = objects[15].y;
                     } else {
@@ -2547,105 +3856,36 @@ int game() {
                         prev_block_y = -1;
                     }
 
-                    prev_player_x = objects[0].x;
-                    prev_player_y = objects[0].y;
-
-                    fb_ready = false;
-                    xSemaphoreGive(fb_mutex);
-
-                    // Trigger display update
-                    fb_present();
-                } else {
-#endif
-                // Optimized SDL rendering - redraw level once, then render objects
-                if (first_render || full_redraw_needed) {
-                    // Full level redraw only when necessary
-                    clear_game_surface();
-                    draw_border();
-                    draw_level();
-                    draw_texts();
-                    full_redraw_needed = false;
-                }
-
-                // Efficient object rendering - draw all objects in one pass
-                SDL_SetRenderTarget(renderer, game_surface);
-
-                // Clear old object positions with black rectangles (fastest method)
-                if (!first_render) {
-                    if (player_moved && prev_player_x >= 0) {
-                        SDL_FRect clear_rect = {prev_player_x, prev_player_y, 16, 16};
-                        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                        SDL_RenderFillRect(renderer, &clear_rect);
-                    }
-
-                    if (rocks_moved) {
-                        for (int r = 0; r < 10; r++) {
-                            if (prev_rock_x[r] >= 0) {
-                                SDL_FRect clear_rect = {prev_rock_x[r], prev_rock_y[r], 16, 16};
-                                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                                SDL_RenderFillRect(renderer, &clear_rect);
-                            }
-                        }
-                    }
-
-                    if (block_moved && prev_block_x >= 0) {
-                        SDL_FRect clear_rect = {prev_block_x, prev_block_y, 16, 16};
-                        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                        SDL_RenderFillRect(renderer, &clear_rect);
-                    }
-                }
-
-                // Draw all active objects in one efficient pass
-                // Player
-                if (objects[0].l) {
-                    SDL_FRect src_rect = {objects[0].sx, objects[0].sy, 16, 16};
-                    SDL_FRect dst_rect = {objects[0].x, objects[0].y, 16, 16};
-                    SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
-                    prev_player_x = objects[0].x;
-                    prev_player_y = objects[0].y;
-                }
-
-                // Rocks
-                for (int r = 5; r < 15; r++) {
-                    if (objects[r].l) {
-                        SDL_FRect src_rect = {48, 16, 16, 16}; // Rock sprite
-                        SDL_FRect dst_rect = {objects[r].x, objects[r].y, 16, 16};
-                        SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
-                        prev_rock_x[r - 5] = objects[r].x;
-                        prev_rock_y[r - 5] = objects[r].y;
-                    } else {
-                        prev_rock_x[r - 5] = -1;
-                        prev_rock_y[r - 5] = -1;
+                    // Particles on top of everything in the playfield
+                    prev_particles_drawn = particles_get_bounds(&prev_particle_bounds);
+                    if (prev_particles_drawn) {
+                        rcmd_particles(prev_particle_bounds.x, prev_particle_bounds.y,
+                                       prev_particle_bounds.w, prev_particle_bounds.h);
                     }
                 }
 
-                // Stone block (object 15)
-                if (objects[15].l) {
-                    SDL_FRect src_rect = {objects[15].sx, objects[15].sy, 16, 16}; // Stone block sprite (11*16, 16)
-                    SDL_FRect dst_rect = {objects[15].x, objects[15].y, 16, 16};
-                    SDL_RenderTexture(renderer, patterns_texture, &src_rect, &dst_rect);
-                    prev_block_x = objects[15].x;
-                    prev_block_y = objects[15].y;
-                } else {
-                    prev_block_x = -1;
-                    prev_block_y = -1;
-                }
-
                 // Handle stats changes
                 if (stats_changed || first_render) {
-                    print_stats();
+                    rcmd_hud(RCMD_HUD_SCORE, score);
+                    rcmd_hud(RCMD_HUD_TIME, av_time);
+                    rcmd_hud(RCMD_HUD_LEVEL, level);
+                    rcmd_hud(RCMD_HUD_LIVES, lives);
 
                     prev_score = score;
                     prev_time = av_time;
                     prev_level = level;
                     prev_lives = lives;
                 }
-#ifdef CONFIG_IDF_TARGET_ESP32P4
+
+                rcmd_submit(render_backend);
+                if (compose_scrolled) {
+                    render_scrolled_playfield();
                 }
-#endif
 
 #ifdef CONFIG_IDF_TARGET_ESP32P4
-                if (direct_framebuffer_mode) {
+                if (render_backend == &native_render_backend) {
+                    SDL_RenderPresent(renderer); // The native frame was drawn 1:1 as it was composed
+                } else if (direct_framebuffer_mode) {
                     // Use direct framebuffer rendering for maximum performance
                     render_frame_direct_fb();
                     // fb_present() handles display update
@@ -2654,10 +3894,15 @@ int game() {
                     render_frame_minimal();
                     SDL_RenderPresent(renderer);
                 }
+#elif defined(CONFIG_FRUITLAND_LOW_MEMORY)
+                SDL_RenderPresent(renderer); // Bands went to the window as they were composed
 #else
                 // Use minimal render function for better performance
                 render_frame_minimal();
                 SDL_RenderPresent(renderer);
+#ifdef CONFIG_FRUITLAND_QEMU_SMOKE
+                qemu_smoke_frame(renderer, game_surface); // Mirror to the QEMU panel
+#endif
 #endif
                 first_render = false;
             }
@@ -2693,28 +3938,103 @@ int game() {
             wait_for_frame_time();
         }
 
+        // Only a completed level can become the new best ghost
+        ghost_end_level(fruit == 0 && !dead && av_time > 0 && !level_change_requested);
+
         if (level_change_requested) {
             // F2/F3 level change - don't modify lives or score
             level_change_requested = 0; // Reset the flag
             ESP_LOGI("debug", "Level changed to %d via F2/F3", level);
         } else if (av_time == 0 || dead) {
             lives--;
+            audio_play(AUDIO_SFX_DEATH);
+            if (dead) {
+                play_death_effect();
+            }
         } else if (fruit == 0) {
             level++;
             score += av_time * 10;
+            persist_unlock_level(level > STORED_LEVELS ? STORED_LEVELS : level); // Only stored levels can be replayed
+        }
+
+        if (autopilot_mode) {
+            autopilot_stats_t ap;
+            autopilot_get_stats(&ap);
+            ESP_LOGI("autopilot", "Level %d, lives %d, score %d: %lu plans, avg %llu us, max %lu us, %lu over budget",
+                     level, lives, score, (unsigned long) ap.plans, ap.total_us / (ap.plans ? ap.plans : 1),
+                     (unsigned long) ap.max_us, (unsigned long) ap.budget_hits);
         }
     }
 
+#ifdef CONFIG_FRUITLAND_ENDLESS_MODE
+    levelgen_stop();
+#endif
+
+    // Queue the run for the high-score table; the commit happens off this thread
+    // The worker logs the rank once the score is in the table
+    if (!autopilot_mode) {
+        persist_submit_score(score, level, "PLAYER");
+    }
+
     return 1;
 }
 
+#ifdef CONFIG_FRUITLAND_STARTUP_BENCHMARKS
+// Micro-benchmarks of engine subsystems, logged once before the first game
+void run_startup_benchmarks() {
+    ESP_LOGI("bench", "Running startup benchmarks...");
+    particles_benchmark();
+    screen_fx_benchmark();
+    scroll_benchmark(game_surface);
+    ghost_self_test();
+    levelgen_benchmark();
+    fov_benchmark();
+    tile_cache_benchmark();
+    sprite_rle_benchmark();
+#ifdef CONFIG_FRUITLAND_NATIVE_SCALE
+    native_render_benchmark();
+#endif
+    ESP_LOGI("bench", "Startup benchmarks done");
+}
+#endif
+
 void *sdl_thread(void *args) {
     printf("Fruit Land on ESP32\n");
 
     // Initialize filesystem first
     SDL_InitFS();
 
+    // Hot-path log records are formatted and printed by a low-priority task
+    esp_err_t binlog_ret = init_binlog();
+    if (binlog_ret != ESP_OK && binlog_ret != ESP_ERR_NOT_SUPPORTED) {
+        printf("Warning: Binary logging unavailable, hot-path logs are dropped: %s\n", esp_err_to_name(binlog_ret));
+    }
+
+    // Load saved scores and progress, start the background writer
+    esp_err_t persist_ret = init_persist();
+    if (persist_ret == ESP_OK) {
+        print_hiscores();
+    } else if (persist_ret != ESP_ERR_NOT_SUPPORTED) {
+        printf("Warning: Persistence initialization failed: %s\n", esp_err_to_name(persist_ret));
+    }
+
+    // Start the sound effect mixer with the saved volume
+    persist_settings_t settings;
+    persist_get_settings(&settings);
+    sfx_volume = settings.volume;
+    esp_err_t audio_ret = init_audio();
+    if (audio_ret == ESP_OK) {
+        audio_set_volume(sfx_volume);
+    } else if (audio_ret != ESP_ERR_NOT_SUPPORTED) {
+        printf("Warning: Audio initialization failed: %s\n", esp_err_to_name(audio_ret));
+    }
+
+#ifdef CONFIG_FRUITLAND_PANEL_DIRECT
+    // The game drives the panel itself; SDL only provides events
+    if (!SDL_Init(SDL_INIT_EVENTS)) {
+#else
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
+#endif
         printf("Unable to initialize SDL: %s\n", SDL_GetError());
         return NULL;
     }
@@ -2765,6 +4085,16 @@ void *sdl_thread(void *args) {
     }
 #endif
 
+#ifdef CONFIG_FRUITLAND_PANEL_DIRECT
+    // No window or renderer: bands are sent to the panel as they are composed
+    esp_err_t panel_ret = panel_out_init(GAME_WIDTH, GAME_HEIGHT, &SCREEN_WIDTH, &SCREEN_HEIGHT);
+    if (panel_ret != ESP_OK) {
+        printf("Failed to initialize the panel: %s\n", esp_err_to_name(panel_ret));
+        SDL_Quit();
+        return NULL;
+    }
+    printf("Display: %dx%d (direct)\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+#else
     // Get display dimensions
     const SDL_DisplayMode *display_mode = SDL_GetCurrentDisplayMode(SDL_GetPrimaryDisplay());
     if (display_mode) {
@@ -2806,6 +4136,11 @@ void *sdl_thread(void *args) {
             printf("Fallback renderer created successfully\n");
         }
     }
+#endif
+
+    // The intro is streamed from storage first and stays up while the rest loads behind it
+    show_intro();
+    uint64_t intro_shown_us = get_time_us();
 
     if (!load_assets()) {
         printf("Failed to load game assets\n");
@@ -2815,21 +4150,71 @@ void *sdl_thread(void *args) {
         return NULL;
     }
 
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+    // Levels always fit the playfield here, so there is no tile ring
+    if (init_band_render() != ESP_OK) {
+        printf("Failed to set up band rendering\n");
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return NULL;
+    }
+#else
+    // Tile ring for levels larger than the playfield
+    if (scroll_init(renderer, LEVEL_WIDTH * 16, LEVEL_HEIGHT * 16, draw_ring_tile) != ESP_OK) {
+        printf("Warning: Scrolling disabled, large levels show only the top-left view\n");
+    }
+#endif
+
     // Initialize render system with target-specific optimizations
 #ifdef CONFIG_IDF_TARGET_ESP32P4
     printf("Using ESP32-P4 hardware-accelerated rendering\n");
     init_render_system();
+#ifdef CONFIG_FRUITLAND_NATIVE_SCALE
+    // Atlas scaled once; frames composed at panel scale instead of upscaled
+    if (init_native_render() != ESP_OK) {
+        printf("Warning: Native-scale composition unavailable, upscaling the game surface\n");
+    }
+#endif
 #else
     printf("Using optimized single-core rendering\n");
     // Keep disabled for ESP32-S3 until stability issues are resolved
     // esp_err_t render_ret = init_render_system();
 #endif
 
+    select_render_backend();
+
+#ifdef CONFIG_FRUITLAND_STARTUP_BENCHMARKS
+    run_startup_benchmarks();
+#endif
+
+#ifdef CONFIG_FRUITLAND_QEMU_SMOKE
+    qemu_smoke_init(GAME_WIDTH, GAME_HEIGHT);
+#endif
+
+#ifdef CONFIG_FRUITLAND_LOW_MEMORY
+    log_memory_footprint("Assets loaded");
+#endif
     printf("Starting game...\n");
 
+    bool intro_up = true;
     while (game_running) {
-        show_intro();
-        vTaskDelay(pdMS_TO_TICKS(2000)); // Show intro for 2 seconds
+        if (!intro_up) {
+            show_intro();
+            intro_shown_us = get_time_us();
+        }
+        intro_up = false;
+        // Show intro for 2 seconds, counting the time it was already up while loading
+        choose_start_level(intro_shown_us + 2000000);
+#ifdef CONFIG_FRUITLAND_AUTOPILOT
+        // Attract mode: the autopilot plays until a key is pressed, then a real game starts
+        autopilot_mode = true;
+        int demo = game();
+        autopilot_mode = false;
+        if (demo != 2) {
+            continue; // Demo over (or quit): back to the intro
+        }
+#endif
         game();
         vTaskDelay(pdMS_TO_TICKS(1000)); // Brief pause before restart
     }
@@ -2844,9 +4229,14 @@ void *sdl_thread(void *args) {
 #ifdef CONFIG_FRUITLAND_ACCELEROMETER_INPUT
     cleanup_accelerometer();
 #endif
-    if (intro_texture) SDL_DestroyTexture(intro_texture);
+    cleanup_audio();
+    cleanup_persist();
+    scroll_cleanup();
     if (patterns_texture) SDL_DestroyTexture(patterns_texture);
     if (game_surface) SDL_DestroyTexture(game_surface);
+#ifdef CONFIG_FRUITLAND_HUD_PLANE
+    if (hud_plane) SDL_DestroyTexture(hud_plane);
+#endif
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -2861,7 +4251,7 @@ void app_main(void) {
 
     pthread_attr_t attr;
     pthread_attr_init(&attr);
-    pthread_attr_setstacksize(&attr, 65536); // Increased stack size for game
+    pthread_attr_setstacksize(&attr, CONFIG_FRUITLAND_GAME_STACK_SIZE);
 
     int ret = pthread_create(&sdl_pthread, &attr, sdl_thread, NULL);
     if (ret != 0) {
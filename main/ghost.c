@@ -0,0 +1,450 @@
+/**
+ * @file ghost.c
+ * @brief Time-trial ghost recording and streamed playback
+ *
+ * File layout: a ghost_header_t followed by one byte per tick. The high
+ * nibble is the signed x delta, the low nibble the signed y delta. The byte
+ * GHOST_ESCAPE (x delta -8, y delta 0) is followed by an absolute position
+ * as two little-endian int16 values, used for teleports and screen turns.
+ *
+ * Recording goes to a RAM buffer and is written out only when a completed run
+ * beats the stored one, at the level transition. The buffer is then handed to
+ * a low-priority writer task and recording continues in a second one, so the
+ * game thread never waits on flash. Playback reads the file through a small
+ * buffer, so a long run costs a few dozen bytes of RAM.
+ */
+
+#include "ghost.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "ghost";
+
+#ifdef CONFIG_FRUITLAND_GHOST_RUN
+
+#define GHOST_MAGIC 0x48474c46  // "FLGH"
+#define GHOST_VERSION 1
+#define GHOST_ESCAPE 0x80
+#define GHOST_MAX_BYTES (48 * 1024)  // Roughly 25 minutes at 30 ticks per second
+#define GHOST_READ_BUFFER 64
+#define GHOST_SELF_TEST_TICKS 2000
+#define GHOST_TASK_STACK 4096
+#define GHOST_TASK_PRIORITY 2  // Below the game and SDL tasks
+
+#ifndef GHOST_DIR
+#define GHOST_DIR "/assets"  // The host harness stores runs in its build directory
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t level;
+    uint32_t ticks;
+    int16_t start_x;
+    int16_t start_y;
+} ghost_header_t;
+
+// A finished run on its way to flash
+typedef struct {
+    uint8_t *data;
+    uint32_t len;
+    uint32_t ticks;
+    int level;
+    int16_t start_x;
+    int16_t start_y;
+} ghost_run_t;
+
+// Recording of the run in progress
+static uint8_t *rec_data;
+static uint32_t rec_len;
+static uint32_t rec_ticks;
+static int16_t rec_start_x, rec_start_y;
+static int rec_last_x, rec_last_y;
+static bool rec_active;
+static int rec_level;
+
+// Streamed playback of the stored best run
+static FILE *play_file;
+static uint8_t play_buffer[GHOST_READ_BUFFER];
+static size_t play_pos, play_fill;
+static uint32_t play_ticks_left;
+static int play_x, play_y;
+
+// Background writer: owns save_run.data while save_busy is set
+static QueueHandle_t save_queue;
+static ghost_run_t save_run;
+static uint8_t *spare_data;  // Recording buffer swapped in while the other one is written
+static atomic_bool save_busy;
+static bool saver_failed;
+
+static void ghost_path(char *out, size_t size, int level, const char *ext) {
+    snprintf(out, size, GHOST_DIR "/ghost_%02d.%s", level, ext);
+}
+
+static uint8_t *alloc_run_buffer(void) {
+    uint8_t *data = heap_caps_malloc(GHOST_MAX_BYTES, MALLOC_CAP_SPIRAM);
+    if (!data) {
+        data = heap_caps_malloc(GHOST_MAX_BYTES, MALLOC_CAP_8BIT);
+    }
+    return data;
+}
+
+static bool recorder_start(int start_x, int start_y) {
+    if (!rec_data) {
+        rec_data = alloc_run_buffer();
+        if (!rec_data) {
+            ESP_LOGW(TAG, "No memory for ghost recording");
+            return false;
+        }
+    }
+    rec_len = 0;
+    rec_ticks = 0;
+    rec_start_x = rec_last_x = start_x;
+    rec_start_y = rec_last_y = start_y;
+    rec_active = true;
+    return true;
+}
+
+static void recorder_push(int x, int y) {
+    if (!rec_active) return;
+    if (rec_len + 5 > GHOST_MAX_BYTES) {
+        // Too long to be a best time; drop it rather than store a truncated run
+        rec_active = false;
+        return;
+    }
+
+    int dx = x - rec_last_x;
+    int dy = y - rec_last_y;
+    if (dx >= -7 && dx <= 7 && dy >= -8 && dy <= 7) {
+        rec_data[rec_len++] = (uint8_t)(((dx & 0x0f) << 4) | (dy & 0x0f));
+    } else {
+        rec_data[rec_len++] = GHOST_ESCAPE;
+        rec_data[rec_len++] = (uint8_t)(x & 0xff);
+        rec_data[rec_len++] = (uint8_t)((x >> 8) & 0xff);
+        rec_data[rec_len++] = (uint8_t)(y & 0xff);
+        rec_data[rec_len++] = (uint8_t)((y >> 8) & 0xff);
+    }
+    rec_last_x = x;
+    rec_last_y = y;
+    rec_ticks++;
+}
+
+static ghost_run_t recorder_run(void) {
+    return (ghost_run_t) {
+        .data = rec_data,
+        .len = rec_len,
+        .ticks = rec_ticks,
+        .level = rec_level,
+        .start_x = rec_start_x,
+        .start_y = rec_start_y,
+    };
+}
+
+static esp_err_t run_save(const ghost_run_t *run, const char *path, const char *tmp_path) {
+    ghost_header_t header = {
+        .magic = GHOST_MAGIC,
+        .version = GHOST_VERSION,
+        .level = (uint16_t)run->level,
+        .ticks = run->ticks,
+        .start_x = run->start_x,
+        .start_y = run->start_y,
+    };
+
+    // Write a temporary file first so a reset mid-write keeps the previous best
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        ESP_LOGW(TAG, "Failed to open %s", tmp_path);
+        return ESP_FAIL;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(run->data, 1, run->len, f) == run->len;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        ESP_LOGW(TAG, "Failed to write %s", tmp_path);
+        remove(tmp_path);
+        return ESP_FAIL;
+    }
+    if (rename(tmp_path, path) != 0) {
+        remove(path);
+        if (rename(tmp_path, path) != 0) {
+            ESP_LOGW(TAG, "Failed to replace %s", path);
+            remove(tmp_path);
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+static void run_store(const ghost_run_t *run) {
+    char path[32], tmp_path[32];
+    ghost_path(path, sizeof(path), run->level, "bin");
+    ghost_path(tmp_path, sizeof(tmp_path), run->level, "tmp");
+    if (run_save(run, path, tmp_path) == ESP_OK) {
+        ESP_LOGI(TAG, "New best run for level %d: %lu ticks, %lu bytes", run->level,
+                 (unsigned long)run->ticks, (unsigned long)(run->len + sizeof(ghost_header_t)));
+    }
+}
+
+static void save_task(void *param) {
+    (void) param;
+    ghost_run_t run;
+    while (true) {
+        xQueueReceive(save_queue, &run, portMAX_DELAY);
+        run_store(&run);
+        atomic_store(&save_busy, false);
+    }
+}
+
+static bool saver_start(void) {
+    if (save_queue) return true;
+    if (saver_failed) return false;
+    save_queue = xQueueCreate(1, sizeof(ghost_run_t));
+    if (save_queue && xTaskCreatePinnedToCore(save_task, "ghost_save", GHOST_TASK_STACK, NULL, GHOST_TASK_PRIORITY,
+                                              NULL, tskNO_AFFINITY) == pdPASS) {
+        return true;
+    }
+    if (save_queue) vQueueDelete(save_queue);
+    save_queue = NULL;
+    saver_failed = true;
+    ESP_LOGW(TAG, "No ghost writer task, best runs are saved inline");
+    return false;
+}
+
+static bool read_header(FILE *f, ghost_header_t *header) {
+    return fread(header, sizeof(*header), 1, f) == 1 &&
+           header->magic == GHOST_MAGIC && header->version == GHOST_VERSION;
+}
+
+static void player_close(void) {
+    if (play_file) {
+        fclose(play_file);
+        play_file = NULL;
+    }
+    play_ticks_left = 0;
+}
+
+static bool player_open(const char *path) {
+    player_close();
+    play_file = fopen(path, "rb");
+    if (!play_file) return false;
+
+    ghost_header_t header;
+    if (!read_header(play_file, &header)) {
+        ESP_LOGW(TAG, "Ignoring invalid ghost %s", path);
+        player_close();
+        return false;
+    }
+    play_pos = play_fill = 0;
+    play_ticks_left = header.ticks;
+    play_x = header.start_x;
+    play_y = header.start_y;
+    return true;
+}
+
+// Next byte of the stream, refilling the read buffer from flash when it runs dry
+static bool player_byte(uint8_t *out) {
+    if (play_pos == play_fill) {
+        play_fill = fread(play_buffer, 1, sizeof(play_buffer), play_file);
+        play_pos = 0;
+        if (play_fill == 0) return false;
+    }
+    *out = play_buffer[play_pos++];
+    return true;
+}
+
+static bool player_next(int *x, int *y) {
+    if (!play_file || play_ticks_left == 0) return false;
+
+    uint8_t b;
+    bool ok = player_byte(&b);
+    if (ok && b == GHOST_ESCAPE) {
+        uint8_t raw[4];
+        for (int i = 0; i < 4 && ok; i++) {
+            ok = player_byte(&raw[i]);
+        }
+        if (ok) {
+            play_x = (int16_t)(raw[0] | (raw[1] << 8));
+            play_y = (int16_t)(raw[2] | (raw[3] << 8));
+        }
+    } else if (ok) {
+        // Sign-extend the two nibbles
+        play_x += (int8_t)(b & 0xf0) >> 4;
+        play_y += (int8_t)(b << 4) >> 4;
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "Ghost stream ended early");
+        player_close();
+        return false;
+    }
+
+    play_ticks_left--;
+    *x = play_x;
+    *y = play_y;
+    return true;
+}
+
+void ghost_begin_level(int level, int start_x, int start_y) {
+    char path[32];
+    ghost_path(path, sizeof(path), level, "bin");
+    if (player_open(path)) {
+        ESP_LOGI(TAG, "Racing ghost for level %d (%lu ticks)", level, (unsigned long)play_ticks_left);
+    }
+    rec_level = level;
+    recorder_start(start_x, start_y);
+}
+
+void ghost_record_tick(int x, int y) {
+    recorder_push(x, y);
+}
+
+bool ghost_playback_tick(int *x, int *y) {
+    if (player_next(x, y)) return true;
+    player_close();
+    return false;
+}
+
+uint32_t ghost_best_ticks(int level) {
+    // A run still being written is newer than the file
+    if (atomic_load(&save_busy) && save_run.level == level) return save_run.ticks;
+
+    char path[32];
+    ghost_path(path, sizeof(path), level, "bin");
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+
+    ghost_header_t header;
+    uint32_t ticks = read_header(f, &header) ? header.ticks : 0;
+    fclose(f);
+    return ticks;
+}
+
+void ghost_end_level(bool completed) {
+    player_close();
+    if (!rec_active) return;
+    rec_active = false;
+    if (!completed || rec_ticks == 0) return;
+
+    uint32_t best = ghost_best_ticks(rec_level);
+    if (best != 0 && best <= rec_ticks) return;
+
+    ghost_run_t run = recorder_run();
+    if (!saver_start()) {
+        run_store(&run);
+        return;
+    }
+    if (atomic_load(&save_busy)) {
+        ESP_LOGW(TAG, "Previous best run still being written, level %d run not stored", rec_level);
+        return;
+    }
+    if (!spare_data) {
+        spare_data = alloc_run_buffer();
+        if (!spare_data) {
+            ESP_LOGW(TAG, "No memory for a second ghost buffer, level %d run not stored", rec_level);
+            return;
+        }
+    }
+
+    // The writer takes this buffer; the next level records into the spare one
+    save_run = run;
+    rec_data = spare_data;
+    spare_data = save_run.data;
+    atomic_store(&save_busy, true);
+    xQueueSend(save_queue, &save_run, 0);
+}
+
+esp_err_t ghost_self_test(void) {
+    static const char *path = GHOST_DIR "/ghost_test.bin";
+    static const char *tmp_path = GHOST_DIR "/ghost_test.tmp";
+    static int16_t expect_x[GHOST_SELF_TEST_TICKS], expect_y[GHOST_SELF_TEST_TICKS];
+
+    // Synthetic run: walking and sliding at 1-4 px per tick, pauses, and
+    // occasional teleports that need the escape encoding
+    uint32_t seed = 12345;
+    int x = 8, y = 8;
+    if (!recorder_start(x, y)) return ESP_ERR_NO_MEM;
+    for (int t = 0; t < GHOST_SELF_TEST_TICKS; t++) {
+        seed = seed * 1103515245 + 12345;
+        int r = (seed >> 16) & 0xff;
+        if (r < 4) {
+            x = 8 + (r * 397) % 1200;
+            y = 8 + (r * 211) % 880;
+        } else if (r < 200) {
+            int step = 1 + (r & 3);
+            switch ((r >> 2) & 3) {
+                case 0: x += step; break;
+                case 1: x -= step; break;
+                case 2: y += step; break;
+                default: y -= step; break;
+            }
+        }
+        expect_x[t] = x;
+        expect_y[t] = y;
+        recorder_push(x, y);
+    }
+    rec_active = false;
+
+    ghost_run_t run = recorder_run();
+    run.level = 0;
+    esp_err_t err = run_save(&run, path, tmp_path);
+    if (err != ESP_OK) return err;
+
+    err = ESP_OK;
+    if (!player_open(path)) {
+        err = ESP_FAIL;
+    } else {
+        for (int t = 0; t < GHOST_SELF_TEST_TICKS; t++) {
+            int gx, gy;
+            if (!player_next(&gx, &gy) || gx != expect_x[t] || gy != expect_y[t]) {
+                ESP_LOGE(TAG, "Self-test: tick %d out of step", t);
+                err = ESP_FAIL;
+                break;
+            }
+        }
+        int gx, gy;
+        if (err == ESP_OK && player_next(&gx, &gy)) {
+            ESP_LOGE(TAG, "Self-test: ghost ran past the recording");
+            err = ESP_FAIL;
+        }
+    }
+    player_close();
+    remove(path);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Self-test passed: %d ticks in %lu bytes", GHOST_SELF_TEST_TICKS,
+                 (unsigned long)(rec_len + sizeof(ghost_header_t)));
+    }
+    return err;
+}
+
+#else  // !CONFIG_FRUITLAND_GHOST_RUN
+
+void ghost_begin_level(int level, int start_x, int start_y) {
+}
+
+void ghost_record_tick(int x, int y) {
+}
+
+bool ghost_playback_tick(int *x, int *y) {
+    return false;
+}
+
+void ghost_end_level(bool completed) {
+}
+
+uint32_t ghost_best_ticks(int level) {
+    return 0;
+}
+
+esp_err_t ghost_self_test(void) {
+    ESP_LOGI(TAG, "Ghost runs disabled");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif  // CONFIG_FRUITLAND_GHOST_RUN
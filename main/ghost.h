@@ -0,0 +1,59 @@
+/**
+ * @file ghost.h
+ * @brief Time-trial ghost runs for ESP32-Fruitland
+ *
+ * The player's position is recorded once per game tick as a delta stream
+ * (one byte per tick, an escape plus absolute position for jumps such as
+ * teleports). The fastest completed run of each level is stored on the
+ * assets filesystem and replayed as a translucent ghost, streamed through a
+ * small read buffer rather than loaded whole.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start a level: open its best run for playback and start recording
+ */
+void ghost_begin_level(int level, int start_x, int start_y);
+
+/**
+ * @brief Record the player's position for this tick
+ */
+void ghost_record_tick(int x, int y);
+
+/**
+ * @brief Advance the ghost by one tick
+ *
+ * @return false if there is no ghost or its run has finished
+ */
+bool ghost_playback_tick(int *x, int *y);
+
+/**
+ * @brief Finish the level; a completed run faster than the stored one replaces it
+ */
+void ghost_end_level(bool completed);
+
+/**
+ * @brief Ticks of the stored best run for a level, 0 if none
+ */
+uint32_t ghost_best_ticks(int level);
+
+/**
+ * @brief Record a synthetic run, replay it from flash and check every tick matches
+ *
+ * @return ESP_OK if the replay stayed in step with the recording
+ */
+esp_err_t ghost_self_test(void);
+
+#ifdef __cplusplus
+}
+#endif
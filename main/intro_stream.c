@@ -0,0 +1,113 @@
+/**
+ * @file intro_stream.c
+ * @brief Band-wise BMP decode for the intro screen
+ *
+ * Rows of a band are contiguous in the file (in reverse order for the usual
+ * bottom-up BMP), so each band is one seek and one read.
+ */
+
+#include "intro_stream.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "panel_out.h"
+
+static const char *TAG = "intro";
+
+static uint32_t read_le(const uint8_t *p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+esp_err_t intro_stream(const char *path, int width, int max_height, int max_lines, intro_band_fn present) {
+    uint64_t start = esp_timer_get_time();
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        ESP_LOGE(TAG, "Failed to open %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // BITMAPFILEHEADER + BITMAPINFOHEADER
+    uint8_t hdr[54];
+    if (fread(hdr, 1, sizeof(hdr), file) != sizeof(hdr) || hdr[0] != 'B' || hdr[1] != 'M') {
+        ESP_LOGE(TAG, "%s: not a BMP file", path);
+        fclose(file);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    long data_offset = read_le(hdr + 10, 4);
+    uint32_t info_size = read_le(hdr + 14, 4);
+    int w = (int32_t) read_le(hdr + 18, 4);
+    int h = (int32_t) read_le(hdr + 22, 4);
+    int bpp = read_le(hdr + 28, 2);
+    uint32_t compression = read_le(hdr + 30, 4);
+    uint32_t colors = read_le(hdr + 46, 4);
+    if (bpp != 8 || compression != 0 || w <= 0 || h == 0) {
+        ESP_LOGE(TAG, "%s: need an uncompressed 8-bit BMP (%dx%d, %d bpp)", path, w, h, bpp);
+        fclose(file);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    bool bottom_up = h > 0;
+    int height = bottom_up ? h : -h;
+    if (w != width || height > max_height) {
+        ESP_LOGE(TAG, "%s: %dx%d does not fit a %d wide, at most %d high screen", path, w, height, width, max_height);
+        fclose(file);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    int stride = (w + 3) & ~3;
+    if (colors == 0 || colors > 256) colors = 256;
+
+    uint16_t *palette = heap_caps_calloc(256, sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    uint8_t *indices = heap_caps_malloc(stride * max_lines, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#ifdef CONFIG_FRUITLAND_PANEL_DIRECT
+    // Bands go to the panel's DMA as they are
+    uint16_t *band = heap_caps_malloc(w * max_lines * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+#else
+    uint16_t *band = heap_caps_malloc(w * max_lines * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#endif
+    if (!palette || !indices || !band) {
+        ESP_LOGE(TAG, "Failed to allocate a %dx%d band", w, max_lines);
+        heap_caps_free(band);
+        heap_caps_free(indices);
+        heap_caps_free(palette);
+        fclose(file);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Palette entries are B, G, R, reserved
+    uint8_t bgra[4];
+    fseek(file, 14 + info_size, SEEK_SET);
+    for (uint32_t i = 0; i < colors && fread(bgra, 1, 4, file) == 4; i++) {
+        palette[i] = PANEL_RGB565(((bgra[2] & 0xF8) << 8) | ((bgra[1] & 0xFC) << 3) | (bgra[0] >> 3));
+    }
+
+    uint64_t first_band = 0;
+    int bands = 0;
+    for (int y0 = 0; y0 < height; y0 += max_lines, bands++) {
+        int lines = height - y0 < max_lines ? height - y0 : max_lines;
+        int first_row = bottom_up ? height - y0 - lines : y0;  // lowest file row of the band
+        fseek(file, data_offset + (long) first_row * stride, SEEK_SET);
+        if (fread(indices, stride, lines, file) != (size_t) lines) {
+            memset(indices, 0, stride * lines);
+        }
+        for (int y = 0; y < lines; y++) {
+            const uint8_t *src = indices + (bottom_up ? lines - 1 - y : y) * stride;
+            uint16_t *dst = band + y * w;
+            for (int x = 0; x < w; x++) dst[x] = palette[src[x]];
+        }
+        present(band, w, height, y0, lines);
+        if (!first_band) first_band = esp_timer_get_time() - start;
+    }
+    ESP_LOGI(TAG, "%s: %dx%d in %d bands, first out after %llu us, all after %llu us", path, w, height, bands,
+             (unsigned long long) first_band, (unsigned long long) (esp_timer_get_time() - start));
+
+    heap_caps_free(band);
+    heap_caps_free(indices);
+    heap_caps_free(palette);
+    fclose(file);
+    return ESP_OK;
+}
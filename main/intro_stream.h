@@ -0,0 +1,41 @@
+/**
+ * @file intro_stream.h
+ * @brief Intro screen decoded from storage in bands, with nothing kept resident
+ *
+ * The intro is shown for a couple of seconds per game, so instead of a
+ * texture that lives for the whole session it is read from its 8-bit BMP a
+ * band at a time, converted through the palette and handed to the display,
+ * which scales it on the way out. Only one band of indices and one of
+ * pixels exist while it runs, and the top of the picture is out after the
+ * first band's read.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Show rows y0..y0+lines-1 of a width x height picture
+ *
+ * The band is RGB565 in the panel's byte order (PANEL_RGB565 in panel_out.h)
+ * and may be modified; it is reused for the next band when this returns.
+ */
+typedef void (*intro_band_fn)(uint16_t *band, int width, int height, int y0, int lines);
+
+/**
+ * @brief Decode an uncompressed 8-bit BMP top to bottom in bands of at most max_lines rows
+ *
+ * @param width       Required picture width; bands are always this wide
+ * @param max_height  Tallest picture accepted
+ * @return ESP_OK, ESP_ERR_NOT_FOUND, ESP_ERR_NOT_SUPPORTED for other BMP formats or sizes, or ESP_ERR_NO_MEM
+ */
+esp_err_t intro_stream(const char *path, int width, int max_height, int max_lines, intro_band_fn present);
+
+#ifdef __cplusplus
+}
+#endif
@@ -120,6 +120,8 @@ static SDL_Scancode convert_hid_to_sdl_scancode(uint8_t hid_code) {
         case HID_KEY_SPACE: return SDL_SCANCODE_SPACE;
         case HID_KEY_DEL: return SDL_SCANCODE_BACKSPACE;
         case HID_KEY_TAB: return SDL_SCANCODE_TAB;
+        case HID_KEY_MINUS: return SDL_SCANCODE_MINUS;
+        case HID_KEY_EQUAL: return SDL_SCANCODE_EQUALS;
 
         // Arrow keys
         case HID_KEY_UP: return SDL_SCANCODE_UP;
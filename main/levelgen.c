@@ -0,0 +1,324 @@
+/**
+ * @file levelgen.c
+ * @brief Procedural level generation and the background generator worker
+ *
+ * A candidate is built from dots, random wall runs, fruit, supported rocks,
+ * enemies on short open corridors, items, an optional teleporter pair and
+ * death traps. It is accepted if a flood fill from the player start reaches
+ * every fruit, treating walls, rocks, blocks and death traps as solid and
+ * following the teleporter pair. Rejected candidates are regenerated from
+ * the same random stream, so a seed always produces the same level.
+ */
+
+#include "levelgen.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "levelgen";
+
+#define CELLS (LEVELGEN_WIDTH * LEVELGEN_HEIGHT)
+#define MAX_ATTEMPTS 64
+#define MAX_ROCKS 10   // Rock objects available in the game
+#define MAX_ENEMIES 4  // Enemy objects available in the game
+
+#define LEVELGEN_QUEUE_LENGTH 2
+#define LEVELGEN_TASK_STACK 4096
+#define LEVELGEN_TASK_PRIORITY 1  // Only runs when the core is otherwise idle
+
+// Tile codes of the stored levels
+enum {
+    T_EMPTY = 0,
+    T_DOT = 1,
+    T_WALL = 2,
+    T_ROCK = 3,
+    T_FRUIT = 4,
+    T_BONUS = 5,
+    T_TELEPORT = 6,
+    T_TIME = 7,
+    T_LIFE = 9,
+    T_FREEZE = 10,
+    T_BLOCK = 11,
+    T_TRAP = 12,
+    T_ENEMY_VER = 13,
+    T_ENEMY_HOR = 14,
+    T_ENEMY_GHOST = 15,
+};
+
+static QueueHandle_t level_queue;
+static TaskHandle_t worker_handle;
+static uint32_t session_seed;
+static int levels_served;
+
+static uint32_t next_random(uint32_t *state) {
+    // xorshift32
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int random_range(uint32_t *state, int lo, int hi) {
+    return lo + (int)(next_random(state) % (uint32_t)(hi - lo + 1));
+}
+
+// Pick a random cell holding tile `want`, -1 if none was found
+static int random_cell(uint32_t *state, const uint8_t *tiles, uint8_t want) {
+    for (int tries = 0; tries < 64; tries++) {
+        int c = next_random(state) % CELLS;
+        if (tiles[c] == want) return c;
+    }
+    for (int c = 0; c < CELLS; c++) {
+        if (tiles[c] == want) return c;
+    }
+    return -1;
+}
+
+static bool is_solid(uint8_t tile) {
+    return tile == T_WALL || tile == T_ROCK || tile == T_BLOCK || tile == T_TRAP;
+}
+
+bool levelgen_is_solvable(const levelgen_level_t *lvl) {
+    uint8_t queue[CELLS];
+    uint8_t seen[CELLS];
+    memset(seen, 0, sizeof(seen));
+
+    int teleports[2], teleport_count = 0, fruit = 0;
+    for (int c = 0; c < CELLS; c++) {
+        if (lvl->tiles[c] == T_TELEPORT && teleport_count < 2) teleports[teleport_count++] = c;
+        if (lvl->tiles[c] == T_FRUIT) fruit++;
+    }
+    if (fruit == 0) return false;
+
+    int head = 0, tail = 0;
+    int start = lvl->player_y * LEVELGEN_WIDTH + lvl->player_x;
+    queue[tail++] = start;
+    seen[start] = 1;
+
+    while (head < tail) {
+        int c = queue[head++];
+        if (lvl->tiles[c] == T_FRUIT && --fruit == 0) return true;
+
+        int x = c % LEVELGEN_WIDTH, y = c / LEVELGEN_WIDTH;
+        int next[5], n = 0;
+        if (x > 0) next[n++] = c - 1;
+        if (x < LEVELGEN_WIDTH - 1) next[n++] = c + 1;
+        if (y > 0) next[n++] = c - LEVELGEN_WIDTH;
+        if (y < LEVELGEN_HEIGHT - 1) next[n++] = c + LEVELGEN_WIDTH;
+        if (lvl->tiles[c] == T_TELEPORT && teleport_count == 2) {
+            next[n++] = (c == teleports[0]) ? teleports[1] : teleports[0];
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (!seen[next[i]] && !is_solid(lvl->tiles[next[i]])) {
+                seen[next[i]] = 1;
+                queue[tail++] = next[i];
+            }
+        }
+    }
+    return false;
+}
+
+static void generate_candidate(uint32_t *rng, int difficulty, levelgen_level_t *out) {
+    uint8_t *t = out->tiles;
+    memset(t, T_DOT, CELLS);
+
+    // Wall runs, denser as difficulty rises
+    int runs = 6 + (difficulty < 16 ? difficulty / 2 : 8);
+    for (int r = 0; r < runs; r++) {
+        int len = random_range(rng, 2, 6);
+        int x = random_range(rng, 0, LEVELGEN_WIDTH - 1);
+        int y = random_range(rng, 0, LEVELGEN_HEIGHT - 1);
+        bool horizontal = next_random(rng) & 1;
+        for (int i = 0; i < len && x < LEVELGEN_WIDTH && y < LEVELGEN_HEIGHT; i++) {
+            t[y * LEVELGEN_WIDTH + x] = T_WALL;
+            if (horizontal) x++; else y++;
+        }
+    }
+
+    int start = random_cell(rng, t, T_DOT);
+    if (start < 0) start = 0;
+    t[start] = T_EMPTY;
+    out->player_x = start % LEVELGEN_WIDTH;
+    out->player_y = start / LEVELGEN_WIDTH;
+
+    int fruit = 4 + (difficulty < 12 ? difficulty / 2 : 6);
+    for (int i = 0; i < fruit; i++) {
+        int c = random_cell(rng, t, T_DOT);
+        if (c >= 0) t[c] = T_FRUIT;
+    }
+
+    // Rocks only where they rest on something, so nothing falls at level start
+    int rocks = 2 + (difficulty / 3 < MAX_ROCKS - 2 ? difficulty / 3 : MAX_ROCKS - 2);
+    for (int i = 0, placed = 0; i < rocks * 4 && placed < rocks; i++) {
+        int c = random_cell(rng, t, T_DOT);
+        if (c < 0) break;
+        int below = c + LEVELGEN_WIDTH;
+        if (below >= CELLS || t[below] == T_WALL || t[below] == T_ROCK) {
+            t[c] = T_ROCK;
+            placed++;
+        }
+    }
+
+    // Enemies away from the start, each on a short open corridor (they only move over empty tiles)
+    int enemies = 1 + (difficulty / 3 < MAX_ENEMIES - 1 ? difficulty / 3 : MAX_ENEMIES - 1);
+    for (int i = 0, placed = 0; i < enemies * 8 && placed < enemies; i++) {
+        int c = random_cell(rng, t, T_DOT);
+        if (c < 0) break;
+        int x = c % LEVELGEN_WIDTH, y = c / LEVELGEN_WIDTH;
+        if (abs(x - out->player_x) + abs(y - out->player_y) < 5) continue;
+
+        uint8_t type = T_ENEMY_HOR;
+        int roll = random_range(rng, 0, 9);
+        if (roll < 4) type = T_ENEMY_VER;
+        else if (roll < 6 && difficulty >= 4) type = T_ENEMY_GHOST;
+        t[c] = type;
+
+        int step = (type == T_ENEMY_VER) ? LEVELGEN_WIDTH : 1;
+        for (int d = -2; d <= 2; d++) {
+            int nc = c + d * step;
+            bool same_line = (type == T_ENEMY_VER) ? (nc >= 0 && nc < CELLS) : (nc >= 0 && nc / LEVELGEN_WIDTH == y);
+            if (d != 0 && same_line && t[nc] == T_DOT) t[nc] = T_EMPTY;
+        }
+        placed++;
+    }
+
+    // Items
+    static const struct {
+        uint8_t tile;
+        uint8_t chance;  // Percent
+    } items[] = {{T_BONUS, 50}, {T_TIME, 50}, {T_FREEZE, 30}, {T_LIFE, 15}};
+    for (size_t i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+        if (random_range(rng, 0, 99) < items[i].chance) {
+            int c = random_cell(rng, t, T_DOT);
+            if (c >= 0) t[c] = items[i].tile;
+        }
+    }
+    if (difficulty >= 2 && random_range(rng, 0, 99) < 30) {
+        for (int i = 0; i < 2; i++) {
+            int c = random_cell(rng, t, T_DOT);
+            if (c >= 0) t[c] = T_TELEPORT;
+        }
+    }
+    int traps = difficulty / 2 < 6 ? difficulty / 2 : 6;
+    for (int i = 0; i < traps; i++) {
+        int c = random_cell(rng, t, T_DOT);
+        if (c >= 0) t[c] = T_TRAP;
+    }
+
+    int time = 60 + fruit * 10 - difficulty * 2;
+    out->time = time < 60 ? 60 : time;
+}
+
+void levelgen_generate(uint32_t seed, int difficulty, levelgen_level_t *out) {
+    uint32_t rng = seed ? seed : 0x9e3779b9;
+    for (int attempt = 1; attempt <= MAX_ATTEMPTS; attempt++) {
+        generate_candidate(&rng, difficulty, out);
+        out->seed = seed;
+        out->attempts = attempt;
+        if (levelgen_is_solvable(out)) return;
+    }
+
+    // Still unlucky: an easy layout with every solid tile opened up always passes
+    ESP_LOGW(TAG, "Seed %lu rejected %d times, using an open layout", (unsigned long)seed, MAX_ATTEMPTS);
+    generate_candidate(&rng, 0, out);
+    for (int c = 0; c < CELLS; c++) {
+        if (is_solid(out->tiles[c])) out->tiles[c] = T_DOT;
+    }
+    out->seed = seed;
+    out->attempts = MAX_ATTEMPTS + 1;
+}
+
+static uint32_t level_seed(int index) {
+    return session_seed ^ ((uint32_t)index * 0x9e3779b9);
+}
+
+static void levelgen_task(void *arg) {
+    (void) arg;
+    levelgen_level_t lvl;
+    for (int index = 0;; index++) {
+        levelgen_generate(level_seed(index), index, &lvl);
+        xQueueSend(level_queue, &lvl, portMAX_DELAY);  // Sleeps while enough levels are ready
+    }
+}
+
+esp_err_t levelgen_start(uint32_t seed) {
+    levelgen_stop();
+    session_seed = seed;
+    levels_served = 0;
+
+    if (!level_queue) {
+        level_queue = xQueueCreate(LEVELGEN_QUEUE_LENGTH, sizeof(levelgen_level_t));
+        if (!level_queue) {
+            ESP_LOGE(TAG, "Failed to create level queue");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // Run on the core the caller (the game) is not using
+    BaseType_t core = (portNUM_PROCESSORS > 1) ? 1 - xPortGetCoreID() : 0;
+    if (xTaskCreatePinnedToCore(levelgen_task, "levelgen", LEVELGEN_TASK_STACK, NULL, LEVELGEN_TASK_PRIORITY,
+                                &worker_handle, core) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create generator task");
+        worker_handle = NULL;
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "Endless mode generator started on core %d, seed %lu", (int) core, (unsigned long) seed);
+    return ESP_OK;
+}
+
+void levelgen_stop(void) {
+    if (worker_handle) {
+        // The worker holds no locks; it is either generating or waiting on the queue
+        vTaskDelete(worker_handle);
+        worker_handle = NULL;
+    }
+    if (level_queue) {
+        xQueueReset(level_queue);
+    }
+}
+
+void levelgen_next(levelgen_level_t *out) {
+    while (worker_handle && xQueueReceive(level_queue, out, 0) == pdTRUE) {
+        if (out->seed == level_seed(levels_served)) {
+            levels_served++;
+            return;
+        }
+        // Stale: this index was already generated inline while the worker was behind
+    }
+
+    // Worker not running or behind; the seed sequence is the same either way
+    ESP_LOGW(TAG, "No level ready, generating inline");
+    levelgen_generate(level_seed(levels_served), levels_served, out);
+    levels_served++;
+}
+
+void levelgen_benchmark(void) {
+    const int count = 200;
+    levelgen_level_t lvl;
+
+    uint64_t t0 = esp_timer_get_time();
+    uint32_t attempts = 0;
+    for (int i = 0; i < count; i++) {
+        levelgen_generate(0x1234u + i * 7919u, i % 16, &lvl);
+        attempts += lvl.attempts;
+    }
+    uint64_t t1 = esp_timer_get_time();
+    for (int i = 0; i < count; i++) {
+        levelgen_is_solvable(&lvl);
+    }
+    uint64_t t2 = esp_timer_get_time();
+
+    uint64_t gen_us = t1 - t0;
+    ESP_LOGI(TAG, "📊 BENCH %d levels: %llu levels/s generated and validated, %lu candidates "
+             "(%.1f%% rejected), check=%llu us per level",
+             count, gen_us ? (unsigned long long) count * 1000000 / gen_us : 0, (unsigned long) attempts,
+             100.0f * (attempts - count) / attempts, (unsigned long long) ((t2 - t1) / count));
+}
@@ -0,0 +1,66 @@
+/**
+ * @file levelgen.h
+ * @brief Seeded procedural level generator for the endless mode
+ *
+ * Levels use the stored 15x11 tile codes. Every generated level passes a
+ * flood-fill solvability check (all fruit reachable from the start without
+ * pushing rocks) before it is handed out. A background worker on the idle
+ * core keeps a couple of levels ready so a level transition never waits for
+ * generation.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LEVELGEN_WIDTH 15
+#define LEVELGEN_HEIGHT 11
+
+typedef struct {
+    uint8_t tiles[LEVELGEN_WIDTH * LEVELGEN_HEIGHT];
+    uint8_t player_x;
+    uint8_t player_y;
+    uint16_t time;      // Time limit in seconds
+    uint32_t seed;
+    uint16_t attempts;  // Candidates generated before one passed the check
+} levelgen_level_t;
+
+/**
+ * @brief Generate a solvable level; the same seed and difficulty give the same level
+ */
+void levelgen_generate(uint32_t seed, int difficulty, levelgen_level_t *out);
+
+/**
+ * @brief Check that every fruit is reachable from the player start
+ */
+bool levelgen_is_solvable(const levelgen_level_t *lvl);
+
+/**
+ * @brief Start the background worker producing levels of rising difficulty
+ */
+esp_err_t levelgen_start(uint32_t seed);
+
+/**
+ * @brief Stop the background worker and drop any queued levels
+ */
+void levelgen_stop(void);
+
+/**
+ * @brief Take the next level; generated inline if the worker has not kept up
+ */
+void levelgen_next(levelgen_level_t *out);
+
+/**
+ * @brief Log generated-and-validated levels per second and the rejection rate
+ */
+void levelgen_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,527 @@
+/**
+ * @file native_render.c
+ * @brief Atlas pre-scaling, per-cell dirty tracking and the native-scale backend
+ *
+ * The dirty grid is offset so that level cells fall on grid cells; the border
+ * and HUD are then covered by the partial cells at the frame edges. In the
+ * tiled layout the frame is stored as the grid's cells, edge cells in full,
+ * and the atlas as its own 16x16 cells.
+ *
+ * Rotated images (frame, atlas, or each tiled cell) are stored turned 90
+ * degrees clockwise: game column x becomes stored row x and game row y the
+ * stored column counted from the right. Every copy is still a rectangle of
+ * whole stored rows, only with width and height exchanged.
+ */
+
+#include "native_render.h"
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "tile_cache.h"
+#include "sprite_rle.h"
+#include "particles.h"
+
+static const char *TAG = "native";
+
+#define MAX_COLS 20
+#define MAX_ROWS 20
+#define MAX_HELD_SPRITES 24
+
+static native_render_config_t cfg;
+static int scale, frame_w, frame_h;   // native frame in pixels, game orientation
+static int frame_pitch;               // linear layout: stored frame row in pixels
+static uint16_t *frame;               // PSRAM
+static uint16_t *atlas;               // pre-scaled atlas, PSRAM
+static int atlas_pitch;               // linear layout: stored atlas row in pixels
+static int atlas_cols;                // atlas cells per row
+static int cell_w, cell_px;           // native cell width and pixel count, for the tiled layout
+static int grid_x, grid_y, cols, rows;  // game pixel position of grid cell (0, 0) and grid size
+static native_render_stats_t stats;
+static native_span_t *spans;            // one per grid cell at most
+
+// Cell being composed: game pixel rectangle and where its top-left pixel is stored
+static native_rect_t clip;
+static uint16_t *clip_dst;
+static int clip_pitch;
+
+// Stored image holding the cell: the frame, or in the tiled layout the grid cell
+static uint16_t *region;
+static int region_x, region_y, region_h;  // game pixel position and height
+
+// Sprites of the last frame, replayed while held
+static rcmd_t held[MAX_HELD_SPRITES];
+static int held_count;
+static bool holding;
+
+// Nearest-neighbour copy of one game row into scale native rows
+static void scale_row(uint16_t *dst, int dst_pitch, const uint16_t *src, int w) {
+    uint16_t *d = dst;
+    for (int x = 0; x < w; x++) {
+        for (int k = 0; k < scale; k++) {
+            *d++ = src[x];
+        }
+    }
+    for (int k = 1; k < scale; k++) {
+        memcpy(dst + k * dst_pitch, dst, w * scale * sizeof(uint16_t));
+    }
+}
+
+// Stored top-left native pixel of the game pixel rectangle at (x, y), h rows high, in an image
+// image_h game pixels high
+static uint16_t *stored_at(uint16_t *image, int pitch, int image_h, int x, int y, int h) {
+    if (cfg.rotate) {
+        return image + x * scale * pitch + (image_h - y - h) * scale;
+    }
+    return image + y * scale * pitch + x * scale;
+}
+
+// Atlas rectangle at (sx, sy), h rows high, and the pitch of its stored rows; in the tiled
+// layout the rectangle lies in one 16x16 cell and the rows only run to the end of the cell
+static const uint16_t *atlas_at(int sx, int sy, int h, int *pitch) {
+    if (!cfg.tiled) {
+        *pitch = atlas_pitch;
+        return stored_at(atlas, atlas_pitch, cfg.atlas_h, sx, sy, h);
+    }
+    *pitch = cell_w;
+    uint16_t *cell = atlas + (sy / NATIVE_CELL * atlas_cols + sx / NATIVE_CELL) * cell_px;
+    return stored_at(cell, cell_w, NATIVE_CELL, sx % NATIVE_CELL, sy % NATIVE_CELL, h);
+}
+
+// Frame rectangle in the current region
+static uint16_t *frame_at(int x, int y, int h) {
+    return stored_at(region, clip_pitch, region_h, x - region_x, y - region_y, h);
+}
+
+// Copy rows of n pixels; one block copy when both sides are whole contiguous rows
+static void copy_rows(uint16_t *dst, int dst_pitch, const uint16_t *src, int src_pitch, int n, int lines) {
+    if (n == dst_pitch && n == src_pitch) {
+        memcpy(dst, src, n * lines * sizeof(uint16_t));
+        return;
+    }
+    for (int r = 0; r < lines; r++, dst += dst_pitch, src += src_pitch) {
+        memcpy(dst, src, n * sizeof(uint16_t));
+    }
+}
+
+// Copy a w x h game pixel rectangle between stored images
+static void copy_rect(uint16_t *dst, int dst_pitch, const uint16_t *src, int src_pitch, int w, int h) {
+    if (cfg.rotate) {
+        copy_rows(dst, dst_pitch, src, src_pitch, h * scale, w * scale);
+    } else {
+        copy_rows(dst, dst_pitch, src, src_pitch, w * scale, h * scale);
+    }
+}
+
+// Panel rectangle of a game pixel rectangle
+static native_rect_t panel_rect(int x, int y, int w, int h) {
+    if (cfg.rotate) {
+        return (native_rect_t) {(cfg.height - y - h) * scale, x * scale, h * scale, w * scale};
+    }
+    return (native_rect_t) {x * scale, y * scale, w * scale, h * scale};
+}
+
+esp_err_t native_render_init(const native_render_config_t *config) {
+    native_render_free();
+    cfg = *config;
+    scale = cfg.scale;
+    if (scale < 1 || scale > NATIVE_MAX_SCALE) {
+        ESP_LOGE(TAG, "Scale %d outside 1..%d", scale, NATIVE_MAX_SCALE);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    grid_x = cfg.cell_x0 % NATIVE_CELL ? cfg.cell_x0 % NATIVE_CELL - NATIVE_CELL : 0;
+    grid_y = cfg.cell_y0 % NATIVE_CELL ? cfg.cell_y0 % NATIVE_CELL - NATIVE_CELL : 0;
+    cols = (cfg.width - grid_x + NATIVE_CELL - 1) / NATIVE_CELL;
+    rows = (cfg.height - grid_y + NATIVE_CELL - 1) / NATIVE_CELL;
+    if (cols > MAX_COLS || rows > MAX_ROWS) {
+        ESP_LOGE(TAG, "%dx%d frame needs %dx%d cells, at most %dx%d", cfg.width, cfg.height, cols, rows,
+                 MAX_COLS, MAX_ROWS);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    frame_w = cfg.width * scale;
+    frame_h = cfg.height * scale;
+    frame_pitch = cfg.rotate ? frame_h : frame_w;
+    atlas_pitch = (cfg.rotate ? cfg.atlas_h : cfg.atlas_w) * scale;
+    atlas_cols = cfg.atlas_w / TILE_CACHE_CELL;
+    cell_w = NATIVE_CELL * scale;
+    cell_px = cell_w * cell_w;
+    size_t frame_bytes = (cfg.tiled ? cols * rows * cell_px : frame_w * frame_h) * sizeof(uint16_t);
+    size_t atlas_bytes = cfg.atlas_w * cfg.atlas_h * scale * scale * sizeof(uint16_t);
+    frame = heap_caps_calloc(1, frame_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    atlas = heap_caps_malloc(atlas_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    spans = heap_caps_malloc(cols * rows * sizeof(native_span_t), MALLOC_CAP_8BIT);
+    if (!frame || !atlas || !spans) {
+        ESP_LOGE(TAG, "Failed to allocate %u byte frame and %u byte atlas", (unsigned) frame_bytes,
+                 (unsigned) atlas_bytes);
+        native_render_free();
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Scale (and turn) every atlas cell once; the cache is left empty for the game
+    for (int cy = 0; cy < cfg.atlas_h / TILE_CACHE_CELL; cy++) {
+        for (int cx = 0; cx < cfg.atlas_w / TILE_CACHE_CELL; cx++) {
+            const uint16_t *cell = tile_cache_get(cx * TILE_CACHE_CELL, cy * TILE_CACHE_CELL);
+            if (!cell) {
+                ESP_LOGE(TAG, "No tile cache to scale the atlas from");
+                native_render_free();
+                return ESP_ERR_INVALID_STATE;
+            }
+            for (int r = 0; r < TILE_CACHE_CELL; r++) {
+                int pitch;
+                if (!cfg.rotate) {
+                    uint16_t *dst = (uint16_t *) atlas_at(cx * TILE_CACHE_CELL, cy * TILE_CACHE_CELL + r, 1, &pitch);
+                    scale_row(dst, pitch, cell + r * TILE_CACHE_CELL, TILE_CACHE_CELL);
+                    continue;
+                }
+                for (int x = 0; x < TILE_CACHE_CELL; x++) {
+                    uint16_t *dst = (uint16_t *) atlas_at(cx * TILE_CACHE_CELL + x, cy * TILE_CACHE_CELL + r, 1, &pitch);
+                    for (int k = 0; k < scale; k++) {
+                        for (int j = 0; j < scale; j++) dst[k * pitch + j] = cell[r * TILE_CACHE_CELL + x];
+                    }
+                }
+            }
+        }
+    }
+    tile_cache_flush();
+
+    ESP_LOGI(TAG, "%dx: %dx%d frame (%u KB), atlas pre-scaled to %dx%d (%u KB), %dx%d cells, %s layout%s", scale,
+             frame_w, frame_h, (unsigned) (frame_bytes / 1024), cfg.atlas_w * scale, cfg.atlas_h * scale,
+             (unsigned) (atlas_bytes / 1024), cols, rows, cfg.tiled ? "tiled" : "linear",
+             cfg.rotate ? ", turned for a portrait panel" : "");
+    return ESP_OK;
+}
+
+// Intersect a game pixel rectangle with the cell being composed
+static bool clip_rect(int *x, int *y, int *w, int *h) {
+    int x0 = *x > clip.x ? *x : clip.x;
+    int y0 = *y > clip.y ? *y : clip.y;
+    int x1 = *x + *w < clip.x + clip.w ? *x + *w : clip.x + clip.w;
+    int y1 = *y + *h < clip.y + clip.h ? *y + *h : clip.y + clip.h;
+    if (x0 >= x1 || y0 >= y1) return false;
+    *x = x0;
+    *y = y0;
+    *w = x1 - x0;
+    *h = y1 - y0;
+    return true;
+}
+
+void native_blit(int x, int y, int sx, int sy, int w, int h) {
+    int cx = x, cy = y;
+    if (!clip_rect(&cx, &cy, &w, &h)) return;
+    sx += cx - x;
+    sy += cy - y;
+
+    int src_pitch;
+    const uint16_t *src = atlas_at(sx, sy, h, &src_pitch);
+    copy_rect(frame_at(cx, cy, h), clip_pitch, src, src_pitch, w, h);
+    stats.bytes_read += (uint64_t) w * h * scale * scale * sizeof(uint16_t);
+    stats.bytes_written += (uint64_t) w * h * scale * scale * sizeof(uint16_t);
+}
+
+// Opaque runs of one RLE sprite, clipped to the cell, each copied scale rows high
+static void draw_sprite(const rcmd_t *c) {
+    const sprite_rle_t *spr = sprite_rle_get(c->sprite.sx, c->sprite.sy);
+    if (!spr) return;
+    int x = c->x, y = c->y, w = SPRITE_RLE_SIZE, h = SPRITE_RLE_SIZE;
+    if (!clip_rect(&x, &y, &w, &h)) return;
+    int c0 = x - c->x, c1 = c0 + w;
+
+    for (int r = y - c->y; r < y - c->y + h; r++) {
+        for (int i = spr->row_start[r]; i < spr->row_start[r + 1]; i++) {
+            int a = spr->runs[i].x > c0 ? spr->runs[i].x : c0;
+            int b = spr->runs[i].x + spr->runs[i].len < c1 ? spr->runs[i].x + spr->runs[i].len : c1;
+            if (a >= b) continue;
+            int src_pitch;
+            const uint16_t *src = atlas_at(c->sprite.sx + a, c->sprite.sy + r, 1, &src_pitch);
+            copy_rect(frame_at(c->x + a, c->y + r, 1), clip_pitch, src, src_pitch, b - a, 1);
+            stats.bytes_read += (uint64_t) (b - a) * scale * scale * sizeof(uint16_t);
+            stats.bytes_written += (uint64_t) (b - a) * scale * scale * sizeof(uint16_t);
+        }
+    }
+}
+
+static void mark_rect(bool *dirty, int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    int gx0 = (x - grid_x) / NATIVE_CELL, gx1 = (x + w - 1 - grid_x) / NATIVE_CELL;
+    int gy0 = (y - grid_y) / NATIVE_CELL, gy1 = (y + h - 1 - grid_y) / NATIVE_CELL;
+    if (gx0 < 0) gx0 = 0;
+    if (gy0 < 0) gy0 = 0;
+    for (int gy = gy0; gy <= gy1 && gy < rows; gy++) {
+        for (int gx = gx0; gx <= gx1 && gx < cols; gx++) {
+            dirty[gy * MAX_COLS + gx] = true;
+        }
+    }
+}
+
+static void compose_cell(int gx, int gy, const rcmd_t *sprites, int sprite_count, bool particles) {
+    // Grid cell clipped to the frame
+    int x0 = grid_x + gx * NATIVE_CELL, y0 = grid_y + gy * NATIVE_CELL;
+    clip = (native_rect_t) {x0, y0, NATIVE_CELL, NATIVE_CELL};
+    if (clip.x < 0) {
+        clip.w += clip.x;
+        clip.x = 0;
+    }
+    if (clip.y < 0) {
+        clip.h += clip.y;
+        clip.y = 0;
+    }
+    if (clip.x + clip.w > cfg.width) clip.w = cfg.width - clip.x;
+    if (clip.y + clip.h > cfg.height) clip.h = cfg.height - clip.y;
+
+    if (cfg.tiled) {
+        region = frame + (gy * cols + gx) * cell_px;
+        region_x = x0;
+        region_y = y0;
+        region_h = NATIVE_CELL;
+        clip_pitch = cell_w;
+    } else {
+        region = frame;
+        region_x = 0;
+        region_y = 0;
+        region_h = cfg.height;
+        clip_pitch = frame_pitch;
+    }
+    clip_dst = frame_at(clip.x, clip.y, clip.h);
+
+    uint16_t *dst = clip_dst;
+    native_rect_t stored = panel_rect(0, 0, clip.w, clip.h);
+    if (stored.w == clip_pitch) {
+        memset(dst, 0, clip_pitch * stored.h * sizeof(uint16_t));
+    } else {
+        for (int r = 0; r < stored.h; r++) {
+            memset(dst + r * clip_pitch, 0, stored.w * sizeof(uint16_t));
+        }
+    }
+    stats.bytes_written += (uint64_t) clip.w * clip.h * scale * scale * sizeof(uint16_t);
+
+    cfg.compose(clip.x, clip.y, clip.w, clip.h);
+
+    // Command order; no blending, so the translucent ghost is left out
+    for (int i = 0; i < sprite_count; i++) {
+        const rcmd_t *c = &sprites[i];
+        if (c->type == RCMD_SPRITE && c->sprite.alpha == 255) {
+            draw_sprite(c);
+        }
+    }
+
+    if (particles) {
+        particles_set_origin(clip.x, clip.y);
+        particles_draw_rgb565_scaled(dst, clip_pitch, clip.w * scale, clip.h * scale, scale, cfg.rotate);
+        particles_set_origin(0, 0);
+    }
+    stats.cells++;
+}
+
+static void native_execute(const rcmd_t *cmds, int count) {
+    if (!frame) return;
+
+    if (!holding) {
+        held_count = 0;
+        for (int i = 0; i < count && held_count < MAX_HELD_SPRITES; i++) {
+            if (cmds[i].type == RCMD_SPRITE) held[held_count++] = cmds[i];
+        }
+    }
+
+    // Cells touched by this frame
+    bool dirty[MAX_ROWS * MAX_COLS] = {false};
+    bool particles = false;
+    for (int i = 0; i < count; i++) {
+        const rcmd_t *c = &cmds[i];
+        switch (c->type) {
+            case RCMD_LEVEL:
+                mark_rect(dirty, 0, 0, cfg.width, cfg.height);
+                break;
+            case RCMD_TILE:
+                mark_rect(dirty, cfg.cell_x0 + c->x * NATIVE_CELL, cfg.cell_y0 + c->y * NATIVE_CELL, NATIVE_CELL,
+                          NATIVE_CELL);
+                break;
+            case RCMD_ERASE:
+            case RCMD_SPRITE:
+                mark_rect(dirty, c->x, c->y, SPRITE_RLE_SIZE, SPRITE_RLE_SIZE);
+                break;
+            case RCMD_RESTORE:
+                mark_rect(dirty, c->x, c->y, c->rect.w, c->rect.h);
+                break;
+            case RCMD_PARTICLES:
+                mark_rect(dirty, c->x, c->y, c->rect.w, c->rect.h);
+                particles = true;
+                break;
+            case RCMD_HUD:
+                if (c->hud.field <= RCMD_HUD_LIVES) {
+                    const native_rect_t *f = &cfg.hud[c->hud.field];
+                    mark_rect(dirty, f->x, f->y, f->w, f->h);
+                }
+                break;
+        }
+    }
+
+    // Recompose dirty cells. Linear layout: runs of them on a grid row become one span, and a
+    // span continuing the one above with the same columns extends it. Tiled: a span per cell.
+    int span_count = 0;
+    for (int gy = 0; gy < rows; gy++) {
+        for (int gx = 0; gx < cols; gx++) {
+            if (!dirty[gy * MAX_COLS + gx]) continue;
+            int first = gx;
+            for (; gx < cols && dirty[gy * MAX_COLS + gx]; gx++) {
+                compose_cell(gx, gy, holding ? held : cmds, holding ? held_count : count, particles);
+                if (cfg.tiled) {
+                    native_rect_t r = panel_rect(clip.x, clip.y, clip.w, clip.h);
+                    spans[span_count++] = (native_span_t) {r, clip_dst, clip_pitch};
+                    stats.bytes_presented += (uint64_t) r.w * r.h * sizeof(uint16_t);
+                }
+            }
+            if (cfg.tiled) continue;
+
+            int x0 = grid_x + first * NATIVE_CELL, x1 = grid_x + gx * NATIVE_CELL;
+            int y0 = grid_y + gy * NATIVE_CELL, y1 = y0 + NATIVE_CELL;
+            if (x0 < 0) x0 = 0;
+            if (y0 < 0) y0 = 0;
+            if (x1 > cfg.width) x1 = cfg.width;
+            if (y1 > cfg.height) y1 = cfg.height;
+            native_rect_t r = panel_rect(x0, y0, x1 - x0, y1 - y0);
+            native_span_t *last = span_count ? &spans[span_count - 1] : NULL;
+            if (last && last->rect.x == r.x && last->rect.w == r.w && last->rect.y + last->rect.h == r.y) {
+                last->rect.h += r.h;
+            } else if (last && last->rect.y == r.y && last->rect.h == r.h && r.x + r.w == last->rect.x) {
+                // Turned frame: the next grid row lies to the left on the panel
+                last->rect.x = r.x;
+                last->rect.w += r.w;
+                last->pixels = frame + r.y * frame_pitch + r.x;
+            } else {
+                spans[span_count++] = (native_span_t) {r, frame + r.y * frame_pitch + r.x, frame_pitch};
+            }
+            stats.bytes_presented += (uint64_t) r.w * r.h * sizeof(uint16_t);
+        }
+    }
+
+    cfg.present(spans, span_count);
+    stats.frames++;
+}
+
+const rcmd_backend_t native_render_backend = {
+    .name = "native-scale",
+    .execute = native_execute,
+};
+
+void native_render_hold_sprites(bool hold) {
+    holding = hold;
+}
+
+void native_render_get_stats(native_render_stats_t *out) {
+    *out = stats;
+}
+
+void native_render_report(void) {
+    if (!frame || stats.frames == 0) return;
+    uint32_t n = stats.frames;
+    // Scaling the whole frame reads every game pixel and writes every native pixel, before any composition
+    uint32_t upscale = cfg.width * cfg.height * sizeof(uint16_t) + frame_w * frame_h * sizeof(uint16_t);
+    ESP_LOGI(TAG, "📊 %lu frames at %dx: %lu cells, %lu bytes touched per frame (compose %lu, atlas %lu, "
+             "upload %lu); full-frame upscale %lu", (unsigned long) n, scale, (unsigned long) (stats.cells / n),
+             (unsigned long) ((stats.bytes_written + stats.bytes_read + stats.bytes_presented) / n),
+             (unsigned long) (stats.bytes_written / n), (unsigned long) (stats.bytes_read / n),
+             (unsigned long) (stats.bytes_presented / n), (unsigned long) upscale);
+    memset(&stats, 0, sizeof(stats));
+}
+
+static void bench_present(const native_span_t *spans, int count) {
+}
+
+void native_render_benchmark(void) {
+    const int frames = 60;
+    if (!frame || !sprite_rle_get(0, SPRITE_RLE_SIZE)) {
+        ESP_LOGW(TAG, "Benchmark: native renderer or sprites not initialized");
+        return;
+    }
+
+    uint16_t *src = heap_caps_calloc(1, cfg.width * cfg.height * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint16_t *dst = heap_caps_malloc(frame_w * frame_h * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!src || !dst) {
+        ESP_LOGE(TAG, "Benchmark: failed to allocate frames");
+        heap_caps_free(src);
+        heap_caps_free(dst);
+        return;
+    }
+
+    // What the scaled path costs every frame, whatever changed
+    uint64_t t0 = esp_timer_get_time();
+    for (int f = 0; f < frames; f++) {
+        for (int y = 0; y < cfg.height; y++) {
+            scale_row(dst + y * scale * frame_w, frame_w, src + y * cfg.width, cfg.width);
+        }
+    }
+    uint64_t upscale_us = (esp_timer_get_time() - t0) / frames;
+    uint32_t upscale_bytes = cfg.width * cfg.height * sizeof(uint16_t) + frame_w * frame_h * sizeof(uint16_t);
+
+    ESP_LOGI(TAG, "📊 BENCH %dx%d full-frame upscale: %llu us / %lu KB per frame", frame_w, frame_h, upscale_us,
+             (unsigned long) (upscale_bytes / 1024));
+
+    if (cfg.rotate) {
+        // Turning the scaled frame for a portrait panel, on top of the upscale
+        t0 = esp_timer_get_time();
+        for (int f = 0; f < frames; f++) {
+            for (int y = 0; y < cfg.height; y++) {
+                for (int x = 0; x < cfg.width; x++) {
+                    uint16_t *d = stored_at(dst, frame_h, cfg.height, x, y, 1);
+                    for (int k = 0; k < scale; k++) {
+                        for (int j = 0; j < scale; j++) d[k * frame_h + j] = src[y * cfg.width + x];
+                    }
+                }
+            }
+        }
+        ESP_LOGI(TAG, "📊 BENCH %dx%d full-frame upscale turned for the panel: %llu us per frame", frame_h, frame_w,
+                 (esp_timer_get_time() - t0) / frames);
+    }
+    heap_caps_free(src);
+    heap_caps_free(dst);
+
+    // Composition alone in each layout: full frames, then one sprite walking 2 px per frame
+    native_render_config_t saved = cfg;
+    for (int tiled = 0; tiled <= 1; tiled++) {
+        native_render_config_t bench = saved;
+        bench.tiled = tiled;
+        bench.present = bench_present;
+        if (native_render_init(&bench) != ESP_OK) break;
+
+        rcmd_t cmds[2] = {{.type = RCMD_LEVEL}};
+        t0 = esp_timer_get_time();
+        for (int f = 0; f < frames; f++) {
+            native_execute(cmds, 1);
+        }
+        uint64_t full_us = (esp_timer_get_time() - t0) / frames;
+
+        native_render_stats_t before = stats;
+        t0 = esp_timer_get_time();
+        for (int f = 0; f < frames; f++) {
+            int x = cfg.cell_x0 + f * 2;
+            cmds[0] = (rcmd_t) {.type = RCMD_ERASE, .x = x - 2, .y = cfg.cell_y0 + NATIVE_CELL};
+            cmds[1] = (rcmd_t) {.type = RCMD_SPRITE, .x = x, .y = cfg.cell_y0 + NATIVE_CELL,
+                                .sprite = {0, SPRITE_RLE_SIZE, RCMD_SPRITE_PLAYER, 255}};
+            native_execute(cmds, 2);
+        }
+        uint64_t sprite_us = (esp_timer_get_time() - t0) / frames;
+        uint64_t sprite_bytes = (stats.bytes_written + stats.bytes_read - before.bytes_written - before.bytes_read) /
+                                frames;
+
+        ESP_LOGI(TAG, "📊 BENCH %s layout at %dx: full frame %llu us, moving sprite %llu us / %lu KB per frame",
+                 tiled ? "tiled" : "linear", scale, full_us, sprite_us, (unsigned long) (sprite_bytes / 1024));
+    }
+
+    if (native_render_init(&saved) != ESP_OK) {
+        ESP_LOGE(TAG, "Benchmark: failed to restore the native renderer");
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+void native_render_free(void) {
+    heap_caps_free(frame);
+    heap_caps_free(atlas);
+    heap_caps_free(spans);
+    frame = NULL;
+    atlas = NULL;
+    spans = NULL;
+}
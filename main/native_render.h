@@ -0,0 +1,131 @@
+/**
+ * @file native_render.h
+ * @brief Composition at panel resolution from a pre-scaled atlas
+ *
+ * On large panels the game surface is composed at 256x224 and the whole image
+ * is scaled up every frame. Here the atlas is scaled once at load and frames
+ * are composed directly at an integer multiple of the game resolution. The
+ * frame is split into 16x16 cells aligned with the playfield and only cells
+ * touched by the frame's render commands are recomposed (static content from
+ * a callback, then sprites and particles), so a moving sprite costs a few
+ * scaled cell copies.
+ *
+ * The frame and the atlas are linear scanline images, or with the tiled
+ * layout arrays of cells, each cell's native pixels stored contiguously. A
+ * cell write then stays within one block of PSRAM instead of touching a
+ * cache line per row, a whole-cell copy is one memcpy, and cells are
+ * uploaded individually with the cell width as pitch, so no separate
+ * linearizing pass is needed.
+ *
+ * For portrait panels the frame can be composed turned 90 degrees clockwise,
+ * in panel orientation: the atlas is turned along with the pre-scaling, so
+ * every copy lands in panel order and nothing is rotated per frame.
+ *
+ * Like the band compositor, this relies on the frame emitter listing every
+ * visible sprite in every rendered frame.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "render_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NATIVE_CELL 16      // Dirty tracking granularity in game pixels
+#define NATIVE_MAX_SCALE 4
+
+typedef struct {
+    int x, y, w, h;
+} native_rect_t;
+
+/**
+ * @brief Draw everything that is not a sprite or particle into the current cell with native_blit()
+ *
+ * @param x, y, w, h  Cell being composed, in game pixels; it starts cleared to black
+ */
+typedef void (*native_compose_fn)(int x, int y, int w, int h);
+
+/**
+ * @brief A recomposed rectangle of the frame, in native pixels and panel orientation
+ */
+typedef struct {
+    native_rect_t rect;
+    const uint16_t *pixels;  // top-left pixel of rect
+    int pitch;               // pixels per row: the frame width, or the cell width in the tiled layout
+} native_span_t;
+
+/**
+ * @brief Send the recomposed parts of the frame to the display
+ *
+ * Called once per executed list, also when nothing changed.
+ */
+typedef void (*native_present_fn)(const native_span_t *spans, int count);
+
+typedef struct {
+    int width, height;           // game frame size in pixels
+    int scale;                   // 1..NATIVE_MAX_SCALE
+    bool tiled;                  // frame and atlas stored as contiguous cells
+    bool rotate;                 // frame and atlas stored turned 90 degrees clockwise, for portrait panels
+    int atlas_w, atlas_h;        // atlas size in pixels, read through the tile cache at init
+    int cell_x0, cell_y0;        // game pixel position of level cell (0, 0), for RCMD_TILE
+    native_rect_t hud[RCMD_HUD_LIVES + 1];  // rectangle of each HUD field, for RCMD_HUD
+    native_compose_fn compose;
+    native_present_fn present;
+} native_render_config_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t cells;           // cells recomposed
+    uint64_t bytes_written;   // frame pixels written (clear, atlas copies, particles)
+    uint64_t bytes_read;      // pre-scaled atlas pixels read
+    uint64_t bytes_presented; // frame pixels handed to the present callback
+} native_render_stats_t;
+
+/**
+ * @brief Render command backend that recomposes dirty cells at native scale
+ */
+extern const rcmd_backend_t native_render_backend;
+
+/**
+ * @brief Allocate the native frame and scale the atlas into it from the tile cache
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_STATE without a tile cache, or ESP_ERR_NO_MEM
+ */
+esp_err_t native_render_init(const native_render_config_t *config);
+
+/**
+ * @brief Copy a rectangle of the atlas at native scale, clipped to the cell being composed
+ *
+ * Only valid inside the compose callback. Arguments are in game pixels.
+ */
+void native_blit(int x, int y, int sx, int sy, int w, int h);
+
+/**
+ * @brief Keep drawing the last frame's sprites in the frames that follow
+ *
+ * See band_render_hold_sprites().
+ */
+void native_render_hold_sprites(bool hold);
+
+void native_render_get_stats(native_render_stats_t *out);
+
+/**
+ * @brief Log bytes touched per frame since the last report, next to a full-frame upscale, and reset
+ */
+void native_render_report(void);
+
+/**
+ * @brief Time a full-frame software upscale, then full-frame and moving-sprite composition in both layouts
+ */
+void native_render_benchmark(void);
+
+void native_render_free(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file panel_out.c
+ * @brief Band scan-out through the BSP's esp_lcd panel
+ */
+
+#include "panel_out.h"
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "panel";
+
+#ifdef CONFIG_FRUITLAND_PANEL_DIRECT
+
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "bsp/esp-bsp.h"
+#include "band_render.h"
+#include "screen_fx.h"
+
+#ifdef CONFIG_FRUITLAND_PANEL_BIG_ENDIAN
+#define PANEL_SWAPPED true
+#else
+#define PANEL_SWAPPED false
+#endif
+
+#define MAX_GAME_WIDTH 256
+
+static esp_lcd_panel_handle_t panel;
+static esp_lcd_panel_io_handle_t panel_io;
+static SemaphoreHandle_t done;
+static int panel_w, panel_h;
+static int scaled_w, scaled_h;   // game frame size on the panel
+static int offset_x, offset_y;   // top-left of the game frame on the panel
+static uint16_t *scaled;         // downscaled rows, only when the panel is smaller than the game
+static uint16_t x_map[MAX_GAME_WIDTH];
+
+static bool transfer_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *ctx) {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(done, &woken);
+    return woken == pdTRUE;
+}
+
+// Queue a rectangle and wait, so the caller's buffer can be reused right away
+static void draw(int x, int y, int w, int h, const uint16_t *pixels) {
+    if (esp_lcd_panel_draw_bitmap(panel, x, y, x + w, y + h, pixels) == ESP_OK) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+}
+
+esp_err_t panel_out_init(int game_width, int game_height, int *width, int *height) {
+    if (game_width > MAX_GAME_WIDTH) return ESP_ERR_INVALID_ARG;
+    done = xSemaphoreCreateBinary();
+    if (!done) return ESP_ERR_NO_MEM;
+
+    const bsp_display_config_t bsp_config = {
+        .max_transfer_sz = BSP_LCD_H_RES * BAND_LINES * sizeof(uint16_t),
+    };
+    esp_err_t ret = bsp_display_new(&bsp_config, &panel, &panel_io);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "BSP display init failed: %s", esp_err_to_name(ret));
+        panel_out_free();
+        return ret;
+    }
+    const esp_lcd_panel_io_callbacks_t callbacks = {
+        .on_color_trans_done = transfer_done,
+    };
+    esp_lcd_panel_io_register_event_callbacks(panel_io, &callbacks, NULL);
+    esp_lcd_panel_disp_on_off(panel, true);
+    bsp_display_backlight_on();
+    panel_w = BSP_LCD_H_RES;
+    panel_h = BSP_LCD_V_RES;
+
+    // Game frame 1:1 when it fits, otherwise the largest nearest-neighbour downscale
+    scaled_w = game_width;
+    scaled_h = game_height;
+    if (panel_w < scaled_w || panel_h < scaled_h) {
+        if (panel_w * game_height < panel_h * game_width) {
+            scaled_w = panel_w;
+            scaled_h = game_height * panel_w / game_width;
+        } else {
+            scaled_h = panel_h;
+            scaled_w = game_width * panel_h / game_height;
+        }
+        scaled = heap_caps_malloc(scaled_w * BAND_LINES * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        if (!scaled) {
+            panel_out_free();
+            return ESP_ERR_NO_MEM;
+        }
+        for (int x = 0; x < scaled_w; x++) x_map[x] = x * game_width / scaled_w;
+    }
+    offset_x = (panel_w - scaled_w) / 2;
+    offset_y = (panel_h - scaled_h) / 2;
+
+    // The border around the game frame is never drawn again
+    if (panel_out_clear() != ESP_OK) {
+        panel_out_free();
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "%dx%d panel, %s-endian, game frame %dx%d at (%d, %d)", panel_w, panel_h,
+             PANEL_SWAPPED ? "big" : "little", scaled_w, scaled_h, offset_x, offset_y);
+    *width = panel_w;
+    *height = panel_h;
+    return ESP_OK;
+}
+
+esp_err_t panel_out_clear(void) {
+    if (!panel) return ESP_ERR_INVALID_STATE;
+    uint16_t *black = heap_caps_calloc(panel_w * BAND_LINES, sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    if (!black) return ESP_ERR_NO_MEM;
+    for (int y = 0; y < panel_h; y += BAND_LINES) {
+        draw(0, y, panel_w, y + BAND_LINES > panel_h ? panel_h - y : BAND_LINES, black);
+    }
+    heap_caps_free(black);
+    return ESP_OK;
+}
+
+void panel_out_band(uint16_t *band, int width, int height, int y0, int lines) {
+    if (!panel) return;
+    screen_fx_apply_rgb565(band, width * lines, PANEL_SWAPPED);
+
+    if (!scaled) {
+        // Already in panel order: straight to DMA
+        draw(offset_x, offset_y + y0, width, lines, band);
+        return;
+    }
+
+    // Panel rows whose source row falls in this band
+    int r0 = (y0 * scaled_h + height - 1) / height;
+    int r1 = ((y0 + lines) * scaled_h + height - 1) / height;
+    if (r1 > scaled_h) r1 = scaled_h;
+    for (int r = r0; r < r1; r++) {
+        const uint16_t *src = band + (r * height / scaled_h - y0) * width;
+        uint16_t *dst = scaled + (r - r0) * scaled_w;
+        for (int x = 0; x < scaled_w; x++) dst[x] = src[x_map[x]];
+    }
+    if (r1 > r0) {
+        draw(offset_x, offset_y + r0, scaled_w, r1 - r0, scaled);
+    }
+}
+
+void panel_out_free(void) {
+    heap_caps_free(scaled);
+    scaled = NULL;
+    if (panel) esp_lcd_panel_del(panel);
+    if (panel_io) esp_lcd_panel_io_del(panel_io);
+    panel = NULL;
+    panel_io = NULL;
+    if (done) vSemaphoreDelete(done);
+    done = NULL;
+}
+
+#else
+
+esp_err_t panel_out_init(int game_width, int game_height, int *width, int *height) {
+    ESP_LOGW(TAG, "Direct panel output not enabled");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t panel_out_clear(void) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void panel_out_band(uint16_t *band, int width, int height, int y0, int lines) {
+}
+
+void panel_out_free(void) {
+}
+
+#endif
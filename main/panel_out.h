@@ -0,0 +1,65 @@
+/**
+ * @file panel_out.h
+ * @brief Direct scan-out of composed bands to the board's panel
+ *
+ * SDL's display path takes host-order RGB565 and converts it for the panel
+ * on every pushed pixel. Here the panel is driven through the BSP instead,
+ * and everything the band compositor reads (atlas cells, particle colours)
+ * is kept in the panel's byte order from the moment it is loaded. A composed
+ * band is then sent as it is, one esp_lcd_panel_draw_bitmap() per band.
+ *
+ * Bands are drawn 1:1 and centred on panels at least as large as the game;
+ * smaller panels get a nearest-neighbour downscale per band. Screen effects
+ * are applied to the band in software, only while one is active.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief An RGB565 value in the byte order of the panel
+ *
+ * Use on every pixel value as it enters the compositor's data (palettes, the
+ * atlas); black and the transparent key 0x0000 are the same in both orders.
+ */
+#ifdef CONFIG_FRUITLAND_PANEL_BIG_ENDIAN
+#define PANEL_RGB565(c) ((uint16_t) ((((c) & 0xFF) << 8) | (((c) >> 8) & 0xFF)))
+#else
+#define PANEL_RGB565(c) ((uint16_t) (c))
+#endif
+
+/**
+ * @brief Bring up the panel through the BSP, clear it and place the game frame on it
+ *
+ * @param game_width, game_height  Size of the frame the bands belong to (at most 256 wide)
+ * @param[out] width, height       Panel size in pixels
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED without CONFIG_FRUITLAND_PANEL_DIRECT, or the BSP's error
+ */
+esp_err_t panel_out_init(int game_width, int game_height, int *width, int *height);
+
+/**
+ * @brief Fill the whole panel with black
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE before panel_out_init(), or ESP_ERR_NO_MEM
+ */
+esp_err_t panel_out_clear(void);
+
+/**
+ * @brief Send rows y0..y0+lines-1 of a game-width frame to the panel and wait for the transfer
+ *
+ * The band is in panel byte order; screen effects may be applied to it in place.
+ */
+void panel_out_band(uint16_t *band, int width, int height, int y0, int lines);
+
+void panel_out_free(void);
+
+#ifdef __cplusplus
+}
+#endif
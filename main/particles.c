@@ -0,0 +1,295 @@
+/**
+ * @file particles.c
+ * @brief Fixed-capacity struct-of-arrays particle pool
+ *
+ * Positions and velocities are 12.4 fixed point in int16 arrays, so one update
+ * is a handful of adds per particle with no floats and no pointer chasing.
+ * The bounding box of the live set is accumulated during the update pass.
+ */
+
+#include "particles.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "panel_out.h"
+
+static const char *TAG = "particles";
+
+#define FRAC_BITS 4
+#define TO_FIXED(v) ((int16_t) ((v) << FRAC_BITS))
+#define GRAVITY 1    // 1/16 px per frame^2
+#define PARTICLE_SIZE 2
+#define PALETTE_SIZE 8
+
+typedef struct {
+    uint8_t count;
+    uint8_t life_min;
+    uint8_t life_range;
+    uint8_t speed;         // max initial speed in 1/16 px per frame
+    uint8_t color_base;    // first palette entry
+    uint8_t color_count;   // palette entries used
+    bool gravity;
+} burst_preset_t;
+
+static const burst_preset_t presets[PARTICLE_BURST_COUNT] = {
+    [PARTICLE_BURST_PICKUP] = {24, 12, 12, 40, 0, 3, true},
+    [PARTICLE_BURST_TELEPORT] = {40, 16, 16, 24, 3, 2, false},
+    [PARTICLE_BURST_DEATH] = {64, 20, 20, 56, 5, 3, true},
+};
+
+// RGB565 colours in panel byte order: yellow, orange, red | cyan, blue | white, red, magenta
+static const uint16_t palette565[PALETTE_SIZE] = {
+    PANEL_RGB565(0xFFE0), PANEL_RGB565(0xFD20), PANEL_RGB565(0xF800), PANEL_RGB565(0x07FF),
+    PANEL_RGB565(0x001F), PANEL_RGB565(0xFFFF), PANEL_RGB565(0xF800), PANEL_RGB565(0xF81F),
+};
+static const uint8_t palette_rgb[PALETTE_SIZE][3] = {
+    {255, 255, 0}, {255, 165, 0}, {255, 0, 0}, {0, 255, 255}, {0, 0, 255}, {255, 255, 255}, {255, 0, 0}, {255, 0, 255},
+};
+
+// Struct-of-arrays pool; [0, active) are live
+static int16_t px[PARTICLES_MAX];
+static int16_t py[PARTICLES_MAX];
+static int16_t pvx[PARTICLES_MAX];
+static int16_t pvy[PARTICLES_MAX];
+static uint8_t plife[PARTICLES_MAX];
+static uint8_t pcolor[PARTICLES_MAX];  // palette index, bit 7 = affected by gravity
+static int active = 0;
+
+static int clip_x0 = 0, clip_y0 = 0, clip_x1 = 256, clip_y1 = 224;
+static int origin_x = 0, origin_y = 0;
+static SDL_Rect bounds;
+static bool bounds_valid = false;
+
+// Scratch rectangles for batched SDL drawing, grouped by colour
+static SDL_FRect draw_rects[PARTICLES_MAX];
+
+static uint32_t rng_state = 0x12345678;
+
+static inline uint32_t next_random(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state = x;
+    return x;
+}
+
+void particles_set_clip(int x, int y, int w, int h) {
+    clip_x0 = x;
+    clip_y0 = y;
+    clip_x1 = x + w;
+    clip_y1 = y + h;
+}
+
+void particles_set_origin(int x, int y) {
+    origin_x = x;
+    origin_y = y;
+}
+
+void particles_clear(void) {
+    active = 0;
+    bounds_valid = false;
+}
+
+static inline void spawn_one(int x, int y, const burst_preset_t *preset) {
+    int i = active++;
+    // Uniform direction and speed from a square, good enough for sparks
+    int speed = preset->speed;
+    px[i] = TO_FIXED(x);
+    py[i] = TO_FIXED(y);
+    pvx[i] = (int16_t) ((int) (next_random() % (2 * speed + 1)) - speed);
+    pvy[i] = (int16_t) ((int) (next_random() % (2 * speed + 1)) - speed);
+    plife[i] = preset->life_min + (preset->life_range ? next_random() % preset->life_range : 0);
+    pcolor[i] = (preset->color_base + next_random() % preset->color_count) | (preset->gravity ? 0x80 : 0);
+}
+
+void particles_spawn_burst(int x, int y, particle_burst_t type) {
+    if (type >= PARTICLE_BURST_COUNT) return;
+    const burst_preset_t *preset = &presets[type];
+    int n = preset->count;
+    if (n > PARTICLES_MAX - active) n = PARTICLES_MAX - active;
+    for (int k = 0; k < n; k++) {
+        spawn_one(x, y, preset);
+    }
+}
+
+void particles_update(void) {
+    int min_x = clip_x1, min_y = clip_y1, max_x = clip_x0 - 1, max_y = clip_y0 - 1;
+    int fx0 = TO_FIXED(clip_x0), fy0 = TO_FIXED(clip_y0);
+    int fx1 = TO_FIXED(clip_x1 - PARTICLE_SIZE), fy1 = TO_FIXED(clip_y1 - PARTICLE_SIZE);
+
+    int i = 0;
+    while (i < active) {
+        int16_t x = px[i] + pvx[i];
+        int16_t y = py[i] + pvy[i];
+        if (pcolor[i] & 0x80) pvy[i] += GRAVITY;
+
+        if (--plife[i] == 0 || x < fx0 || x > fx1 || y < fy0 || y > fy1) {
+            // Swap-remove keeps the live range dense
+            int last = --active;
+            px[i] = px[last];
+            py[i] = py[last];
+            pvx[i] = pvx[last];
+            pvy[i] = pvy[last];
+            plife[i] = plife[last];
+            pcolor[i] = pcolor[last];
+            continue;
+        }
+
+        px[i] = x;
+        py[i] = y;
+        int sx = x >> FRAC_BITS, sy = y >> FRAC_BITS;
+        if (sx < min_x) min_x = sx;
+        if (sx > max_x) max_x = sx;
+        if (sy < min_y) min_y = sy;
+        if (sy > max_y) max_y = sy;
+        i++;
+    }
+
+    bounds_valid = active > 0;
+    if (bounds_valid) {
+        bounds.x = min_x;
+        bounds.y = min_y;
+        bounds.w = max_x - min_x + PARTICLE_SIZE;
+        bounds.h = max_y - min_y + PARTICLE_SIZE;
+    }
+}
+
+int particles_active(void) {
+    return active;
+}
+
+bool particles_get_bounds(SDL_Rect *out) {
+    if (!bounds_valid) return false;
+    *out = bounds;
+    return true;
+}
+
+void particles_draw(SDL_Renderer *renderer) {
+    if (active == 0) return;
+
+    // Counting sort by colour so each colour is one SDL_RenderFillRects call
+    int offsets[PALETTE_SIZE + 1] = {0};
+    for (int i = 0; i < active; i++) {
+        offsets[(pcolor[i] & 0x7F) + 1]++;
+    }
+    for (int c = 0; c < PALETTE_SIZE; c++) {
+        offsets[c + 1] += offsets[c];
+    }
+    int fill[PALETTE_SIZE];
+    memcpy(fill, offsets, sizeof(fill));
+    for (int i = 0; i < active; i++) {
+        SDL_FRect *r = &draw_rects[fill[pcolor[i] & 0x7F]++];
+        r->x = (float) ((px[i] >> FRAC_BITS) - origin_x);
+        r->y = (float) ((py[i] >> FRAC_BITS) - origin_y);
+        r->w = PARTICLE_SIZE;
+        r->h = PARTICLE_SIZE;
+    }
+
+    for (int c = 0; c < PALETTE_SIZE; c++) {
+        int n = offsets[c + 1] - offsets[c];
+        if (n == 0) continue;
+        SDL_SetRenderDrawColor(renderer, palette_rgb[c][0], palette_rgb[c][1], palette_rgb[c][2], 255);
+        SDL_RenderFillRects(renderer, &draw_rects[offsets[c]], n);
+    }
+}
+
+void particles_draw_rgb565(uint16_t *fb, int pitch_pixels, int width, int height) {
+    for (int i = 0; i < active; i++) {
+        int x = (px[i] >> FRAC_BITS) - origin_x;
+        int y = (py[i] >> FRAC_BITS) - origin_y;
+        uint16_t color = palette565[pcolor[i] & 0x7F];
+        if (x >= 0 && y >= 0 && x + PARTICLE_SIZE <= width && y + PARTICLE_SIZE <= height) {
+            uint16_t *row = fb + y * pitch_pixels + x;
+            row[0] = color;
+            row[1] = color;
+            row[pitch_pixels] = color;
+            row[pitch_pixels + 1] = color;
+            continue;
+        }
+        // Straddling an edge (band seams in the band compositor): clip per pixel
+        for (int dy = 0; dy < PARTICLE_SIZE; dy++) {
+            for (int dx = 0; dx < PARTICLE_SIZE; dx++) {
+                if (x + dx >= 0 && x + dx < width && y + dy >= 0 && y + dy < height) {
+                    fb[(y + dy) * pitch_pixels + x + dx] = color;
+                }
+            }
+        }
+    }
+}
+
+void particles_draw_rgb565_scaled(uint16_t *fb, int pitch_pixels, int width, int height, int scale, bool rotated) {
+    const int size = PARTICLE_SIZE * scale;
+    for (int i = 0; i < active; i++) {
+        int x0 = ((px[i] >> FRAC_BITS) - origin_x) * scale;
+        int y0 = ((py[i] >> FRAC_BITS) - origin_y) * scale;
+        int x1 = x0 + size, y1 = y0 + size;
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 > width) x1 = width;
+        if (y1 > height) y1 = height;
+        uint16_t color = palette565[pcolor[i] & 0x7F];
+        if (rotated) {
+            // Game column x is stored row x, game row y stored column height - 1 - y
+            int t = y0;
+            y0 = height - y1;
+            y1 = height - t;
+        }
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) {
+                if (rotated) {
+                    fb[x * pitch_pixels + y] = color;
+                } else {
+                    fb[y * pitch_pixels + x] = color;
+                }
+            }
+        }
+    }
+}
+
+void particles_benchmark(void) {
+    const int target = 1000;
+    const int frames = 200;
+    const int w = 256, h = 224;
+
+    uint16_t *fb = heap_caps_malloc(w * h * sizeof(uint16_t), MALLOC_CAP_8BIT);
+    if (!fb) {
+        ESP_LOGE(TAG, "Benchmark: failed to allocate framebuffer");
+        return;
+    }
+
+    particles_set_clip(0, 0, w, h);
+    particles_clear();
+
+    uint64_t spawn_us = 0, update_us = 0, draw_us = 0;
+    uint64_t active_sum = 0;
+    for (int f = 0; f < frames; f++) {
+        // Keep the pool topped up at the target population
+        uint64_t t0 = esp_timer_get_time();
+        while (active < target) {
+            spawn_one(next_random() % w, next_random() % h, &presets[PARTICLE_BURST_DEATH]);
+        }
+        uint64_t t1 = esp_timer_get_time();
+        particles_update();
+        uint64_t t2 = esp_timer_get_time();
+        particles_draw_rgb565(fb, w, w, h);
+        uint64_t t3 = esp_timer_get_time();
+
+        spawn_us += t1 - t0;
+        update_us += t2 - t1;
+        draw_us += t3 - t2;
+        active_sum += active;
+    }
+
+    ESP_LOGI(TAG, "📊 BENCH %d particles x %d frames: spawn=%llu us update=%llu us draw=%llu us per frame "
+             "(avg live %llu)",
+             target, frames, (unsigned long long) (spawn_us / frames), (unsigned long long) (update_us / frames),
+             (unsigned long long) (draw_us / frames), (unsigned long long) (active_sum / frames));
+
+    particles_clear();
+    heap_caps_free(fb);
+}
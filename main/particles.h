@@ -0,0 +1,99 @@
+/**
+ * @file particles.h
+ * @brief Pooled particle effects for ESP32-Fruitland
+ *
+ * Particles live in a fixed-capacity struct-of-arrays pool. Spawning never
+ * allocates, dead particles are swap-removed so updates walk dense arrays,
+ * and the bounding box of the live set is exposed so the renderer only has
+ * to restore and redraw that rectangle.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "SDL3/SDL.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PARTICLES_MAX 1024
+
+/**
+ * @brief Burst presets
+ */
+typedef enum {
+    PARTICLE_BURST_PICKUP = 0,  // fruit and item pickups
+    PARTICLE_BURST_TELEPORT,    // teleporter departure/arrival
+    PARTICLE_BURST_DEATH,       // player death
+    PARTICLE_BURST_COUNT
+} particle_burst_t;
+
+/**
+ * @brief Clip rectangle particles are confined to (game surface coordinates)
+ */
+void particles_set_clip(int x, int y, int w, int h);
+
+/**
+ * @brief World position drawn at the top-left of the render target (camera)
+ */
+void particles_set_origin(int x, int y);
+
+/**
+ * @brief Kill all particles
+ */
+void particles_clear(void);
+
+/**
+ * @brief Spawn a burst centred on (x, y) in game surface pixels
+ *
+ * Silently spawns fewer particles if the pool is full.
+ */
+void particles_spawn_burst(int x, int y, particle_burst_t type);
+
+/**
+ * @brief Advance all particles by one frame
+ */
+void particles_update(void);
+
+/**
+ * @brief Number of live particles
+ */
+int particles_active(void);
+
+/**
+ * @brief Bounding box of the live particles, clipped to the clip rectangle
+ *
+ * @return false if there are no live particles
+ */
+bool particles_get_bounds(SDL_Rect *out);
+
+/**
+ * @brief Draw live particles to the current render target
+ */
+void particles_draw(SDL_Renderer *renderer);
+
+/**
+ * @brief Draw live particles into an RGB565 buffer (software path)
+ */
+void particles_draw_rgb565(uint16_t *fb, int pitch_pixels, int width, int height);
+
+/**
+ * @brief Draw live particles into an RGB565 buffer at an integer scale
+ *
+ * Positions relative to the origin are multiplied by scale; width and height
+ * are the buffer's size in scaled pixels. A rotated buffer is stored turned
+ * 90 degrees clockwise (height pixels per stored row, game rows as columns
+ * from the right), as on portrait panels.
+ */
+void particles_draw_rgb565_scaled(uint16_t *fb, int pitch_pixels, int width, int height, int scale, bool rotated);
+
+/**
+ * @brief Spawn 1,000 particles and log update and draw cost per frame
+ */
+void particles_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,353 @@
+/**
+ * @file persist.c
+ * @brief NVS-backed persistence worker for ESP32-Fruitland
+ *
+ * All flash I/O happens on a dedicated low-priority task. The game thread only
+ * posts small request structs to a queue and reads from a RAM cache, so a
+ * commit (which can take several milliseconds while NVS erases a page) never
+ * lands inside a frame.
+ */
+
+#include "persist.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "persist";
+
+#ifdef CONFIG_FRUITLAND_PERSISTENCE
+
+#include "nvs_flash.h"
+#include "nvs.h"
+
+#define PERSIST_NAMESPACE "fruitland"
+#define PERSIST_KEY "save"
+#define PERSIST_VERSION 2  // 2: high-score levels past 255 for endless mode
+#define PERSIST_QUEUE_LENGTH 16
+#define PERSIST_TASK_STACK 4096
+#define PERSIST_TASK_PRIORITY 2  // Below the game and SDL tasks
+
+// Everything that survives a reset, stored as a single NVS blob
+typedef struct {
+    uint32_t version;
+    persist_hiscore_t hiscores[PERSIST_HI_ENTRIES];
+    uint8_t unlocked_level;
+    persist_settings_t settings;
+} persist_data_t;
+
+typedef enum {
+    PERSIST_REQ_SCORE = 0,
+    PERSIST_REQ_UNLOCK,
+    PERSIST_REQ_SETTINGS,
+    PERSIST_REQ_STOP
+} persist_req_type_t;
+
+typedef struct {
+    persist_req_type_t type;
+    union {
+        persist_hiscore_t score;
+        uint8_t level;
+        persist_settings_t settings;
+    };
+} persist_request_t;
+
+// Original Fruit Land high-score table
+static const persist_hiscore_t default_hiscores[PERSIST_HI_ENTRIES] = {
+    {100000, 1, "ARJAN   "}, {90000, 1, "ERWIN   "}, {80000, 1, "KARIN   "}, {70000, 1, "ADDY    "},
+    {60000, 1, "GERRY   "},  {50000, 1, "BAS     "}, {30000, 1, "TOM     "}, {100, 1, "LAURENS "},
+};
+
+static QueueHandle_t persist_queue = NULL;
+static TaskHandle_t persist_task_handle = NULL;
+static SemaphoreHandle_t persist_stopped = NULL;
+static nvs_handle_t persist_nvs = 0;
+static bool persist_initialized = false;
+
+// Worker-owned working copy; only the worker task touches it after init
+static persist_data_t working;
+
+// Snapshot readable from any task, guarded by cache_lock
+static persist_data_t cache;
+static persist_stats_t stats;
+static portMUX_TYPE cache_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void load_defaults(persist_data_t *data) {
+    memset(data, 0, sizeof(*data));
+    data->version = PERSIST_VERSION;
+    memcpy(data->hiscores, default_hiscores, sizeof(default_hiscores));
+    data->unlocked_level = 1;
+    data->settings.volume = 192;
+}
+
+static void publish_cache(void) {
+    taskENTER_CRITICAL(&cache_lock);
+    cache = working;
+    taskEXIT_CRITICAL(&cache_lock);
+}
+
+// Apply one request to the working copy; returns true if anything changed
+static bool apply_request(const persist_request_t *req) {
+    switch (req->type) {
+        case PERSIST_REQ_SCORE: {
+            int pos = PERSIST_HI_ENTRIES;
+            while (pos > 0 && working.hiscores[pos - 1].score < req->score.score) pos--;
+            if (pos >= PERSIST_HI_ENTRIES) return false;
+            memmove(&working.hiscores[pos + 1], &working.hiscores[pos],
+                    (PERSIST_HI_ENTRIES - 1 - pos) * sizeof(persist_hiscore_t));
+            working.hiscores[pos] = req->score;
+            ESP_LOGI(TAG, "New high score %ld entered at rank %d", (long) req->score.score, pos + 1);
+            return true;
+        }
+        case PERSIST_REQ_UNLOCK:
+            if (req->level <= working.unlocked_level) return false;
+            working.unlocked_level = req->level;
+            return true;
+        case PERSIST_REQ_SETTINGS:
+            if (memcmp(&working.settings, &req->settings, sizeof(persist_settings_t)) == 0) return false;
+            working.settings = req->settings;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void commit_working(void) {
+    uint64_t start = esp_timer_get_time();
+    esp_err_t ret = nvs_set_blob(persist_nvs, PERSIST_KEY, &working, sizeof(working));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(persist_nvs);
+    }
+    uint32_t elapsed = (uint32_t) (esp_timer_get_time() - start);
+
+    taskENTER_CRITICAL(&cache_lock);
+    if (ret == ESP_OK) {
+        stats.commits++;
+        stats.last_commit_us = elapsed;
+        if (elapsed > stats.max_commit_us) stats.max_commit_us = elapsed;
+    } else {
+        stats.failures++;
+    }
+    uint32_t max_commit_us = stats.max_commit_us;
+    taskEXIT_CRITICAL(&cache_lock);
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Committed %u bytes in %lu us (max %lu us)", (unsigned) sizeof(working),
+                 (unsigned long) elapsed, (unsigned long) max_commit_us);
+    } else {
+        ESP_LOGE(TAG, "Commit failed after %lu us: %s", (unsigned long) elapsed, esp_err_to_name(ret));
+    }
+}
+
+static void persist_task(void *param) {
+    persist_request_t req;
+    bool running = true;
+
+    while (running) {
+        xQueueReceive(persist_queue, &req, portMAX_DELAY);
+
+        // Absorb every request that arrives within the coalescing window so a
+        // burst (score + unlock + settings at game over) costs one commit
+        bool dirty = false;
+        do {
+            if (req.type == PERSIST_REQ_STOP) {
+                running = false;
+                break;
+            }
+            taskENTER_CRITICAL(&cache_lock);
+            stats.requests++;
+            taskEXIT_CRITICAL(&cache_lock);
+            if (apply_request(&req)) {
+                dirty = true;
+                publish_cache();
+            }
+        } while (xQueueReceive(persist_queue, &req, pdMS_TO_TICKS(CONFIG_FRUITLAND_PERSIST_COALESCE_MS)) == pdTRUE);
+
+        if (dirty) {
+            commit_working();
+        }
+    }
+
+    xSemaphoreGive(persist_stopped);
+    vTaskDelete(NULL);
+}
+
+static void post_request(const persist_request_t *req) {
+    if (!persist_initialized) return;
+    if (xQueueSend(persist_queue, req, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Request queue full, dropping request type %d", req->type);
+    }
+}
+
+// Public API implementation
+
+esp_err_t init_persist(void) {
+    if (persist_initialized) {
+        ESP_LOGW(TAG, "Persistence already initialized");
+        return ESP_OK;
+    }
+
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_LOGW(TAG, "NVS partition needs to be erased: %s", esp_err_to_name(ret));
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize NVS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = nvs_open(PERSIST_NAMESPACE, NVS_READWRITE, &persist_nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Initial load is synchronous; it happens once at boot before the game loop
+    size_t size = sizeof(working);
+    ret = nvs_get_blob(persist_nvs, PERSIST_KEY, &working, &size);
+    if (ret != ESP_OK || size != sizeof(working) || working.version != PERSIST_VERSION) {
+        ESP_LOGI(TAG, "No compatible save data (%s), using defaults", esp_err_to_name(ret));
+        load_defaults(&working);
+    }
+    publish_cache();
+
+    persist_queue = xQueueCreate(PERSIST_QUEUE_LENGTH, sizeof(persist_request_t));
+    persist_stopped = xSemaphoreCreateBinary();
+    if (!persist_queue || !persist_stopped) {
+        ESP_LOGE(TAG, "Failed to create persistence queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (xTaskCreatePinnedToCore(persist_task, "persist", PERSIST_TASK_STACK, NULL, PERSIST_TASK_PRIORITY,
+                                &persist_task_handle, tskNO_AFFINITY) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create persistence task");
+        return ESP_FAIL;
+    }
+
+    persist_initialized = true;
+    ESP_LOGI(TAG, "Persistence ready: top score %ld, unlocked level %d", (long) working.hiscores[0].score,
+             working.unlocked_level);
+    return ESP_OK;
+}
+
+bool is_persist_available(void) {
+    return persist_initialized;
+}
+
+void cleanup_persist(void) {
+    if (!persist_initialized) return;
+
+    // The worker commits anything pending before it exits
+    persist_request_t req = {.type = PERSIST_REQ_STOP};
+    xQueueSend(persist_queue, &req, portMAX_DELAY);
+    xSemaphoreTake(persist_stopped, portMAX_DELAY);
+    persist_initialized = false;
+
+    nvs_close(persist_nvs);
+    vQueueDelete(persist_queue);
+    vSemaphoreDelete(persist_stopped);
+    persist_queue = NULL;
+    persist_stopped = NULL;
+    persist_task_handle = NULL;
+    ESP_LOGI(TAG, "Persistence cleanup completed");
+}
+
+void persist_submit_score(int score, int level, const char *name) {
+    persist_request_t req = {.type = PERSIST_REQ_SCORE};
+    req.score.score = score;
+    req.score.level = (uint16_t) (level < UINT16_MAX ? level : UINT16_MAX);
+    memset(req.score.name, ' ', PERSIST_NAME_LENGTH - 1);
+    size_t len = strnlen(name, PERSIST_NAME_LENGTH - 1);
+    memcpy(req.score.name, name, len);
+    req.score.name[PERSIST_NAME_LENGTH - 1] = '\0';
+    post_request(&req);
+}
+
+void persist_unlock_level(int level) {
+    persist_request_t req = {.type = PERSIST_REQ_UNLOCK, .level = (uint8_t) level};
+    post_request(&req);
+}
+
+void persist_set_settings(const persist_settings_t *settings) {
+    persist_request_t req = {.type = PERSIST_REQ_SETTINGS, .settings = *settings};
+    post_request(&req);
+}
+
+void persist_get_hiscores(persist_hiscore_t out[PERSIST_HI_ENTRIES]) {
+    taskENTER_CRITICAL(&cache_lock);
+    memcpy(out, cache.hiscores, sizeof(cache.hiscores));
+    taskEXIT_CRITICAL(&cache_lock);
+}
+
+int persist_get_unlocked_level(void) {
+    taskENTER_CRITICAL(&cache_lock);
+    int level = cache.unlocked_level;
+    taskEXIT_CRITICAL(&cache_lock);
+    return level > 0 ? level : 1;
+}
+
+void persist_get_settings(persist_settings_t *out) {
+    taskENTER_CRITICAL(&cache_lock);
+    *out = cache.settings;
+    taskEXIT_CRITICAL(&cache_lock);
+}
+
+void persist_get_stats(persist_stats_t *out) {
+    taskENTER_CRITICAL(&cache_lock);
+    *out = stats;
+    taskEXIT_CRITICAL(&cache_lock);
+}
+
+#else  // !CONFIG_FRUITLAND_PERSISTENCE
+
+// Stub implementations for when persistence is disabled: RAM-only defaults
+esp_err_t init_persist(void) {
+    ESP_LOGW(TAG, "Persistence is disabled in configuration");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool is_persist_available(void) {
+    return false;
+}
+
+void cleanup_persist(void) {
+    // No-op when persistence is disabled
+}
+
+void persist_submit_score(int score, int level, const char *name) {
+    // No-op when persistence is disabled
+}
+
+void persist_unlock_level(int level) {
+    // No-op when persistence is disabled
+}
+
+void persist_set_settings(const persist_settings_t *settings) {
+    // No-op when persistence is disabled
+}
+
+void persist_get_hiscores(persist_hiscore_t out[PERSIST_HI_ENTRIES]) {
+    memset(out, 0, sizeof(persist_hiscore_t) * PERSIST_HI_ENTRIES);
+}
+
+int persist_get_unlocked_level(void) {
+    return 1;
+}
+
+void persist_get_settings(persist_settings_t *out) {
+    out->volume = 192;
+}
+
+void persist_get_stats(persist_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+#endif  // CONFIG_FRUITLAND_PERSISTENCE
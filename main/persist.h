@@ -0,0 +1,115 @@
+/**
+ * @file persist.h
+ * @brief Non-blocking persistence of high scores, progress and settings
+ *
+ * The game thread never touches flash. Write requests are posted to a queue
+ * and a low-priority worker task coalesces them and commits a single NVS blob.
+ * Reads are served from an in-RAM cache that the worker keeps up to date.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PERSIST_HI_ENTRIES 8
+#define PERSIST_NAME_LENGTH 9
+
+/**
+ * @brief One row of the high-score table
+ */
+typedef struct {
+    int32_t score;
+    uint16_t level;                  // level reached when the run ended, generated levels included
+    char name[PERSIST_NAME_LENGTH];  // space padded, NUL terminated
+} persist_hiscore_t;
+
+/**
+ * @brief User settings stored alongside the scores
+ */
+typedef struct {
+    uint8_t volume;  // 0-255 master volume for sound effects
+} persist_settings_t;
+
+/**
+ * @brief Commit statistics reported by the worker
+ */
+typedef struct {
+    uint32_t commits;            // successful NVS commits
+    uint32_t requests;           // write requests received
+    uint32_t failures;           // failed commits
+    uint32_t last_commit_us;     // latency of the most recent commit
+    uint32_t max_commit_us;      // worst commit latency seen
+} persist_stats_t;
+
+/**
+ * @brief Initialize NVS, load the cache and start the worker task
+ *
+ * Falls back to built-in defaults if nothing is stored yet or the stored
+ * layout is from an incompatible version.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if persistence is disabled
+ */
+esp_err_t init_persist(void);
+
+/**
+ * @brief Check if the worker is running
+ */
+bool is_persist_available(void);
+
+/**
+ * @brief Flush pending writes and stop the worker task
+ */
+void cleanup_persist(void);
+
+/**
+ * @brief Queue a finished run for insertion into the high-score table
+ *
+ * Never blocks. The table is updated by the worker, so the new entry shows
+ * up in persist_get_hiscores() shortly after the call.
+ *
+ * @param score Final score
+ * @param level Level reached
+ * @param name  Player name, truncated to PERSIST_NAME_LENGTH - 1 characters
+ */
+void persist_submit_score(int score, int level, const char *name);
+
+/**
+ * @brief Queue unlocking of a level (no-op if already unlocked)
+ */
+void persist_unlock_level(int level);
+
+/**
+ * @brief Queue replacement of the user settings
+ */
+void persist_set_settings(const persist_settings_t *settings);
+
+/**
+ * @brief Copy the cached high-score table
+ */
+void persist_get_hiscores(persist_hiscore_t out[PERSIST_HI_ENTRIES]);
+
+/**
+ * @brief Highest level the player has reached so far (at least 1)
+ */
+int persist_get_unlocked_level(void);
+
+/**
+ * @brief Copy the cached user settings
+ */
+void persist_get_settings(persist_settings_t *out);
+
+/**
+ * @brief Copy the worker's commit statistics
+ */
+void persist_get_stats(persist_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
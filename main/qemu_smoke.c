@@ -0,0 +1,146 @@
+/**
+ * @file qemu_smoke.c
+ * @brief QEMU virtual panel mirror, tick budget and framebuffer dump
+ *
+ * The game keeps rendering through the SDL BSP as on hardware; every few
+ * presented frames the game surface is read back and copied to QEMU's
+ * virtual RGB panel, so the QEMU display window shows the run. The final
+ * dump goes to the console as base64 because the UART is the only channel
+ * the host script reads.
+ */
+
+#include "qemu_smoke.h"
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "smoke";
+
+#ifdef CONFIG_FRUITLAND_QEMU_SMOKE
+
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_qemu_rgb.h"
+
+#define MIRROR_EVERY_FRAMES 8 // Read-back is slow under emulation
+
+static esp_lcd_panel_handle_t panel;
+static uint32_t ticks;
+static uint32_t frames;
+static uint64_t start_us;
+
+esp_err_t qemu_smoke_init(int width, int height) {
+    esp_lcd_rgb_qemu_config_t panel_config = {
+        .width = width,
+        .height = height,
+        .bpp = RGB_QEMU_BPP_16,
+    };
+    esp_err_t ret = esp_lcd_new_rgb_qemu(&panel_config, &panel);
+    if (ret == ESP_OK) ret = esp_lcd_panel_reset(panel);
+    if (ret == ESP_OK) ret = esp_lcd_panel_init(panel);
+    if (ret != ESP_OK) {
+        // Still useful without the panel: ticks, frames and the dump are console-only
+        ESP_LOGW(TAG, "QEMU RGB panel unavailable: %s", esp_err_to_name(ret));
+        panel = NULL;
+    }
+
+    ticks = 0;
+    frames = 0;
+    start_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "Smoke run: %d ticks, panel %dx%d", CONFIG_FRUITLAND_QEMU_SMOKE_TICKS, width, height);
+    printf("SMOKE begin ticks=%d\n", CONFIG_FRUITLAND_QEMU_SMOKE_TICKS);
+    return ESP_OK;
+}
+
+bool qemu_smoke_tick(void) {
+    return ++ticks >= CONFIG_FRUITLAND_QEMU_SMOKE_TICKS;
+}
+
+// Read the game surface back as tightly packed RGB565; caller destroys the result
+static SDL_Surface *read_surface(SDL_Renderer *renderer, SDL_Texture *surface) {
+    SDL_Texture *prev_target = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, surface);
+    SDL_Surface *pixels = SDL_RenderReadPixels(renderer, NULL);
+    SDL_SetRenderTarget(renderer, prev_target);
+    if (!pixels) return NULL;
+
+    if (pixels->format != SDL_PIXELFORMAT_RGB565 || pixels->pitch != pixels->w * 2) {
+        SDL_Surface *converted = SDL_ConvertSurface(pixels, SDL_PIXELFORMAT_RGB565);
+        SDL_DestroySurface(pixels);
+        pixels = converted;
+    }
+    return pixels;
+}
+
+void qemu_smoke_frame(SDL_Renderer *renderer, SDL_Texture *surface) {
+    if (++frames % MIRROR_EVERY_FRAMES != 0 || !panel) return;
+
+    SDL_Surface *pixels = read_surface(renderer, surface);
+    if (!pixels) return;
+    esp_lcd_panel_draw_bitmap(panel, 0, 0, pixels->w, pixels->h, pixels->pixels);
+    SDL_DestroySurface(pixels);
+}
+
+// Base64 in 76-character lines, the width most decoders accept
+static void print_base64(const uint8_t *data, size_t len) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char line[77];
+    int col = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t) data[i] << 16;
+        if (i + 1 < len) v |= data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        line[col++] = alphabet[(v >> 18) & 63];
+        line[col++] = alphabet[(v >> 12) & 63];
+        line[col++] = i + 1 < len ? alphabet[(v >> 6) & 63] : '=';
+        line[col++] = i + 2 < len ? alphabet[v & 63] : '=';
+        if (col == 76 || i + 3 >= len) {
+            line[col] = '\0';
+            puts(line);
+            col = 0;
+        }
+    }
+}
+
+void qemu_smoke_finish(SDL_Renderer *renderer, SDL_Texture *surface, int level, int score) {
+    uint64_t elapsed_ms = (esp_timer_get_time() - start_us) / 1000;
+    printf("SMOKE ticks=%lu frames=%lu level=%d score=%d elapsed_ms=%llu\n", (unsigned long) ticks,
+           (unsigned long) frames, level, score, elapsed_ms);
+
+    SDL_Surface *pixels = read_surface(renderer, surface);
+    if (pixels) {
+        printf("SMOKE-FB %d %d RGB565\n", pixels->w, pixels->h);
+        print_base64(pixels->pixels, (size_t) pixels->w * pixels->h * 2);
+        printf("SMOKE-FB-END\n");
+        SDL_DestroySurface(pixels);
+    } else {
+        ESP_LOGE(TAG, "Framebuffer read-back failed: %s", SDL_GetError());
+    }
+
+    printf("SMOKE done\n");
+    fflush(stdout);
+    for (;;) {
+        vTaskDelay(portMAX_DELAY); // The host script stops QEMU once it sees the marker
+    }
+}
+
+#else  // !CONFIG_FRUITLAND_QEMU_SMOKE
+
+esp_err_t qemu_smoke_init(int width, int height) {
+    ESP_LOGD(TAG, "QEMU smoke run disabled");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool qemu_smoke_tick(void) {
+    return false;
+}
+
+void qemu_smoke_frame(SDL_Renderer *renderer, SDL_Texture *surface) {
+}
+
+void qemu_smoke_finish(SDL_Renderer *renderer, SDL_Texture *surface, int level, int score) {
+}
+
+#endif  // CONFIG_FRUITLAND_QEMU_SMOKE
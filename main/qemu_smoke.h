@@ -0,0 +1,47 @@
+/**
+ * @file qemu_smoke.h
+ * @brief Unattended smoke run for the ESP32-S3 firmware under Espressif QEMU
+ *
+ * The autopilot plays attract-mode games while presented frames of the game
+ * surface are mirrored to QEMU's virtual RGB panel. After a fixed number of
+ * ticks the run prints a summary line, dumps the final game surface to the
+ * console (base64 RGB565) and parks. tools/qemu_smoke.py boots the image,
+ * checks the summary and decodes the dump.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "SDL3/SDL.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create the virtual RGB panel sized to the game surface
+ */
+esp_err_t qemu_smoke_init(int width, int height);
+
+/**
+ * @brief Count one simulation tick
+ *
+ * @return true when the tick budget is used up
+ */
+bool qemu_smoke_tick(void);
+
+/**
+ * @brief Count a presented frame and mirror the game surface to the panel
+ */
+void qemu_smoke_frame(SDL_Renderer *renderer, SDL_Texture *surface);
+
+/**
+ * @brief Print the summary and the final framebuffer, then park the calling task
+ */
+void qemu_smoke_finish(SDL_Renderer *renderer, SDL_Texture *surface, int level, int score);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file render_cmd.c
+ * @brief Command list storage, submission and the null backend
+ */
+
+#include "render_cmd.h"
+
+#include "esp_log.h"
+
+static const char *TAG = "rcmd";
+
+_Static_assert(sizeof(rcmd_t) <= 16, "render commands should stay compact");
+
+static rcmd_t list[RCMD_CAPACITY];
+static int count;
+static bool overflowed;
+static rcmd_stats_t stats;
+
+void rcmd_push(const rcmd_t *cmd) {
+    if (count >= RCMD_CAPACITY) {
+        if (!overflowed) {
+            stats.overflows++;
+        }
+        overflowed = true;
+        return;
+    }
+    list[count++] = *cmd;
+}
+
+void rcmd_reset(void) {
+    count = 0;
+    overflowed = false;
+}
+
+int rcmd_count(void) {
+    return count;
+}
+
+bool rcmd_overflowed(void) {
+    return overflowed;
+}
+
+void rcmd_submit(const rcmd_backend_t *backend) {
+    if (overflowed) {
+        ESP_LOGW(TAG, "Command list overflow (%d commands), frame may be incomplete", RCMD_CAPACITY);
+    }
+    backend->execute(list, count);
+
+    stats.frames++;
+    stats.commands += count;
+    if (count > stats.max_count) {
+        stats.max_count = count;
+    }
+    rcmd_reset();
+}
+
+void rcmd_get_stats(rcmd_stats_t *out) {
+    *out = stats;
+}
+
+static void null_execute(const rcmd_t *cmds, int n) {
+    // Nothing to draw; submission statistics are still counted
+    (void) cmds;
+    (void) n;
+}
+
+const rcmd_backend_t rcmd_null_backend = {
+    .name = "null",
+    .execute = null_execute,
+};
@@ -0,0 +1,165 @@
+/**
+ * @file render_cmd.h
+ * @brief Per-frame render command list between the simulation and a backend
+ *
+ * The simulation and the frame emitter append small value-only commands
+ * (a level cell changed, a sprite sits here, a HUD field has a new value);
+ * a backend executes the whole list at the end of the frame. Backends are
+ * interchangeable: SDL into the game surface, the ESP32-P4 direct
+ * framebuffer, or the null backend for headless runs.
+ *
+ * Commands carry values rather than references into game state, so a list
+ * can be copied and executed elsewhere. The exception is RCMD_LEVEL, which
+ * redraws from the live level map.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RCMD_CAPACITY 256
+
+typedef enum {
+    RCMD_LEVEL = 0,  // Clear, then draw border, every level cell and the HUD labels
+    RCMD_TILE,       // One level cell changed: x, y in cells
+    RCMD_ERASE,      // Fill a 16x16 area at x, y with the background colour
+    RCMD_RESTORE,    // Redraw the level cells under a pixel rectangle
+    RCMD_SPRITE,     // 16x16 atlas sprite at x, y
+    RCMD_PARTICLES,  // Draw the particle system; rect is its bounding box
+    RCMD_HUD,        // A HUD field changed
+} rcmd_type_t;
+
+typedef enum {
+    RCMD_SPRITE_PLAYER = 0,
+    RCMD_SPRITE_PLAYER2,
+    RCMD_SPRITE_ROCK,
+    RCMD_SPRITE_BLOCK,
+    RCMD_SPRITE_GHOST,
+} rcmd_sprite_kind_t;
+
+typedef enum {
+    RCMD_HUD_SCORE = 0,
+    RCMD_HUD_TIME,
+    RCMD_HUD_LEVEL,
+    RCMD_HUD_LIVES,
+} rcmd_hud_field_t;
+
+/**
+ * @brief One command, 16 bytes
+ */
+typedef struct {
+    uint8_t type;  // rcmd_type_t
+    int16_t x, y;  // Playfield pixels (RCMD_TILE: cell coordinates)
+    union {
+        struct {
+            uint8_t code;
+            bool hidden;  // Under fog of war
+        } tile;
+        struct {
+            int16_t w, h;
+        } rect;
+        struct {
+            int16_t sx, sy;  // Atlas source
+            uint8_t kind;    // rcmd_sprite_kind_t
+            uint8_t alpha;   // 255 = opaque
+        } sprite;
+        struct {
+            uint8_t field;  // rcmd_hud_field_t
+            int32_t value;
+        } hud;
+    };
+} rcmd_t;
+
+/**
+ * @brief A render backend: executes a frame's commands in order
+ */
+typedef struct {
+    const char *name;
+    void (*execute)(const rcmd_t *cmds, int count);
+} rcmd_backend_t;
+
+typedef struct {
+    uint32_t frames;     // lists submitted
+    uint32_t commands;   // commands executed
+    uint32_t overflows;  // lists that ran out of space
+    uint16_t max_count;  // longest list
+} rcmd_stats_t;
+
+/**
+ * @brief Backend that draws nothing, for headless and simulation-only runs
+ */
+extern const rcmd_backend_t rcmd_null_backend;
+
+/**
+ * @brief Append a command; sets the overflow flag instead when the list is full
+ */
+void rcmd_push(const rcmd_t *cmd);
+
+/**
+ * @brief Drop every queued command and clear the overflow flag
+ */
+void rcmd_reset(void);
+
+/**
+ * @brief Number of queued commands
+ */
+int rcmd_count(void);
+
+/**
+ * @brief True when a command was dropped since the last reset or submit
+ *
+ * The frame is then incomplete; the caller should reset and emit RCMD_LEVEL.
+ */
+bool rcmd_overflowed(void);
+
+/**
+ * @brief Execute the queued commands on a backend and clear the list
+ */
+void rcmd_submit(const rcmd_backend_t *backend);
+
+void rcmd_get_stats(rcmd_stats_t *out);
+
+static inline void rcmd_level(void) {
+    rcmd_t cmd = {.type = RCMD_LEVEL};
+    rcmd_push(&cmd);
+}
+
+static inline void rcmd_tile(int x, int y, int code, bool hidden) {
+    rcmd_t cmd = {.type = RCMD_TILE, .x = x, .y = y, .tile = {code, hidden}};
+    rcmd_push(&cmd);
+}
+
+static inline void rcmd_erase(int x, int y) {
+    rcmd_t cmd = {.type = RCMD_ERASE, .x = x, .y = y};
+    rcmd_push(&cmd);
+}
+
+static inline void rcmd_restore(int x, int y, int w, int h) {
+    rcmd_t cmd = {.type = RCMD_RESTORE, .x = x, .y = y, .rect = {w, h}};
+    rcmd_push(&cmd);
+}
+
+static inline void rcmd_sprite(int kind, int x, int y, int sx, int sy, int alpha) {
+    rcmd_t cmd = {.type = RCMD_SPRITE, .x = x, .y = y, .sprite = {sx, sy, kind, alpha}};
+    rcmd_push(&cmd);
+}
+
+static inline void rcmd_particles(int x, int y, int w, int h) {
+    rcmd_t cmd = {.type = RCMD_PARTICLES, .x = x, .y = y, .rect = {w, h}};
+    rcmd_push(&cmd);
+}
+
+static inline void rcmd_hud(int field, int value) {
+    rcmd_t cmd = {.type = RCMD_HUD, .hud = {field, value}};
+    rcmd_push(&cmd);
+}
+
+#ifdef __cplusplus
+}
+#endif
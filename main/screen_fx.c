@@ -0,0 +1,314 @@
+/**
+ * @file screen_fx.c
+ * @brief Flash, fade and tint state, transform LUT and scaler
+ *
+ * Effect intensities are quantized to 16 steps, so a 300 ms flash changes
+ * the transform at most 16 times and the LUT is rebuilt at most that often.
+ * Offset changes leave the LUT alone.
+ */
+
+#include "screen_fx.h"
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "screen_fx";
+
+#define STEPS 16
+#define SHAKE_STEP_US 33000
+#define MAX_DST_WIDTH 1280
+
+typedef struct {
+    uint8_t rgb[3];
+    uint64_t start_us;
+    uint32_t duration_us;
+    bool active;
+} flash_t;
+
+typedef struct {
+    bool out;
+    uint64_t start_us;
+    uint32_t duration_us;
+    bool active;
+    bool black;  // fade-out finished and holding black
+} fade_t;
+
+typedef struct {
+    uint8_t amplitude;
+    uint64_t start_us;
+    uint32_t duration_us;
+    bool active;
+} shake_t;
+
+// Shake direction per step: jumps across the centre read as an impact
+static const int8_t shake_pattern[8][2] = {{1, 0}, {-1, 1}, {0, -1}, {1, 1}, {-1, 0}, {1, -1}, {0, 1}, {-1, -1}};
+
+static flash_t flash;
+static fade_t fade;
+static shake_t shake;
+static uint8_t tint[3] = {255, 255, 255};
+static int8_t offset[2];
+static uint8_t border[3];
+
+static screen_fx_transform_t current = {{255, 255, 255}, {0, 0, 0}, {0, 0}, {0, 0, 0}};
+static bool current_identity = true;
+
+static uint16_t *lut = NULL;
+static bool lut_valid = false;
+
+static uint16_t x_map[MAX_DST_WIDTH];
+
+// Remaining fraction of an effect as 0..255, quantized to STEPS levels
+static uint8_t remaining_level(uint64_t start_us, uint32_t duration_us, uint64_t now_us) {
+    uint64_t elapsed = now_us - start_us;
+    if (elapsed >= duration_us) return 0;
+    uint32_t step = (uint32_t) ((duration_us - elapsed) * STEPS / duration_us) + 1;
+    if (step > STEPS) step = STEPS;
+    return (uint8_t) (step * 255 / STEPS);
+}
+
+void screen_fx_flash(uint8_t r, uint8_t g, uint8_t b, uint16_t duration_ms) {
+    flash.rgb[0] = r;
+    flash.rgb[1] = g;
+    flash.rgb[2] = b;
+    flash.start_us = esp_timer_get_time();
+    flash.duration_us = duration_ms * 1000;
+    flash.active = duration_ms > 0;
+}
+
+void screen_fx_fade(bool out, uint16_t duration_ms) {
+    fade.out = out;
+    fade.start_us = esp_timer_get_time();
+    fade.duration_us = duration_ms * 1000;
+    fade.active = duration_ms > 0;
+    fade.black = out && duration_ms == 0;
+}
+
+void screen_fx_set_tint(uint8_t r, uint8_t g, uint8_t b) {
+    tint[0] = r;
+    tint[1] = g;
+    tint[2] = b;
+}
+
+void screen_fx_shake(uint8_t amplitude, uint16_t duration_ms) {
+    shake.amplitude = amplitude;
+    shake.start_us = esp_timer_get_time();
+    shake.duration_us = duration_ms * 1000;
+    shake.active = amplitude > 0 && duration_ms > 0;
+}
+
+void screen_fx_set_offset(int8_t dx, int8_t dy) {
+    offset[0] = dx;
+    offset[1] = dy;
+}
+
+void screen_fx_set_border(uint8_t r, uint8_t g, uint8_t b) {
+    border[0] = r;
+    border[1] = g;
+    border[2] = b;
+}
+
+void screen_fx_reset(void) {
+    flash.active = false;
+    fade.active = false;
+    fade.black = false;
+    shake.active = false;
+    tint[0] = tint[1] = tint[2] = 255;
+    offset[0] = offset[1] = 0;
+    border[0] = border[1] = border[2] = 0;
+}
+
+bool screen_fx_update(uint64_t now_us) {
+    uint8_t level = 255;  // overall brightness from the fade
+    if (fade.active) {
+        uint8_t remaining = remaining_level(fade.start_us, fade.duration_us, now_us);
+        level = fade.out ? remaining : 255 - remaining;
+        if (remaining == 0) {
+            fade.active = false;
+            fade.black = fade.out;
+        }
+    } else if (fade.black) {
+        level = 0;
+    }
+
+    uint8_t flash_level = 0;
+    if (flash.active) {
+        flash_level = remaining_level(flash.start_us, flash.duration_us, now_us);
+        flash.active = flash_level > 0;
+    }
+
+    screen_fx_transform_t next;
+    for (int c = 0; c < 3; c++) {
+        next.mul[c] = (uint8_t) (tint[c] * level / 255);
+        next.add[c] = (uint8_t) (flash.rgb[c] * flash_level / 255);
+        next.border[c] = border[c];
+    }
+
+    next.offset[0] = offset[0];
+    next.offset[1] = offset[1];
+    if (shake.active) {
+        uint8_t remaining = remaining_level(shake.start_us, shake.duration_us, now_us);
+        shake.active = remaining > 0;
+        int magnitude = (shake.amplitude * remaining + 254) / 255;
+        const int8_t *dir = shake_pattern[(now_us - shake.start_us) / SHAKE_STEP_US % 8];
+        next.offset[0] += dir[0] * magnitude;
+        next.offset[1] += dir[1] * magnitude;
+    }
+
+    if (memcmp(&next, &current, sizeof(next)) == 0) {
+        return false;
+    }
+    if (memcmp(next.mul, current.mul, sizeof(next.mul)) || memcmp(next.add, current.add, sizeof(next.add))) {
+        lut_valid = false;
+    }
+    current = next;
+    current_identity = next.mul[0] == 255 && next.mul[1] == 255 && next.mul[2] == 255 &&
+                       next.add[0] == 0 && next.add[1] == 0 && next.add[2] == 0;
+    return true;
+}
+
+bool screen_fx_get_transform(screen_fx_transform_t *out) {
+    *out = current;
+    return !current_identity;
+}
+
+// Per-channel parts of the current transform, OR-ed together per pixel
+static void build_channel_tables(uint16_t r_tab[32], uint16_t g_tab[64], uint16_t b_tab[32]) {
+    for (int v = 0; v < 64; v++) {
+        if (v < 32) {
+            int r = v * current.mul[0] / 255 + (current.add[0] >> 3);
+            int b = v * current.mul[2] / 255 + (current.add[2] >> 3);
+            r_tab[v] = (uint16_t) ((r > 31 ? 31 : r) << 11);
+            b_tab[v] = (uint16_t) (b > 31 ? 31 : b);
+        }
+        int g = v * current.mul[1] / 255 + (current.add[1] >> 2);
+        g_tab[v] = (uint16_t) ((g > 63 ? 63 : g) << 5);
+    }
+}
+
+// Per-channel tables combined into the full 64K table: one lookup per pixel at scan-out
+static void build_lut(void) {
+    uint16_t r_tab[32], g_tab[64], b_tab[32];
+    build_channel_tables(r_tab, g_tab, b_tab);
+    for (int i = 0; i < 65536; i++) {
+        lut[i] = r_tab[i >> 11] | g_tab[(i >> 5) & 0x3F] | b_tab[i & 0x1F];
+    }
+    lut_valid = true;
+}
+
+const uint16_t *screen_fx_lut(void) {
+    if (current_identity) return NULL;
+
+    if (!lut) {
+        lut = heap_caps_malloc(65536 * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        if (!lut) {
+            lut = heap_caps_malloc(65536 * sizeof(uint16_t), MALLOC_CAP_8BIT);
+        }
+        if (!lut) {
+            ESP_LOGE(TAG, "Failed to allocate colour LUT");
+            return NULL;
+        }
+    }
+    if (!lut_valid) {
+        build_lut();
+    }
+    return lut;
+}
+
+void screen_fx_apply_rgb565(uint16_t *pixels, int count, bool swapped) {
+    if (current_identity) return;
+    uint16_t r_tab[32], g_tab[64], b_tab[32];
+    build_channel_tables(r_tab, g_tab, b_tab);
+    for (int i = 0; i < count; i++) {
+        uint16_t c = swapped ? (uint16_t) (pixels[i] << 8 | pixels[i] >> 8) : pixels[i];
+        c = r_tab[c >> 11] | g_tab[(c >> 5) & 0x3F] | b_tab[c & 0x1F];
+        pixels[i] = swapped ? (uint16_t) (c << 8 | c >> 8) : c;
+    }
+}
+
+void screen_fx_scale_rgb565(const uint16_t *src, int src_w, int src_h, int src_pitch,
+                            uint16_t *dst, int dst_w, int dst_h, int dst_pitch,
+                            const uint16_t *table) {
+    if (dst_w > MAX_DST_WIDTH) dst_w = MAX_DST_WIDTH;
+
+    // Steps rounded up so exact multiples land on their source pixel instead of one short
+    uint32_t step_x = (((uint32_t) src_w << 16) + dst_w - 1) / dst_w;
+    uint32_t step_y = (((uint32_t) src_h << 16) + dst_h - 1) / dst_h;
+    for (int x = 0, fx = 0; x < dst_w; x++, fx += step_x) {
+        x_map[x] = fx >> 16;
+    }
+
+    const uint16_t *prev_row = NULL;
+    uint16_t *prev_dst = NULL;
+    for (int y = 0, fy = 0; y < dst_h; y++, fy += step_y) {
+        const uint16_t *row = src + (fy >> 16) * src_pitch;
+        uint16_t *out = dst + y * dst_pitch;
+        if (row == prev_row) {
+            // Vertically repeated source row: copy the previous output row
+            memcpy(out, prev_dst, dst_w * sizeof(uint16_t));
+            continue;
+        }
+        if (table) {
+            for (int x = 0; x < dst_w; x++) out[x] = table[row[x_map[x]]];
+        } else {
+            for (int x = 0; x < dst_w; x++) out[x] = row[x_map[x]];
+        }
+        prev_row = row;
+        prev_dst = out;
+    }
+}
+
+void screen_fx_benchmark(void) {
+    const int src_w = 256, src_h = 224;
+    const int dst_w = 320, dst_h = 240;
+    const int iterations = 50;
+
+    uint16_t *src = heap_caps_malloc(src_w * src_h * sizeof(uint16_t), MALLOC_CAP_8BIT);
+    uint16_t *dst = heap_caps_malloc(dst_w * dst_h * sizeof(uint16_t), MALLOC_CAP_8BIT);
+    if (!src || !dst) {
+        ESP_LOGE(TAG, "Benchmark: failed to allocate buffers");
+        heap_caps_free(src);
+        heap_caps_free(dst);
+        return;
+    }
+    for (int i = 0; i < src_w * src_h; i++) {
+        src[i] = (uint16_t) (i * 2654435761u >> 16);
+    }
+
+    // Half-way through a red flash over a blue tint
+    screen_fx_reset();
+    screen_fx_set_tint(160, 200, 255);
+    screen_fx_flash(255, 0, 0, 1000);
+    screen_fx_update(esp_timer_get_time() + 500000);
+
+    uint64_t t0 = esp_timer_get_time();
+    const uint16_t *table = screen_fx_lut();
+    uint64_t t1 = esp_timer_get_time();
+    if (!table) {
+        ESP_LOGE(TAG, "Benchmark: no LUT");
+        screen_fx_reset();
+        heap_caps_free(src);
+        heap_caps_free(dst);
+        return;
+    }
+
+    for (int i = 0; i < iterations; i++) {
+        screen_fx_scale_rgb565(src, src_w, src_h, src_w, dst, dst_w, dst_h, dst_w, NULL);
+    }
+    uint64_t t2 = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        screen_fx_scale_rgb565(src, src_w, src_h, src_w, dst, dst_w, dst_h, dst_w, table);
+    }
+    uint64_t t3 = esp_timer_get_time();
+
+    ESP_LOGI(TAG, "📊 BENCH scale %dx%d -> %dx%d: plain=%llu us, LUT=%llu us per frame, LUT build=%llu us",
+             src_w, src_h, dst_w, dst_h, (unsigned long long) ((t2 - t1) / iterations),
+             (unsigned long long) ((t3 - t2) / iterations), (unsigned long long) (t1 - t0));
+
+    screen_fx_reset();
+    screen_fx_update(esp_timer_get_time());
+    heap_caps_free(src);
+    heap_caps_free(dst);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file screen_fx.h
+ * @brief Full-screen colour effects applied at scan-out
+ *
+ * Flashes, fades and tints are a per-channel colour transform applied when
+ * the game surface is scaled to the display, so they never touch the game
+ * surface itself and cost no redraw. The SDL path maps the transform to a
+ * texture colour mod plus an additive fill; raw RGB565 paths use a
+ * 65,536-entry lookup table rebuilt only when the colour part changes.
+ *
+ * Shakes and slides are an offset of the whole frame at scan-out, with the
+ * window area it uncovers filled with a border colour, so they cost no
+ * composition either.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Current transform: out = in * mul / 255 + add (per channel), shifted by offset
+ */
+typedef struct {
+    uint8_t mul[3];
+    uint8_t add[3];
+    int8_t offset[2];   // frame offset in game pixels
+    uint8_t border[3];  // colour of the window area uncovered by the offset
+} screen_fx_transform_t;
+
+/**
+ * @brief Additive flash that decays to nothing over duration_ms
+ */
+void screen_fx_flash(uint8_t r, uint8_t g, uint8_t b, uint16_t duration_ms);
+
+/**
+ * @brief Fade to black (out) or back from black (in) over duration_ms
+ */
+void screen_fx_fade(bool out, uint16_t duration_ms);
+
+/**
+ * @brief Persistent multiplicative tint (255, 255, 255 = none)
+ */
+void screen_fx_set_tint(uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * @brief Shake the frame by up to amplitude game pixels, decaying to nothing over duration_ms
+ */
+void screen_fx_shake(uint8_t amplitude, uint16_t duration_ms);
+
+/**
+ * @brief Persistent frame offset in game pixels, added to any shake (slide-ins step it per frame)
+ */
+void screen_fx_set_offset(int8_t dx, int8_t dy);
+
+/**
+ * @brief Colour of the window area uncovered by the frame offset (black by default)
+ */
+void screen_fx_set_border(uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * @brief Cancel all effects
+ */
+void screen_fx_reset(void);
+
+/**
+ * @brief Advance effects to now_us
+ *
+ * @return true if the transform changed and the screen must be presented again
+ */
+bool screen_fx_update(uint64_t now_us);
+
+/**
+ * @brief Get the current transform
+ *
+ * @return false if the colour transform is the identity (the offset may still be set)
+ */
+bool screen_fx_get_transform(screen_fx_transform_t *out);
+
+/**
+ * @brief Lookup table for the current transform
+ *
+ * @return 65,536-entry RGB565 table, or NULL for the identity transform
+ */
+const uint16_t *screen_fx_lut(void);
+
+/**
+ * @brief Apply the current transform in place from per-channel tables, without the LUT
+ *
+ * For small buffers and low-memory boards; swapped pixels are byte-swapped RGB565.
+ */
+void screen_fx_apply_rgb565(uint16_t *pixels, int count, bool swapped);
+
+/**
+ * @brief Nearest-neighbour RGB565 scaler with an optional LUT (pitches in pixels)
+ */
+void screen_fx_scale_rgb565(const uint16_t *src, int src_w, int src_h, int src_pitch,
+                            uint16_t *dst, int dst_w, int dst_h, int dst_pitch,
+                            const uint16_t *lut);
+
+/**
+ * @brief Log the cost of LUT-transformed scaling against plain scaling
+ */
+void screen_fx_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,295 @@
+/**
+ * @file scroll.c
+ * @brief Tile ring buffers and cameras for scrolling maps
+ *
+ * Each ring slot remembers which map cell and tile value it holds. An update
+ * walks the visible cells and redraws a slot only when it belongs to another
+ * cell (newly exposed by scrolling) or the map tile changed, so item pickups
+ * and rock moves are picked up without any explicit dirty marking.
+ */
+
+#include "scroll.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "scroll";
+
+#define TILE_SIZE 16
+#define SLOT_EMPTY 0xFFFF
+
+typedef struct {
+    SDL_Texture *ring;
+    int view_w, view_h;      // view in pixels
+    int ring_cols, ring_rows;
+    uint16_t *slot_cell;     // map cell index held by each slot
+    uint8_t *slot_tile;      // tile value drawn in each slot
+    int camera_x, camera_y;
+} scroll_view_t;
+
+static SDL_Renderer *ring_renderer = NULL;
+static scroll_draw_tile_fn draw_tile_cb = NULL;
+static scroll_view_t views[SCROLL_MAX_VIEWS];
+static int view_count = 0;
+
+static const char *map_data = NULL;
+static int map_width = 0, map_height = 0;
+
+static void free_view(scroll_view_t *v) {
+    if (v->ring) SDL_DestroyTexture(v->ring);
+    free(v->slot_cell);
+    free(v->slot_tile);
+    memset(v, 0, sizeof(*v));
+}
+
+static void invalidate_view(scroll_view_t *v) {
+    for (int i = 0; i < v->ring_cols * v->ring_rows; i++) {
+        v->slot_cell[i] = SLOT_EMPTY;
+    }
+}
+
+static esp_err_t alloc_view(scroll_view_t *v, int view_w, int view_h) {
+    v->view_w = view_w;
+    v->view_h = view_h;
+    v->ring_cols = (view_w + TILE_SIZE - 1) / TILE_SIZE + 1;
+    v->ring_rows = (view_h + TILE_SIZE - 1) / TILE_SIZE + 1;
+    v->ring = SDL_CreateTexture(ring_renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_TARGET,
+                                v->ring_cols * TILE_SIZE, v->ring_rows * TILE_SIZE);
+    v->slot_cell = malloc(v->ring_cols * v->ring_rows * sizeof(uint16_t));
+    v->slot_tile = malloc(v->ring_cols * v->ring_rows);
+    if (!v->ring || !v->slot_cell || !v->slot_tile) {
+        ESP_LOGE(TAG, "Failed to allocate %dx%d tile ring", v->ring_cols, v->ring_rows);
+        free_view(v);
+        return ESP_ERR_NO_MEM;
+    }
+    invalidate_view(v);
+    return ESP_OK;
+}
+
+esp_err_t scroll_init(SDL_Renderer *renderer, int view_w, int view_h, scroll_draw_tile_fn draw) {
+    ring_renderer = renderer;
+    draw_tile_cb = draw;
+    return scroll_set_views(1, view_w, view_h);
+}
+
+esp_err_t scroll_set_views(int count, int view_w, int view_h) {
+    if (count < 1 || count > SCROLL_MAX_VIEWS) return ESP_ERR_INVALID_ARG;
+
+    scroll_cleanup();
+    for (int i = 0; i < count; i++) {
+        esp_err_t ret = alloc_view(&views[i], view_w, view_h);
+        if (ret != ESP_OK) {
+            scroll_cleanup();
+            return ret;
+        }
+        view_count++;
+    }
+
+    scroll_view_t *v = &views[0];
+    ESP_LOGI(TAG, "%d view(s) of %dx%d px, tile ring %dx%d tiles (%d KB each)", count, view_w, view_h,
+             v->ring_cols, v->ring_rows, v->ring_cols * v->ring_rows * TILE_SIZE * TILE_SIZE * 2 / 1024);
+    return ESP_OK;
+}
+
+int scroll_view_count(void) {
+    return view_count;
+}
+
+void scroll_cleanup(void) {
+    for (int i = 0; i < SCROLL_MAX_VIEWS; i++) {
+        free_view(&views[i]);
+    }
+    view_count = 0;
+}
+
+void scroll_set_map(const char *map, int width, int height) {
+    map_data = map;
+    map_width = width;
+    map_height = height;
+    for (int i = 0; i < view_count; i++) {
+        views[i].camera_x = 0;
+        views[i].camera_y = 0;
+    }
+    scroll_invalidate_all();
+}
+
+bool scroll_is_active(void) {
+    return view_count > 0 && map_data &&
+           (map_width * TILE_SIZE > views[0].view_w || map_height * TILE_SIZE > views[0].view_h);
+}
+
+void scroll_follow(int view, int x, int y) {
+    scroll_view_t *v = &views[view];
+    int max_x = map_width * TILE_SIZE - v->view_w;
+    int max_y = map_height * TILE_SIZE - v->view_h;
+    v->camera_x = x - v->view_w / 2;
+    v->camera_y = y - v->view_h / 2;
+    if (v->camera_x > max_x) v->camera_x = max_x;
+    if (v->camera_y > max_y) v->camera_y = max_y;
+    if (v->camera_x < 0) v->camera_x = 0;
+    if (v->camera_y < 0) v->camera_y = 0;
+}
+
+void scroll_get_camera(int view, int *x, int *y) {
+    *x = views[view].camera_x;
+    *y = views[view].camera_y;
+}
+
+void scroll_invalidate_tile(int tile_x, int tile_y) {
+    for (int i = 0; i < view_count; i++) {
+        scroll_view_t *v = &views[i];
+        v->slot_cell[(tile_y % v->ring_rows) * v->ring_cols + tile_x % v->ring_cols] = SLOT_EMPTY;
+    }
+}
+
+void scroll_invalidate_all(void) {
+    for (int i = 0; i < view_count; i++) {
+        invalidate_view(&views[i]);
+    }
+}
+
+int scroll_update(int view) {
+    if (view >= view_count || !map_data) return 0;
+    scroll_view_t *v = &views[view];
+
+    int x0 = v->camera_x / TILE_SIZE, y0 = v->camera_y / TILE_SIZE;
+    int x1 = (v->camera_x + v->view_w - 1) / TILE_SIZE, y1 = (v->camera_y + v->view_h - 1) / TILE_SIZE;
+    if (x1 >= map_width) x1 = map_width - 1;
+    if (y1 >= map_height) y1 = map_height - 1;
+
+    SDL_Texture *prev_target = SDL_GetRenderTarget(ring_renderer);
+    bool target_set = false;
+    int drawn = 0;
+    for (int y = y0; y <= y1; y++) {
+        int slot_row = (y % v->ring_rows) * v->ring_cols;
+        for (int x = x0; x <= x1; x++) {
+            int cell = y * map_width + x;
+            int slot = slot_row + x % v->ring_cols;
+            uint8_t tile = (uint8_t) map_data[cell];
+            if (v->slot_cell[slot] == cell && v->slot_tile[slot] == tile) continue;
+
+            if (!target_set) {
+                SDL_SetRenderTarget(ring_renderer, v->ring);
+                target_set = true;
+            }
+            draw_tile_cb((int) (signed char) tile, x, y, (float) ((x % v->ring_cols) * TILE_SIZE),
+                         (float) ((y % v->ring_rows) * TILE_SIZE));
+            v->slot_cell[slot] = cell;
+            v->slot_tile[slot] = tile;
+            drawn++;
+        }
+    }
+    if (target_set) {
+        SDL_SetRenderTarget(ring_renderer, prev_target);
+    }
+    return drawn;
+}
+
+void scroll_compose(int view, SDL_Texture *target, int dst_x, int dst_y) {
+    if (view >= view_count) return;
+    scroll_view_t *v = &views[view];
+
+    int ring_w = v->ring_cols * TILE_SIZE, ring_h = v->ring_rows * TILE_SIZE;
+    int rx = v->camera_x % ring_w, ry = v->camera_y % ring_h;
+    int w1 = ring_w - rx < v->view_w ? ring_w - rx : v->view_w;
+    int h1 = ring_h - ry < v->view_h ? ring_h - ry : v->view_h;
+    int w2 = v->view_w - w1, h2 = v->view_h - h1;
+
+    SDL_SetRenderTarget(ring_renderer, target);
+
+    // Up to four pieces where the view wraps around the ring edges
+    SDL_FRect src = {(float) rx, (float) ry, (float) w1, (float) h1};
+    SDL_FRect dst = {(float) dst_x, (float) dst_y, (float) w1, (float) h1};
+    SDL_RenderTexture(ring_renderer, v->ring, &src, &dst);
+    if (w2 > 0) {
+        src = (SDL_FRect) {0, (float) ry, (float) w2, (float) h1};
+        dst = (SDL_FRect) {(float) (dst_x + w1), (float) dst_y, (float) w2, (float) h1};
+        SDL_RenderTexture(ring_renderer, v->ring, &src, &dst);
+    }
+    if (h2 > 0) {
+        src = (SDL_FRect) {(float) rx, 0, (float) w1, (float) h2};
+        dst = (SDL_FRect) {(float) dst_x, (float) (dst_y + h1), (float) w1, (float) h2};
+        SDL_RenderTexture(ring_renderer, v->ring, &src, &dst);
+    }
+    if (w2 > 0 && h2 > 0) {
+        src = (SDL_FRect) {0, 0, (float) w2, (float) h2};
+        dst = (SDL_FRect) {(float) (dst_x + w1), (float) (dst_y + h1), (float) w2, (float) h2};
+        SDL_RenderTexture(ring_renderer, v->ring, &src, &dst);
+    }
+}
+
+// Pan every view along its own diagonal for the given frames, return us per frame
+static uint64_t run_pan(SDL_Texture *target, int frames, bool full_redraw, int *tiles_per_frame) {
+    int tiles = 0;
+    scroll_invalidate_all();
+    uint64_t start = esp_timer_get_time();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < view_count; i++) {
+            scroll_view_t *v = &views[i];
+            // Views move in opposite horizontal directions, like two players apart
+            int x = i == 0 ? v->view_w / 2 + f * 3 : map_width * TILE_SIZE - v->view_w / 2 - f * 3;
+            scroll_follow(i, x, v->view_h / 2 + f * 2);
+            if (full_redraw) {
+                invalidate_view(v); // Baseline: redraw every visible tile each frame
+            }
+            tiles += scroll_update(i);
+            scroll_compose(i, target, i * v->view_w, 0);
+        }
+    }
+    uint64_t elapsed = esp_timer_get_time() - start;
+    *tiles_per_frame = tiles / frames;
+    return elapsed / frames;
+}
+
+void scroll_benchmark(SDL_Texture *target) {
+    const int size = 128;
+    const int frames = 300;
+    if (view_count == 0) {
+        ESP_LOGW(TAG, "Benchmark: no views initialized");
+        return;
+    }
+
+    char *map = malloc(size * size);
+    if (!map) {
+        ESP_LOGE(TAG, "Benchmark: failed to allocate map");
+        return;
+    }
+    static const char tiles[] = {0, 1, 1, 2, 4};
+    uint32_t seed = 0x9E3779B9;
+    for (int i = 0; i < size * size; i++) {
+        seed = seed * 1664525 + 1013904223;
+        map[i] = tiles[(seed >> 24) % sizeof(tiles)];
+    }
+
+    const char *saved_map = map_data;
+    int saved_w = map_width, saved_h = map_height;
+    int saved_count = view_count;
+    int full_w = views[0].view_w * view_count, full_h = views[0].view_h;
+
+    // One full-width view: ring vs redrawing every tile
+    int ring_tiles, full_tiles, split_tiles;
+    uint64_t ring_us = 0, full_us = 0, split_us = 0;
+    if (scroll_set_views(1, full_w, full_h) == ESP_OK) {
+        scroll_set_map(map, size, size);
+        ring_us = run_pan(target, frames, false, &ring_tiles);
+        full_us = run_pan(target, frames, true, &full_tiles);
+        ESP_LOGI(TAG, "📊 BENCH scroll %dx%d map, 1 view: ring=%llu us (%d tiles) vs full=%llu us (%d tiles) per frame",
+                 size, size, ring_us, ring_tiles, full_us, full_tiles);
+    }
+
+    // Two half-width views (split screen)
+    if (scroll_set_views(2, full_w / 2, full_h) == ESP_OK) {
+        scroll_set_map(map, size, size);
+        split_us = run_pan(target, frames, false, &split_tiles);
+        ESP_LOGI(TAG, "📊 BENCH scroll %dx%d map, 2 views: ring=%llu us (%d tiles) per frame vs 1 view %llu us",
+                 size, size, split_us, split_tiles, ring_us);
+    }
+
+    if (scroll_set_views(saved_count, full_w / saved_count, full_h) != ESP_OK) {
+        ESP_LOGE(TAG, "Benchmark: failed to restore views");
+    }
+    scroll_set_map(saved_map, saved_w, saved_h);
+    free(map);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file scroll.h
+ * @brief Cameras and wrap-around tile rings for levels larger than the screen
+ *
+ * The visible part of the map is cached in a ring texture one tile larger
+ * than the view in each direction. Map tile (x, y) always lives in ring slot
+ * (x mod cols, y mod rows), so when the camera crosses a tile boundary only
+ * the newly exposed row or column is drawn; the view is then composed from
+ * the ring with at most four blits. Render memory is fixed by the view size,
+ * not the map size.
+ *
+ * Up to SCROLL_MAX_VIEWS views (split screen) scroll independently over the
+ * same map, each with its own camera and ring.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "SDL3/SDL.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCROLL_MAX_VIEWS 2
+
+/**
+ * @brief Draw one map tile at (dst_x, dst_y) on the current render target
+ */
+typedef void (*scroll_draw_tile_fn)(int tile, int tile_x, int tile_y, float dst_x, float dst_y);
+
+/**
+ * @brief Create a single view of view_w x view_h pixels
+ */
+esp_err_t scroll_init(SDL_Renderer *renderer, int view_w, int view_h, scroll_draw_tile_fn draw);
+
+/**
+ * @brief Replace the views with count views of view_w x view_h pixels each
+ */
+esp_err_t scroll_set_views(int count, int view_w, int view_h);
+
+/**
+ * @brief Number of views currently allocated
+ */
+int scroll_view_count(void);
+
+/**
+ * @brief Release all ring textures
+ */
+void scroll_cleanup(void);
+
+/**
+ * @brief Set the map the views scroll over (map is not copied)
+ */
+void scroll_set_map(const char *map, int width, int height);
+
+/**
+ * @brief Check if the current map is larger than the views
+ */
+bool scroll_is_active(void);
+
+/**
+ * @brief Centre a view's camera on a point in map pixels, clamped to the map
+ */
+void scroll_follow(int view, int x, int y);
+
+/**
+ * @brief A view's camera position (top-left of the view) in map pixels
+ */
+void scroll_get_camera(int view, int *x, int *y);
+
+/**
+ * @brief Force a tile to be redrawn in every view on the next update (tile animation)
+ */
+void scroll_invalidate_tile(int tile_x, int tile_y);
+
+/**
+ * @brief Force all rings to be redrawn on the next update
+ */
+void scroll_invalidate_all(void);
+
+/**
+ * @brief Draw newly exposed and changed tiles into a view's ring
+ *
+ * @return number of tiles drawn
+ */
+int scroll_update(int view);
+
+/**
+ * @brief Compose a view from its ring onto target at (dst_x, dst_y)
+ */
+void scroll_compose(int view, SDL_Texture *target, int dst_x, int dst_y);
+
+/**
+ * @brief Log per-frame scroll cost over a 128x128 map: ring vs full redraw,
+ *        one full-width view vs two half-width views
+ */
+void scroll_benchmark(SDL_Texture *target);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,204 @@
+/**
+ * @file sprite_rle.c
+ * @brief Sprite run encoding, clipped run blits and the keyed-loop benchmark
+ *
+ * Encoding takes two passes over the cells: the first counts runs, so all
+ * sprites share one run pool.
+ */
+
+#include "sprite_rle.h"
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "tile_cache.h"
+
+static const char *TAG = "sprite_rle";
+
+static sprite_rle_t *sprites;
+static sprite_rle_run_t *run_pool;
+static int cells_x, first_row, rows;
+
+// Walk one cell's opaque runs; counts only when out is NULL
+static void encode_cell(const uint16_t *cell, int pitch, sprite_rle_t *out, int *run_count) {
+    for (int y = 0; y < SPRITE_RLE_SIZE; y++) {
+        const uint16_t *row = cell + y * pitch;
+        if (out) out->row_start[y] = *run_count - (int) (out->runs - run_pool);
+        int x = 0;
+        while (x < SPRITE_RLE_SIZE) {
+            if (row[x] == SPRITE_RLE_KEY) {
+                x++;
+                continue;
+            }
+            int start = x;
+            while (x < SPRITE_RLE_SIZE && row[x] != SPRITE_RLE_KEY) x++;
+            if (out) run_pool[*run_count] = (sprite_rle_run_t){start, x - start};
+            (*run_count)++;
+        }
+    }
+    if (out) out->row_start[SPRITE_RLE_SIZE] = *run_count - (int) (out->runs - run_pool);
+}
+
+// Cell i of the encoded band: from the atlas, or through the tile cache when there is none in RAM
+static const uint16_t *cell_pixels(const uint16_t *atlas, int pitch, int i, int *cell_pitch) {
+    int cx = i % cells_x, cy = first_row + i / cells_x;
+    if (atlas) {
+        *cell_pitch = pitch;
+        return atlas + (cy * pitch + cx) * SPRITE_RLE_SIZE;
+    }
+    *cell_pitch = SPRITE_RLE_SIZE;
+    return tile_cache_get(cx * SPRITE_RLE_SIZE, cy * SPRITE_RLE_SIZE);
+}
+
+esp_err_t sprite_rle_init(const uint16_t *atlas, int atlas_w, int pitch, int cell_y0, int cell_rows) {
+    sprite_rle_free();
+    cells_x = atlas_w / SPRITE_RLE_SIZE;
+    first_row = cell_y0;
+    rows = cell_rows;
+    int count = cells_x * rows;
+
+    int total_runs = 0;
+    for (int i = 0; i < count; i++) {
+        int cell_pitch;
+        const uint16_t *cell = cell_pixels(atlas, pitch, i, &cell_pitch);
+        if (!cell) {
+            ESP_LOGE(TAG, "No atlas and no tile cache to encode from");
+            return ESP_ERR_INVALID_STATE;
+        }
+        encode_cell(cell, cell_pitch, NULL, &total_runs);
+    }
+
+    // A few KB, read on every draw: internal RAM
+    sprites = heap_caps_malloc(count * sizeof(sprite_rle_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    run_pool = heap_caps_malloc((total_runs ? total_runs : 1) * sizeof(sprite_rle_run_t),
+                                MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!sprites || !run_pool) {
+        ESP_LOGE(TAG, "Failed to allocate %d runs", total_runs);
+        sprite_rle_free();
+        return ESP_ERR_NO_MEM;
+    }
+
+    int run_count = 0;
+    for (int i = 0; i < count; i++) {
+        int cell_pitch;
+        const uint16_t *cell = cell_pixels(atlas, pitch, i, &cell_pitch);
+        sprites[i].runs = &run_pool[run_count];
+        encode_cell(cell, cell_pitch, &sprites[i], &run_count);
+    }
+
+    ESP_LOGI(TAG, "Encoded %d sprites: %d runs (%d bytes)", count, total_runs,
+             (int) (count * sizeof(sprite_rle_t) + total_runs * sizeof(sprite_rle_run_t)));
+    return ESP_OK;
+}
+
+const sprite_rle_t *sprite_rle_get(int sx, int sy) {
+    if (!sprites || sx % SPRITE_RLE_SIZE || sy % SPRITE_RLE_SIZE) return NULL;
+    int cx = sx / SPRITE_RLE_SIZE, cy = sy / SPRITE_RLE_SIZE - first_row;
+    if (cx < 0 || cx >= cells_x || cy < 0 || cy >= rows) return NULL;
+    return &sprites[cy * cells_x + cx];
+}
+
+void sprite_rle_draw(uint16_t *dst, int w, int h, int stride, int x, int y, const sprite_rle_t *sprite,
+                     const uint16_t *cell) {
+    const sprite_rle_run_t *runs = sprite->runs;
+
+    if (x >= 0 && y >= 0 && x + SPRITE_RLE_SIZE <= w && y + SPRITE_RLE_SIZE <= h) {
+        // Fully inside: straight run copies
+        uint16_t *row = dst + y * stride + x;
+        for (int r = 0; r < SPRITE_RLE_SIZE; r++, row += stride, cell += SPRITE_RLE_SIZE) {
+            for (int i = sprite->row_start[r]; i < sprite->row_start[r + 1]; i++) {
+                memcpy(row + runs[i].x, cell + runs[i].x, runs[i].len * sizeof(uint16_t));
+            }
+        }
+        return;
+    }
+
+    // Crossing an edge: clip each run once
+    for (int r = 0; r < SPRITE_RLE_SIZE; r++, cell += SPRITE_RLE_SIZE) {
+        int py = y + r;
+        if (py < 0 || py >= h) continue;
+        uint16_t *row = dst + py * stride;
+        for (int i = sprite->row_start[r]; i < sprite->row_start[r + 1]; i++) {
+            int x0 = x + runs[i].x, x1 = x0 + runs[i].len;
+            int skip = x0 < 0 ? -x0 : 0;
+            if (x1 > w) x1 = w;
+            if (x0 + skip >= x1) continue;
+            memcpy(row + x0 + skip, cell + runs[i].x + skip, (x1 - x0 - skip) * sizeof(uint16_t));
+        }
+    }
+}
+
+void sprite_rle_free(void) {
+    heap_caps_free(sprites);
+    heap_caps_free(run_pool);
+    sprites = NULL;
+    run_pool = NULL;
+}
+
+// The loop RLE replaces: bounds and key test on every pixel
+static void draw_keyed(uint16_t *dst, int w, int h, int stride, int x, int y, const uint16_t *cell) {
+    for (int r = 0; r < SPRITE_RLE_SIZE; r++) {
+        for (int c = 0; c < SPRITE_RLE_SIZE; c++) {
+            int px = x + c, py = y + r;
+            if (px < 0 || px >= w || py < 0 || py >= h) continue;
+            uint16_t v = cell[r * SPRITE_RLE_SIZE + c];
+            if (v == SPRITE_RLE_KEY) continue;
+            dst[py * stride + px] = v;
+        }
+    }
+}
+
+void sprite_rle_benchmark(void) {
+    const int w = 256, h = 224;
+    const int passes = 20;
+    int count = cells_x * rows;
+    if (!sprites || count == 0 || !tile_cache_get(0, first_row * SPRITE_RLE_SIZE)) {
+        ESP_LOGW(TAG, "Benchmark: no sprites encoded or no tile cache");
+        return;
+    }
+
+    uint16_t *fb = heap_caps_malloc(w * h * sizeof(uint16_t), MALLOC_CAP_8BIT);
+    if (!fb) {
+        ESP_LOGE(TAG, "Benchmark: failed to allocate framebuffer");
+        return;
+    }
+
+    // Same positions and cells for both, one in sixteen crossing an edge
+    uint64_t keyed_us = 0, rle_us = 0;
+    bool match = true;
+    for (int p = 0; p < passes; p++) {
+        for (int i = 0; i < count; i++) {
+            int x = (i * 37 + p * 11) % (w - SPRITE_RLE_SIZE);
+            int y = (i * 23 + p * 7) % (h - SPRITE_RLE_SIZE);
+            if ((i & 15) == 0) x = w - SPRITE_RLE_SIZE / 2;
+            const uint16_t *cell = tile_cache_get((i % cells_x) * SPRITE_RLE_SIZE,
+                                                  (first_row + i / cells_x) * SPRITE_RLE_SIZE);
+
+            memset(fb, 0xff, w * h * sizeof(uint16_t));
+            uint64_t t0 = esp_timer_get_time();
+            draw_keyed(fb, w, h, w, x, y, cell);
+            uint64_t t1 = esp_timer_get_time();
+            uint16_t probe = fb[(y + 8) * w + (x + 4 < w ? x + 4 : w - 1)];
+
+            memset(fb, 0xff, w * h * sizeof(uint16_t));
+            uint64_t t2 = esp_timer_get_time();
+            sprite_rle_draw(fb, w, h, w, x, y, &sprites[i], cell);
+            uint64_t t3 = esp_timer_get_time();
+            match &= probe == fb[(y + 8) * w + (x + 4 < w ? x + 4 : w - 1)];
+
+            keyed_us += t1 - t0;
+            rle_us += t3 - t2;
+        }
+    }
+
+    int draws = passes * count;
+    ESP_LOGI(TAG, "📊 BENCH %d sprite draws: keyed loop %llu ns, RLE %llu ns per sprite (%.1fx)%s", draws,
+             (unsigned long long) (keyed_us * 1000 / draws), (unsigned long long) (rle_us * 1000 / draws),
+             rle_us ? (float) keyed_us / rle_us : 0.0f,
+             match ? "" : " OUTPUT MISMATCH");
+
+    heap_caps_free(fb);
+    tile_cache_flush();
+}
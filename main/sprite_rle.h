@@ -0,0 +1,73 @@
+/**
+ * @file sprite_rle.h
+ * @brief Run-length-encoded transparent sprites for RGB565 framebuffers
+ *
+ * 16x16 atlas cells are encoded once at load into per-row lists of opaque
+ * runs, with black (0x0000) as the transparent key. Drawing a sprite is then
+ * one memcpy per run with no per-pixel test; clipping is done per run and
+ * only for sprites that cross the buffer edge.
+ *
+ * Only the run layout is stored. Pixels are copied from the sprite's 16x16
+ * cell as handed out by the tile cache, so they come from internal RAM.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPRITE_RLE_SIZE 16
+#define SPRITE_RLE_KEY 0x0000
+
+typedef struct {
+    uint8_t x;    // first opaque column
+    uint8_t len;  // opaque pixels in the run
+} sprite_rle_run_t;
+
+typedef struct {
+    uint8_t row_start[SPRITE_RLE_SIZE + 1];  // runs of row y: row_start[y] .. row_start[y + 1] - 1
+    const sprite_rle_run_t *runs;
+} sprite_rle_t;
+
+/**
+ * @brief Encode a band of 16x16 cells from an RGB565 atlas
+ *
+ * @param atlas      Atlas pixels, or NULL to read the cells through the tile cache
+ * @param atlas_w    Atlas width in pixels
+ * @param pitch      Atlas row length in pixels
+ * @param cell_y0    First cell row to encode
+ * @param cell_rows  Number of cell rows
+ * @return ESP_OK, ESP_ERR_INVALID_STATE without atlas or cache, or ESP_ERR_NO_MEM
+ */
+esp_err_t sprite_rle_init(const uint16_t *atlas, int atlas_w, int pitch, int cell_y0, int cell_rows);
+
+/**
+ * @brief Encoded sprite for the atlas cell at pixel (sx, sy), NULL if it is not in the encoded band
+ */
+const sprite_rle_t *sprite_rle_get(int sx, int sy);
+
+/**
+ * @brief Draw an encoded sprite into an RGB565 buffer, clipped to w x h
+ *
+ * @param cell  The sprite's atlas cell as 16x16 contiguous pixels (tile_cache_get())
+ */
+void sprite_rle_draw(uint16_t *dst, int w, int h, int stride, int x, int y, const sprite_rle_t *sprite,
+                     const uint16_t *cell);
+
+void sprite_rle_free(void);
+
+/**
+ * @brief Compare RLE drawing with a per-pixel keyed loop and log the timings
+ *
+ * Needs the tile cache for the sprite cells.
+ */
+void sprite_rle_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file state_trace.c
+ * @brief Hashing and console output for the state trace
+ *
+ * The hash mixes 32-bit words with the murmur3 step, so a full 15x11 level
+ * costs about 40 mixes per tick. Words are assembled from bytes explicitly,
+ * giving the same result on any target.
+ */
+
+#include "state_trace.h"
+#include <stdio.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "trace";
+
+static inline uint32_t mix(uint32_t h, uint32_t k) {
+    k *= 0xcc9e2d51u;
+    k = (k << 15) | (k >> 17);
+    k *= 0x1b873593u;
+    h ^= k;
+    h = (h << 13) | (h >> 19);
+    return h * 5 + 0xe6546b64u;
+}
+
+uint32_t trace_hash_bytes(uint32_t h, const void *data, size_t len) {
+    const uint8_t *p = data;
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        h = mix(h, p[i] | (p[i + 1] << 8) | (p[i + 2] << 16) | ((uint32_t) p[i + 3] << 24));
+    }
+    uint32_t tail = 0;
+    for (int shift = 0; i < len; i++, shift += 8) {
+        tail |= (uint32_t) p[i] << shift;
+    }
+    return mix(h ^ (uint32_t) len, tail);
+}
+
+uint32_t trace_hash_int(uint32_t h, int32_t value) {
+    return mix(h, (uint32_t) value);
+}
+
+#ifdef CONFIG_FRUITLAND_STATE_TRACE
+
+static uint32_t tick;
+static uint32_t chain;
+
+void trace_begin(const char *label) {
+    tick = 0;
+    chain = TRACE_HASH_SEED;
+    ESP_LOGI(TAG, "Tracing state every %d ticks", CONFIG_FRUITLAND_STATE_TRACE_INTERVAL);
+    printf("TRACE begin %s interval=%d\n", label, CONFIG_FRUITLAND_STATE_TRACE_INTERVAL);
+}
+
+void trace_tick(const uint32_t parts[TRACE_PARTS]) {
+    for (int i = 0; i < TRACE_PARTS; i++) {
+        chain = mix(chain, parts[i]);
+    }
+    if (tick % CONFIG_FRUITLAND_STATE_TRACE_INTERVAL == 0) {
+        printf("TRACE %lu %08lx %08lx %08lx %08lx\n", (unsigned long) tick, (unsigned long) chain,
+               (unsigned long) parts[TRACE_PART_LEVEL], (unsigned long) parts[TRACE_PART_OBJECTS],
+               (unsigned long) parts[TRACE_PART_STATS]);
+    }
+    tick++;
+}
+
+#else  // !CONFIG_FRUITLAND_STATE_TRACE
+
+void trace_begin(const char *label) {
+    ESP_LOGD(TAG, "State trace disabled");
+}
+
+void trace_tick(const uint32_t parts[TRACE_PARTS]) {
+}
+
+#endif  // CONFIG_FRUITLAND_STATE_TRACE
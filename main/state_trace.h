@@ -0,0 +1,56 @@
+/**
+ * @file state_trace.h
+ * @brief Per-tick game state checksums for determinism checks
+ *
+ * The game hashes its simulation state once per tick as a few component
+ * hashes (level tiles, objects, counters). Every Nth tick a line
+ *
+ *     TRACE <tick> <chain> <level> <objects> <stats>
+ *
+ * is printed to the console, where chain folds in every earlier tick, so the
+ * first differing line between two runs is the first diverging tick even
+ * with N > 1. tools/trace_diff.py compares two captured logs.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACE_HASH_SEED 0x811c9dc5u
+
+typedef enum {
+    TRACE_PART_LEVEL = 0,
+    TRACE_PART_OBJECTS,
+    TRACE_PART_STATS,
+    TRACE_PARTS
+} trace_part_t;
+
+/**
+ * @brief Fold a byte buffer into a hash, a word at a time
+ */
+uint32_t trace_hash_bytes(uint32_t h, const void *data, size_t len);
+
+/**
+ * @brief Fold one integer into a hash by value (independent of layout and endianness)
+ */
+uint32_t trace_hash_int(uint32_t h, int32_t value);
+
+/**
+ * @brief Start a new trace; ticks restart at zero
+ */
+void trace_begin(const char *label);
+
+/**
+ * @brief Record one tick's component hashes, printing every Nth tick
+ */
+void trace_tick(const uint32_t parts[TRACE_PARTS]);
+
+#ifdef __cplusplus
+}
+#endif
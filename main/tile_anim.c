@@ -0,0 +1,144 @@
+/**
+ * @file tile_anim.c
+ * @brief Frame tables and per-cell change tracking for animated level tiles
+ *
+ * The atlas only holds one image per tile, so frames are built from that
+ * rectangle with a bob offset and a brightness pulse. A per-cell phase turns
+ * dot twinkles into a diagonal wave instead of the whole level blinking at
+ * once.
+ */
+
+#include "tile_anim.h"
+#include <string.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "tile_anim";
+
+#define TILE_TYPES 16
+#define MAX_ANIMATED_CELLS 1024
+
+// Atlas rectangle of tile t (row of tiles at y=16)
+#define TILE_X(t) ((t) % 16 * 16)
+#define TILE_Y(t) ((t) / 16 * 16 + 16)
+
+typedef struct {
+    const tile_anim_frame_t *frames;
+    uint8_t count;
+    uint16_t frame_ms;    // duration of one frame
+    uint8_t phase_step;   // frames of phase shift per (x + y) step
+} tile_anim_t;
+
+static const tile_anim_frame_t dot_frames[] = {
+    {TILE_X(1), TILE_Y(1), 0, 255}, {TILE_X(1), TILE_Y(1), 0, 255},
+    {TILE_X(1), TILE_Y(1), 0, 255}, {TILE_X(1), TILE_Y(1), 0, 255},
+    {TILE_X(1), TILE_Y(1), 0, 160}, {TILE_X(1), TILE_Y(1), 0, 96},
+    {TILE_X(1), TILE_Y(1), 0, 160}, {TILE_X(1), TILE_Y(1), 0, 255},
+};
+
+static const tile_anim_frame_t fruit_frames[] = {
+    {TILE_X(4), TILE_Y(4), 0, 255}, {TILE_X(4), TILE_Y(4), -1, 255},
+    {TILE_X(4), TILE_Y(4), -2, 255}, {TILE_X(4), TILE_Y(4), -1, 255},
+};
+
+static const tile_anim_frame_t teleporter_frames[] = {
+    {TILE_X(6), TILE_Y(6), 0, 255}, {TILE_X(6), TILE_Y(6), 0, 208},
+    {TILE_X(6), TILE_Y(6), 0, 160}, {TILE_X(6), TILE_Y(6), 0, 208},
+};
+
+#define BOB_FRAMES(t) \
+    static const tile_anim_frame_t item##t##_frames[] = { \
+        {TILE_X(t), TILE_Y(t), 0, 255}, {TILE_X(t), TILE_Y(t), -1, 255}, \
+        {TILE_X(t), TILE_Y(t), 0, 255}, {TILE_X(t), TILE_Y(t), 1, 255}, \
+    }
+
+BOB_FRAMES(5);   // 100 bonus
+BOB_FRAMES(7);   // time
+BOB_FRAMES(9);   // extra life
+BOB_FRAMES(10);  // freeze
+
+static const tile_anim_t animations[TILE_TYPES] = {
+    [1] = {dot_frames, 8, 120, 1},
+    [4] = {fruit_frames, 4, 150, 1},
+    [5] = {item5_frames, 4, 200, 0},
+    [6] = {teleporter_frames, 4, 100, 0},
+    [7] = {item7_frames, 4, 200, 0},
+    [9] = {item9_frames, 4, 200, 0},
+    [10] = {item10_frames, 4, 200, 0},
+};
+
+// Animated cells of the current level and the frame each was last drawn with
+static uint16_t cells[MAX_ANIMATED_CELLS];
+static uint8_t drawn_frame[MAX_ANIMATED_CELLS];
+static int cell_count = 0;
+static int level_width = 0;
+static uint32_t clock_ms = 0;
+
+static inline const tile_anim_t *animation_for(int tile) {
+    if (tile < 0 || tile >= TILE_TYPES || animations[tile].count == 0) return NULL;
+    return &animations[tile];
+}
+
+static inline int frame_index(const tile_anim_t *anim, int x, int y) {
+    return (clock_ms / anim->frame_ms + (x + y) * anim->phase_step) % anim->count;
+}
+
+void tile_anim_tick(uint64_t now_us) {
+    clock_ms = (uint32_t) (now_us / 1000);
+}
+
+tile_anim_frame_t tile_anim_frame(int tile, int x, int y) {
+    const tile_anim_t *anim = animation_for(tile);
+    if (anim) {
+        return anim->frames[frame_index(anim, x, y)];
+    }
+    tile_anim_frame_t frame = {(uint8_t) TILE_X(tile), (uint8_t) TILE_Y(tile), 0, 255};
+    return frame;
+}
+
+void tile_anim_reset(const char *level, int width, int height) {
+    level_width = width;
+    cell_count = 0;
+    for (int c = 0; c < width * height; c++) {
+        const tile_anim_t *anim = animation_for(level[c]);
+        if (!anim) continue;
+        if (cell_count == MAX_ANIMATED_CELLS) {
+            ESP_LOGW(TAG, "More than %d animated cells, rest stay static", MAX_ANIMATED_CELLS);
+            break;
+        }
+        cells[cell_count] = c;
+        drawn_frame[cell_count] = frame_index(anim, c % width, c / width);
+        cell_count++;
+    }
+    ESP_LOGD(TAG, "%d animated cells", cell_count);
+}
+
+int tile_anim_update(const char *level, tile_anim_draw_fn draw) {
+    int redrawn = 0;
+    int i = 0;
+    while (i < cell_count) {
+        int c = cells[i];
+        const tile_anim_t *anim = animation_for(level[c]);
+        if (!anim) {
+            // Item collected or cell overwritten - stop tracking it
+            cell_count--;
+            cells[i] = cells[cell_count];
+            drawn_frame[i] = drawn_frame[cell_count];
+            continue;
+        }
+
+        int x = c % level_width, y = c / level_width;
+        int f = frame_index(anim, x, y);
+        if (f != drawn_frame[i]) {
+            // Held frames repeat the same image; only a visible change costs a redraw
+            if (memcmp(&anim->frames[f], &anim->frames[drawn_frame[i]], sizeof(tile_anim_frame_t)) == 0) {
+                drawn_frame[i] = f;
+            } else if (draw(x, y, &anim->frames[f])) {
+                drawn_frame[i] = f;
+                redrawn++;
+            }
+        }
+        i++;
+    }
+    return redrawn;
+}
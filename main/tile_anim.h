@@ -0,0 +1,67 @@
+/**
+ * @file tile_anim.h
+ * @brief Animated level tiles for ESP32-Fruitland
+ *
+ * Each animated tile type has a small frame table of atlas rectangles with a
+ * vertical offset and brightness. A global animation clock selects the frame;
+ * only cells whose frame index changed since they were last drawn are handed
+ * back to the renderer, so an animated level costs a few tiles per frame.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One animation frame of a level tile
+ */
+typedef struct {
+    uint8_t atlas_x;  // source rectangle in the patterns atlas (16x16)
+    uint8_t atlas_y;
+    int8_t dy;        // vertical offset inside the cell in pixels
+    uint8_t shade;    // brightness, 255 = unmodified
+} tile_anim_frame_t;
+
+/**
+ * @brief Callback used to redraw one cell with its new frame
+ *
+ * @return false if the cell could not be drawn now; it will be offered again
+ */
+typedef bool (*tile_anim_draw_fn)(int x, int y, const tile_anim_frame_t *frame);
+
+/**
+ * @brief Advance the global animation clock
+ */
+void tile_anim_tick(uint64_t now_us);
+
+/**
+ * @brief Frame to draw for a tile type at cell (x, y) at the current clock
+ *
+ * Non-animated tiles return their static atlas rectangle.
+ */
+tile_anim_frame_t tile_anim_frame(int tile, int x, int y);
+
+/**
+ * @brief Rebuild the list of animated cells after a full level redraw
+ *
+ * All cells are assumed to have been drawn at the current clock.
+ */
+void tile_anim_reset(const char *level, int width, int height);
+
+/**
+ * @brief Redraw animated cells whose frame changed since they were last drawn
+ *
+ * Cells whose tile is no longer animated (collected items) are dropped.
+ *
+ * @return number of cells redrawn
+ */
+int tile_anim_update(const char *level, tile_anim_draw_fn draw);
+
+#ifdef __cplusplus
+}
+#endif
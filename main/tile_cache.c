@@ -0,0 +1,276 @@
+/**
+ * @file tile_cache.c
+ * @brief Atlas backing store, slot lookup and LRU replacement
+ *
+ * A per-cell table maps atlas cells to slots, so lookups are one index. Each
+ * slot carries the clock value of its last use; a miss with no free slot
+ * scans for the oldest, which only costs anything on misses.
+ */
+
+#include "tile_cache.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "panel_out.h"
+
+static const char *TAG = "tile_cache";
+
+#define NO_SLOT 0xff
+_Static_assert(TILE_CACHE_SLOTS < NO_SLOT, "slot indices must fit the cell table");
+
+static uint16_t *atlas;  // backing store, PSRAM when available
+static int atlas_pitch, cells_x, cells_y;
+
+// File-backed atlas: 8-bit BMP rows read on each miss
+static FILE *atlas_file;
+static uint16_t palette565[256];
+static long data_offset;
+static int file_stride, file_height;
+static bool bottom_up;
+
+static uint16_t (*slots)[TILE_CACHE_CELL * TILE_CACHE_CELL];  // internal RAM
+static int16_t slot_cell[TILE_CACHE_SLOTS];
+static uint32_t slot_used[TILE_CACHE_SLOTS];
+static uint8_t *cell_slot;
+static uint32_t use_clock;
+static int resident;
+
+static tile_cache_stats_t stats;
+static tile_cache_stats_t level_start;  // stats at the last flush
+
+esp_err_t tile_cache_init(const uint16_t *src, int w, int h, int pitch) {
+    tile_cache_free();
+    cells_x = w / TILE_CACHE_CELL;
+    cells_y = h / TILE_CACHE_CELL;
+    atlas_pitch = w;
+
+    atlas = heap_caps_malloc(w * h * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!atlas) {
+        atlas = heap_caps_malloc(w * h * sizeof(uint16_t), MALLOC_CAP_8BIT);
+    }
+    slots = heap_caps_malloc(TILE_CACHE_SLOTS * sizeof(*slots), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    cell_slot = heap_caps_malloc(cells_x * cells_y, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!atlas || !slots || !cell_slot) {
+        ESP_LOGE(TAG, "Failed to allocate atlas (%d bytes) or %d slots", w * h * 2, TILE_CACHE_SLOTS);
+        tile_cache_free();
+        return ESP_ERR_NO_MEM;
+    }
+    for (int y = 0; y < h; y++) {
+        memcpy(atlas + y * w, src + y * pitch, w * sizeof(uint16_t));
+    }
+
+    memset(&stats, 0, sizeof(stats));
+    level_start = stats;
+    tile_cache_flush();
+    ESP_LOGI(TAG, "%d slots (%d bytes internal) over a %dx%d atlas", TILE_CACHE_SLOTS,
+             (int) (TILE_CACHE_SLOTS * sizeof(*slots)), w, h);
+    return ESP_OK;
+}
+
+static uint32_t read_le(const uint8_t *p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+esp_err_t tile_cache_init_file(const char *path) {
+    tile_cache_free();
+    atlas_file = fopen(path, "rb");
+    if (!atlas_file) {
+        ESP_LOGE(TAG, "Failed to open %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // BITMAPFILEHEADER + BITMAPINFOHEADER
+    uint8_t hdr[54];
+    if (fread(hdr, 1, sizeof(hdr), atlas_file) != sizeof(hdr) || hdr[0] != 'B' || hdr[1] != 'M') {
+        ESP_LOGE(TAG, "%s: not a BMP file", path);
+        tile_cache_free();
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    data_offset = read_le(hdr + 10, 4);
+    uint32_t info_size = read_le(hdr + 14, 4);
+    int w = (int32_t) read_le(hdr + 18, 4);
+    int h = (int32_t) read_le(hdr + 22, 4);
+    int bpp = read_le(hdr + 28, 2);
+    uint32_t compression = read_le(hdr + 30, 4);
+    uint32_t colors = read_le(hdr + 46, 4);
+    if (bpp != 8 || compression != 0 || w % TILE_CACHE_CELL || h % TILE_CACHE_CELL) {
+        ESP_LOGE(TAG, "%s: need an uncompressed 8-bit BMP with 16-pixel cells (%dx%d, %d bpp)", path, w, h, bpp);
+        tile_cache_free();
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    bottom_up = h > 0;
+    file_height = bottom_up ? h : -h;
+    file_stride = (w + 3) & ~3;
+    if (colors == 0 || colors > 256) colors = 256;
+
+    // Palette entries are B, G, R, reserved; cells are built in the panel's byte order
+    uint8_t bgra[4];
+    memset(palette565, 0, sizeof(palette565));
+    fseek(atlas_file, 14 + info_size, SEEK_SET);
+    for (uint32_t i = 0; i < colors && fread(bgra, 1, 4, atlas_file) == 4; i++) {
+        palette565[i] = PANEL_RGB565(((bgra[2] & 0xF8) << 8) | ((bgra[1] & 0xFC) << 3) | (bgra[0] >> 3));
+    }
+
+    cells_x = w / TILE_CACHE_CELL;
+    cells_y = file_height / TILE_CACHE_CELL;
+    slots = heap_caps_malloc(TILE_CACHE_SLOTS * sizeof(*slots), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    cell_slot = heap_caps_malloc(cells_x * cells_y, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!slots || !cell_slot) {
+        ESP_LOGE(TAG, "Failed to allocate %d slots", TILE_CACHE_SLOTS);
+        tile_cache_free();
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(&stats, 0, sizeof(stats));
+    level_start = stats;
+    tile_cache_flush();
+    ESP_LOGI(TAG, "%d slots (%d bytes internal) over %s, %dx%d read in place", TILE_CACHE_SLOTS,
+             (int) (TILE_CACHE_SLOTS * sizeof(*slots)), path, w, file_height);
+    return ESP_OK;
+}
+
+// Miss from the file: one seek and read per cell row
+static void load_cell_from_file(uint16_t *dst, int cx, int cy) {
+    uint8_t idx[TILE_CACHE_CELL];
+    for (int y = 0; y < TILE_CACHE_CELL; y++, dst += TILE_CACHE_CELL) {
+        int row = cy * TILE_CACHE_CELL + y;
+        if (bottom_up) row = file_height - 1 - row;
+        fseek(atlas_file, data_offset + (long) row * file_stride + cx * TILE_CACHE_CELL, SEEK_SET);
+        if (fread(idx, 1, TILE_CACHE_CELL, atlas_file) != TILE_CACHE_CELL) {
+            memset(idx, 0, sizeof(idx));
+        }
+        for (int x = 0; x < TILE_CACHE_CELL; x++) dst[x] = palette565[idx[x]];
+    }
+}
+
+const uint16_t *tile_cache_get(int sx, int sy) {
+    if (!slots) return NULL;
+    int cx = sx / TILE_CACHE_CELL, cy = sy / TILE_CACHE_CELL;
+    if (sx < 0 || sy < 0 || cx >= cells_x || cy >= cells_y) return NULL;
+    int cell = cy * cells_x + cx;
+
+    int s = cell_slot[cell];
+    if (s != NO_SLOT) {
+        stats.hits++;
+        slot_used[s] = ++use_clock;
+        return slots[s];
+    }
+
+    stats.misses++;
+    if (resident < TILE_CACHE_SLOTS) {
+        s = resident++;
+    } else {
+        s = 0;
+        for (int i = 1; i < TILE_CACHE_SLOTS; i++) {
+            if (slot_used[i] < slot_used[s]) s = i;
+        }
+        cell_slot[slot_cell[s]] = NO_SLOT;
+        stats.evictions++;
+    }
+
+    if (atlas_file) {
+        load_cell_from_file(slots[s], cx, cy);
+    } else {
+        const uint16_t *src = atlas + cy * TILE_CACHE_CELL * atlas_pitch + cx * TILE_CACHE_CELL;
+        for (int y = 0; y < TILE_CACHE_CELL; y++) {
+            memcpy(slots[s] + y * TILE_CACHE_CELL, src + y * atlas_pitch, TILE_CACHE_CELL * sizeof(uint16_t));
+        }
+    }
+    slot_cell[s] = cell;
+    slot_used[s] = ++use_clock;
+    cell_slot[cell] = s;
+    return slots[s];
+}
+
+void tile_cache_flush(void) {
+    if (!cell_slot) return;
+    uint32_t lookups = (stats.hits - level_start.hits) + (stats.misses - level_start.misses);
+    if (lookups > 0) {
+        ESP_LOGI(TAG, "%lu lookups since flush, %lu%% hits, %d cells resident, %lu evictions", (unsigned long) lookups,
+                 (unsigned long) ((stats.hits - level_start.hits) * 100 / lookups), resident,
+                 (unsigned long) (stats.evictions - level_start.evictions));
+    }
+    memset(cell_slot, NO_SLOT, cells_x * cells_y);
+    resident = 0;
+    use_clock = 0;
+    level_start = stats;
+}
+
+void tile_cache_get_stats(tile_cache_stats_t *out) {
+    *out = stats;
+    out->resident = resident;
+}
+
+void tile_cache_free(void) {
+    if (atlas_file) {
+        fclose(atlas_file);
+        atlas_file = NULL;
+    }
+    heap_caps_free(atlas);
+    heap_caps_free(slots);
+    heap_caps_free(cell_slot);
+    atlas = NULL;
+    slots = NULL;
+    cell_slot = NULL;
+    resident = 0;
+}
+
+void tile_cache_benchmark(void) {
+    const int lookups = 20000;
+    int cells[24];  // a level's worth of tiles and sprite frames
+    const int distinct = sizeof(cells) / sizeof(cells[0]);
+    if (!slots || !atlas) {
+        ESP_LOGW(TAG, "Benchmark: no cache or no atlas in RAM to compare with");
+        return;
+    }
+
+    uint32_t seed = 12345;
+    for (int i = 0; i < distinct; i++) {
+        seed = seed * 1103515245 + 12345;
+        cells[i] = (seed >> 8) % (cells_x * cells_y);
+    }
+
+    // Read every pixel of each cell, as a blit would
+    volatile uint32_t sink = 0;
+    uint32_t sum = 0;
+    uint64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < lookups; i++) {
+        seed = seed * 1103515245 + 12345;
+        int cell = cells[(seed >> 8) % distinct];
+        const uint16_t *src = atlas + (cell / cells_x) * TILE_CACHE_CELL * atlas_pitch + (cell % cells_x) * TILE_CACHE_CELL;
+        for (int y = 0; y < TILE_CACHE_CELL; y++) {
+            for (int x = 0; x < TILE_CACHE_CELL; x++) sum += src[y * atlas_pitch + x];
+        }
+    }
+    uint64_t t1 = esp_timer_get_time();
+    sink = sum;
+
+    tile_cache_stats_t before = stats;
+    tile_cache_flush();
+    sum = 0;
+    uint64_t t2 = esp_timer_get_time();
+    for (int i = 0; i < lookups; i++) {
+        seed = seed * 1103515245 + 12345;
+        int cell = cells[(seed >> 8) % distinct];
+        const uint16_t *src = tile_cache_get((cell % cells_x) * TILE_CACHE_CELL, (cell / cells_x) * TILE_CACHE_CELL);
+        for (int p = 0; p < TILE_CACHE_CELL * TILE_CACHE_CELL; p++) sum += src[p];
+    }
+    uint64_t t3 = esp_timer_get_time();
+    sink += sum;
+    (void) sink;
+
+    uint32_t misses = stats.misses - before.misses;
+    ESP_LOGI(TAG, "📊 BENCH %d cell reads over %d cells: atlas %llu ns, cache %llu ns per cell (%lu misses)", lookups,
+             distinct, (unsigned long long) ((t1 - t0) * 1000 / lookups),
+             (unsigned long long) ((t3 - t2) * 1000 / lookups), (unsigned long) misses);
+
+    // Leave the counters and slots as the game will find them
+    stats = before;
+    tile_cache_flush();
+}
@@ -0,0 +1,86 @@
+/**
+ * @file tile_cache.h
+ * @brief LRU cache of 16x16 atlas cells in internal RAM
+ *
+ * The RGB565 patterns atlas is kept in PSRAM when available (about 128 KB,
+ * too big for internal RAM on the ESP32-S3), or left in its BMP file on
+ * boards without PSRAM, but a level touches only a handful of distinct tiles
+ * and sprite frames. CPU blits read cells through this cache instead: each cell is copied into an internal RAM slot on first
+ * use and the least recently used slot is evicted when all are taken. The
+ * cache is flushed at each level start, so it fills with that level's cells.
+ *
+ * Not thread-safe; call from the thread that renders.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TILE_CACHE_CELL 16
+
+#ifdef CONFIG_FRUITLAND_TILE_CACHE_SLOTS
+#define TILE_CACHE_SLOTS CONFIG_FRUITLAND_TILE_CACHE_SLOTS
+#else
+#define TILE_CACHE_SLOTS 64
+#endif
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint16_t resident;  // slots in use
+} tile_cache_stats_t;
+
+/**
+ * @brief Copy the atlas to its backing store and allocate the slots
+ *
+ * @param atlas  RGB565 atlas pixels, may be freed after the call
+ * @param w, h   Atlas size in pixels, multiples of 16
+ * @param pitch  Atlas row length in pixels
+ * @return ESP_OK, or ESP_ERR_NO_MEM
+ */
+esp_err_t tile_cache_init(const uint16_t *atlas, int w, int h, int pitch);
+
+/**
+ * @brief Serve cells straight from an 8-bit paletted BMP instead of an atlas copy in RAM
+ *
+ * Only the palette is kept in memory; each miss reads the cell's 16 rows
+ * from the file and converts them to RGB565, in the panel's byte order
+ * (PANEL_RGB565 in panel_out.h). For boards without PSRAM.
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND, ESP_ERR_NOT_SUPPORTED for other BMP formats, or ESP_ERR_NO_MEM
+ */
+esp_err_t tile_cache_init_file(const char *path);
+
+/**
+ * @brief Cell at atlas pixel (sx, sy) as 16x16 contiguous pixels in internal RAM
+ *
+ * sx and sy must be multiples of 16. The pointer stays valid until the next
+ * tile_cache_get() that misses, or the next flush. Returns NULL when the
+ * cache is not initialised or the cell is outside the atlas.
+ */
+const uint16_t *tile_cache_get(int sx, int sy);
+
+/**
+ * @brief Empty every slot and log the hit rate since the previous flush
+ */
+void tile_cache_flush(void);
+
+void tile_cache_get_stats(tile_cache_stats_t *out);
+
+void tile_cache_free(void);
+
+/**
+ * @brief Compare cell reads through the cache with reads from the backing atlas
+ */
+void tile_cache_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Format raw ESP32-Fruitland binary log records using the firmware ELF.
+
+Build with CONFIG_FRUITLAND_BINLOG_RAW, capture the console
+(e.g. `idf.py monitor | tee run.log`) and decode:
+
+    tools/binlog_decode.py build/esp32-fruitland.elf run.log
+
+Each `BLOG <site> <ms> <args...>` line is replaced by the formatted
+`I (<ms>) <tag>: <message>` line; every other line passes through unchanged.
+Call-site descriptors, tags, format strings and %s arguments are read from
+the ELF's loadable sections, so the decoder always matches the binary that
+produced the log. Reads stdin when no log file is given.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+BLOG_RE = re.compile(r"BLOG ([0-9a-f]{8}) (\d+)((?: [0-9a-f]+)*)\s*$")
+SPEC_RE = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diuxXoc s%])")
+LEVELS = "NEWIDV"
+SHT_NOBITS = 8
+
+
+class Elf32:
+    """Just enough of a little-endian ELF32 reader to fetch bytes by address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError(f"{path}: not a little-endian ELF32 file")
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2e)
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, _, addr, offset, size = struct.unpack_from("<IIIIII", self.data, shoff + i * shentsize)
+            if addr and size and sh_type != SHT_NOBITS:
+                self.sections.append((addr, offset, size))
+
+    def read(self, addr, length):
+        for base, offset, size in self.sections:
+            if base <= addr and addr + length <= base + size:
+                start = offset + addr - base
+                return self.data[start:start + length]
+        raise KeyError(f"address 0x{addr:08x} is not in a loadable section")
+
+    def string(self, addr, limit=256):
+        for base, offset, size in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.find(b"\0", start, min(offset + size, start + limit))
+                return self.data[start:end if end >= 0 else start + limit].decode("utf-8", "replace")
+        raise KeyError(f"address 0x{addr:08x} is not in a loadable section")
+
+
+def c_format(elf, fmt, words):
+    """Apply a printf format to 32-bit argument words, printf-style."""
+    args = iter(words)
+
+    def convert(m):
+        flags, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        word = next(args, 0)
+        if conv == "s":
+            try:
+                return ("%" + flags + "s") % elf.string(word)
+            except KeyError:
+                return f"<str 0x{word:08x}>"
+        if conv == "c":
+            return ("%" + flags + "c") % chr(word & 0xff)
+        if conv in "di":
+            word = word - (1 << 32) if word & 0x80000000 else word
+            conv = "d"
+        return ("%" + flags + conv) % word
+
+    return SPEC_RE.sub(convert, fmt)
+
+
+def decode_line(elf, sites, m):
+    site = int(m.group(1), 16)
+    if site not in sites:
+        # binlog_site_t: const char *tag, const char *fmt, uint8_t level, uint8_t nargs
+        tag_addr, fmt_addr, level, nargs = struct.unpack("<IIBB", elf.read(site, 10))
+        sites[site] = (elf.string(tag_addr), elf.string(fmt_addr), level, nargs)
+    tag, fmt, level, _ = sites[site]
+    words = [int(w, 16) for w in m.group(3).split()]
+    letter = LEVELS[level] if level < len(LEVELS) else "?"
+    return f"{letter} ({m.group(2)}) {tag}: {c_format(elf, fmt, words)}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF that produced the log")
+    parser.add_argument("log", nargs="?", help="captured console log (default: stdin)")
+    args = parser.parse_args()
+
+    try:
+        elf = Elf32(args.elf)
+        log = open(args.log, errors="replace") if args.log else sys.stdin
+    except (OSError, ValueError) as e:
+        print(e, file=sys.stderr)
+        return 2
+
+    sites = {}
+    unresolved = 0
+    with log:
+        for line in log:
+            m = BLOG_RE.search(line)
+            if not m:
+                sys.stdout.write(line)
+                continue
+            try:
+                print(decode_line(elf, sites, m))
+            except (KeyError, struct.error):
+                unresolved += 1
+                sys.stdout.write(line)
+    if unresolved:
+        print(f"{unresolved} record(s) did not match this ELF", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Boot the ESP32-Fruitland smoke build under Espressif QEMU and check the run.
+
+Build with sdkconfig.defaults.esp32s3_qemu (CONFIG_FRUITLAND_QEMU_SMOKE), then
+from the project directory:
+
+    tools/qemu_smoke.py --ppm final.ppm
+
+The flash image is merged from build/flash_args and booted with
+qemu-system-xtensa. The run passes when the firmware prints its SMOKE summary
+and `SMOKE done` without a panic before the timeout. The final game surface
+dumped by the firmware can be saved as a PPM image. Exit status is 0 on
+success, 1 when the run failed and 2 when QEMU could not be started.
+"""
+
+import argparse
+import base64
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+SUMMARY_RE = re.compile(r"SMOKE ticks=(\d+) frames=(\d+) level=(\d+) score=(-?\d+) elapsed_ms=(\d+)")
+FB_RE = re.compile(r"SMOKE-FB (\d+) (\d+) RGB565")
+PANIC_MARKERS = ("Guru Meditation", "abort() was called", "Backtrace:", "Stack smashing", "assert failed")
+
+
+def merge_flash(build_dir, image, flash_size):
+    """Merge the bootloader, partition table, app and assets into one flash image."""
+    subprocess.run(
+        [sys.executable, "-m", "esptool", "--chip", "esp32s3", "merge_bin", "-o", os.path.abspath(image),
+         "--fill-flash-size", flash_size, "@flash_args"],
+        cwd=build_dir, check=True, stdout=subprocess.DEVNULL)
+
+
+def check_line(line):
+    """Return "done", a panic description or None for one console line."""
+    if line.startswith("SMOKE done"):
+        return "done"
+    if any(marker in line for marker in PANIC_MARKERS):
+        return "firmware panicked: " + line.strip()
+    return None
+
+
+def run_qemu(args, image):
+    """Run QEMU until `SMOKE done`, a panic or the timeout; return (console lines, failure or None)."""
+    cmd = [args.qemu, "-nographic", "-machine", "esp32s3", "-m", args.psram,
+           "-drive", f"file={image},if=mtd,format=raw", "-serial", "mon:stdio"]
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, errors="replace")
+    os.set_blocking(proc.stdout.fileno(), False)
+    lines = []
+    pending = ""
+    status = None
+    deadline = time.monotonic() + args.timeout
+    try:
+        while status is None:
+            if time.monotonic() >= deadline:
+                status = "timed out after %d s" % args.timeout
+                break
+            chunk = proc.stdout.read()
+            if not chunk:
+                if proc.poll() is not None:
+                    status = "QEMU exited with status %d" % proc.returncode
+                time.sleep(0.05)
+                continue
+            pending += chunk
+            *complete, pending = pending.split("\n")
+            for line in complete:
+                line = line.rstrip("\r")
+                lines.append(line)
+                if args.verbose and not line.startswith(("SMOKE-FB", "TRACE")):
+                    print(line)
+                status = check_line(line)
+                if status:
+                    break
+    finally:
+        proc.kill()
+        proc.wait()
+    return lines, None if status == "done" else status
+
+
+def parse_framebuffer(lines):
+    """Return (width, height, RGB565 bytes) from the SMOKE-FB block, or None."""
+    for i, line in enumerate(lines):
+        m = FB_RE.match(line)
+        if not m:
+            continue
+        width, height = int(m.group(1)), int(m.group(2))
+        body = []
+        for data in lines[i + 1:]:
+            if data.startswith("SMOKE-FB-END"):
+                pixels = base64.b64decode("".join(body))
+                return (width, height, pixels) if len(pixels) == width * height * 2 else None
+            body.append(data.strip())
+    return None
+
+
+def write_ppm(path, width, height, pixels):
+    rgb = bytearray()
+    for i in range(0, len(pixels), 2):
+        v = pixels[i] | (pixels[i + 1] << 8)
+        r, g, b = (v >> 11) & 0x1f, (v >> 5) & 0x3f, v & 0x1f
+        rgb += bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+    with open(path, "wb") as f:
+        f.write(b"P6\n%d %d\n255\n" % (width, height))
+        f.write(rgb)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--build-dir", default="build", help="ESP-IDF build directory (default: build)")
+    parser.add_argument("--image", default="build/qemu_flash.bin", help="merged flash image to create and boot")
+    parser.add_argument("--flash-size", default="16MB", help="flash size the image is padded to")
+    parser.add_argument("--psram", default="8M", help="emulated PSRAM size passed to QEMU -m")
+    parser.add_argument("--qemu", default="qemu-system-xtensa", help="QEMU binary with ESP32-S3 support")
+    parser.add_argument("--timeout", type=int, default=600, help="seconds before the run counts as hung")
+    parser.add_argument("--ppm", help="write the final game surface to this PPM file")
+    parser.add_argument("--log", help="save the full console output to this file")
+    parser.add_argument("--verbose", action="store_true", help="echo the console while running")
+    args = parser.parse_args()
+
+    if not shutil.which(args.qemu):
+        print(f"{args.qemu} not found; install Espressif QEMU (idf_tools.py install qemu-xtensa)", file=sys.stderr)
+        return 2
+    try:
+        merge_flash(args.build_dir, args.image, args.flash_size)
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f"Could not merge the flash image: {e}", file=sys.stderr)
+        return 2
+
+    lines, failure = run_qemu(args, args.image)
+    if args.log:
+        with open(args.log, "w") as f:
+            f.write("\n".join(lines) + "\n")
+
+    summary = next((m for m in map(SUMMARY_RE.search, lines) if m), None)
+    if summary:
+        ticks, frames, level, score, elapsed_ms = (int(x) for x in summary.groups())
+        print(f"ticks={ticks} frames={frames} level={level} score={score} "
+              f"emulated {elapsed_ms / 1000:.1f} s ({frames * 1000 / max(elapsed_ms, 1):.1f} fps)")
+    if failure:
+        for line in lines[-20:]:
+            print("  " + line)
+        print(f"Smoke run FAILED: {failure}")
+        return 1
+    if not summary:
+        print("Smoke run FAILED: no SMOKE summary line")
+        return 1
+    if frames == 0:
+        print("Smoke run FAILED: no frames were presented")
+        return 1
+
+    fb = parse_framebuffer(lines)
+    if fb is None:
+        print("Smoke run FAILED: framebuffer dump missing or truncated")
+        return 1
+    if args.ppm:
+        write_ppm(args.ppm, *fb)
+        print(f"Final framebuffer ({fb[0]}x{fb[1]}) written to {args.ppm}")
+
+    print("Smoke run passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Find the first diverging tick between two ESP32-Fruitland state traces.
+
+Build with CONFIG_FRUITLAND_STATE_TRACE, capture the console of each run
+(e.g. `idf.py monitor | tee run_a.log`) and compare:
+
+    tools/trace_diff.py run_a.log run_b.log
+
+Each capture may hold several games (one `TRACE begin` per game); --run picks
+which one to compare. Exit status is 0 when the traces agree on every common
+tick, 1 when they diverge and 2 when a trace could not be read.
+"""
+
+import argparse
+import re
+import sys
+
+BEGIN_RE = re.compile(r"TRACE begin (\S+) interval=(\d+)")
+TICK_RE = re.compile(r"TRACE (\d+) ([0-9a-f]{8}) ([0-9a-f]{8}) ([0-9a-f]{8}) ([0-9a-f]{8})")
+PARTS = ("level", "objects", "stats")
+
+
+def load_run(path, run):
+    """Return (label, {tick: (chain, level, objects, stats)}) for one game in a log."""
+    runs = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = BEGIN_RE.search(line)
+            if m:
+                runs.append((m.group(1), {}))
+                continue
+            m = TICK_RE.search(line)
+            if m:
+                if not runs:
+                    runs.append(("(no header)", {}))
+                runs[-1][1][int(m.group(1))] = m.groups()[1:]
+    if run >= len(runs):
+        raise ValueError(f"{path}: has {len(runs)} traced game(s), no run {run}")
+    return runs[run]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace_a")
+    parser.add_argument("trace_b")
+    parser.add_argument("--run", type=int, default=0, help="which traced game in each log to compare (default 0)")
+    parser.add_argument("--context", type=int, default=3, help="matching lines to show before the divergence")
+    args = parser.parse_args()
+
+    try:
+        label_a, ticks_a = load_run(args.trace_a, args.run)
+        label_b, ticks_b = load_run(args.trace_b, args.run)
+    except (OSError, ValueError) as e:
+        print(e, file=sys.stderr)
+        return 2
+
+    common = sorted(set(ticks_a) & set(ticks_b))
+    if not common:
+        print("No common ticks to compare", file=sys.stderr)
+        return 2
+
+    for i, tick in enumerate(common):
+        a, b = ticks_a[tick], ticks_b[tick]
+        if a == b:
+            continue
+
+        print(f"Diverged at tick {tick} (run {args.run}: {label_a} vs {label_b})")
+        for prev in common[max(0, i - args.context):i]:
+            print(f"  {prev:8d}  {' '.join(ticks_a[prev])}")
+        print(f"A {tick:8d}  {' '.join(a)}")
+        print(f"B {tick:8d}  {' '.join(b)}")
+
+        differing = [name for name, x, y in zip(PARTS, a[1:], b[1:]) if x != y]
+        if differing:
+            print(f"Differs in: {', '.join(differing)}")
+        else:
+            # Components agree on this printed tick; an unprinted tick in between diverged
+            prev = common[i - 1] if i else None
+            print(f"Only the chain differs: divergence between tick {prev} and {tick}")
+        return 1
+
+    print(f"Identical over {len(common)} common ticks ({common[0]}..{common[-1]})")
+    if len(ticks_a) != len(ticks_b):
+        print(f"Note: trace lengths differ ({len(ticks_a)} vs {len(ticks_b)} ticks)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())